@@ -0,0 +1,204 @@
+/**
+ * \file cave-frontier.c
+ * \brief The edge of the player's knowledge of a level
+ *
+ * The frontier is the set of grids the player remembers which have at least
+ * one neighbour the player doesn't; it is where exploring has to go next.
+ * Finding it used to mean looking at every grid of the player's map (and
+ * all of their neighbours) on every step of an explore command.
+ *
+ * The frontier hangs off the player's copy of the chunk.  It is built from
+ * the player's map the first time it is needed, and from then on kept up to
+ * date by square_memorize() and square_forget(), which between them make
+ * every change to what the player remembers of a single grid.  Anything
+ * which rewrites the player's map wholesale just throws the frontier away,
+ * to be rebuilt when it's next wanted.
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "cave.h"
+#include "cave-frontier.h"
+
+struct frontier {
+	struct loc *grids;		/* The grids on the frontier, in no order */
+	int num, max;
+	int *pos;				/* Place of each grid in grids, or -1 */
+};
+
+/**
+ * ------------------------------------------------------------------------
+ * Internal helpers
+ * ------------------------------------------------------------------------ */
+static int frontier_index(const struct chunk *known, struct loc grid)
+{
+	return grid.y * known->width + grid.x;
+}
+
+static bool grid_is_remembered(struct chunk *known, struct loc grid)
+{
+	return square(known, grid)->feat != FEAT_NONE;
+}
+
+/**
+ * Whether a grid belongs on the frontier; neighbours off the edge of the
+ * chunk count as unknown, just as they do for count_neighbors()
+ */
+static bool grid_is_frontier(struct chunk *known, struct loc grid)
+{
+	int d, count = 0;
+
+	if (!grid_is_remembered(known, grid)) return false;
+	for (d = 0; d < 8; d++) {
+		struct loc adj = loc_sum(grid, ddgrid_ddd[d]);
+		if (square_in_bounds(known, adj)
+				&& grid_is_remembered(known, adj)) {
+			count++;
+		}
+	}
+	return count < 8;
+}
+
+static void frontier_add(struct frontier *front, int idx, struct loc grid)
+{
+	if (front->num == front->max) {
+		front->max *= 2;
+		front->grids = mem_realloc(front->grids,
+			front->max * sizeof(struct loc));
+	}
+	front->pos[idx] = front->num;
+	front->grids[front->num++] = grid;
+}
+
+static void frontier_remove(struct frontier *front, struct chunk *known,
+		int idx)
+{
+	int place = front->pos[idx];
+	struct loc last = front->grids[--front->num];
+
+	front->grids[place] = last;
+	front->pos[frontier_index(known, last)] = place;
+	front->pos[idx] = -1;
+}
+
+/**
+ * Put a grid on or take it off the frontier, as it now deserves
+ */
+static void frontier_check(struct frontier *front, struct chunk *known,
+		struct loc grid)
+{
+	int idx = frontier_index(known, grid);
+	bool on = grid_is_frontier(known, grid);
+
+	if (on && front->pos[idx] < 0) {
+		frontier_add(front, idx, grid);
+	} else if (!on && front->pos[idx] >= 0) {
+		frontier_remove(front, known, idx);
+	}
+}
+
+/**
+ * Build the frontier for the player's map of a chunk
+ */
+static struct frontier *frontier_build(struct chunk *known)
+{
+	struct frontier *front = mem_zalloc(sizeof(*front));
+	struct loc grid;
+
+	front->max = 2 * (known->height + known->width);
+	front->grids = mem_alloc(front->max * sizeof(struct loc));
+	front->pos = mem_alloc(known->height * known->width * sizeof(int));
+	for (grid.y = 0; grid.y < known->height; grid.y++) {
+		for (grid.x = 0; grid.x < known->width; grid.x++) {
+			int idx = frontier_index(known, grid);
+
+			front->pos[idx] = -1;
+			if (grid_is_frontier(known, grid)) {
+				frontier_add(front, idx, grid);
+			}
+		}
+	}
+	return front;
+}
+
+static struct frontier *frontier_get(struct chunk *known)
+{
+	if (!known->frontier) {
+		known->frontier = frontier_build(known);
+	}
+	return known->frontier;
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Maintenance
+ * ------------------------------------------------------------------------ */
+/**
+ * Throw away the frontier of the player's map of a chunk
+ */
+void frontier_free(struct chunk *known)
+{
+	struct frontier *front = known->frontier;
+
+	if (!front) return;
+	mem_free(front->grids);
+	mem_free(front->pos);
+	mem_free(front);
+	known->frontier = NULL;
+}
+
+/**
+ * Note that the player has remembered or forgotten a grid; only the grid and
+ * its neighbours can have joined or left the frontier
+ */
+void frontier_note(struct chunk *known, struct loc grid)
+{
+	int d;
+
+	if (!known->frontier) return;
+	for (d = 0; d < 9; d++) {
+		struct loc adj = loc_sum(grid, ddgrid_ddd[d]);
+		if (!square_in_bounds(known, adj)) continue;
+		frontier_check(known->frontier, known, adj);
+	}
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Queries
+ * ------------------------------------------------------------------------ */
+/**
+ * Whether a grid is on the frontier
+ */
+bool frontier_has(struct chunk *known, struct loc grid)
+{
+	return frontier_get(known)->pos[frontier_index(known, grid)] >= 0;
+}
+
+/**
+ * Get the grids on the frontier.
+ *
+ * \param known is the player's map of the chunk.
+ * \param list is set to the frontier grids, in no particular order; it
+ * belongs to the frontier and lasts until the player's map next changes.
+ * \return the number of grids in the list
+ */
+int frontier_grids(struct chunk *known, const struct loc **list)
+{
+	struct frontier *front = frontier_get(known);
+
+	*list = front->grids;
+	return front->num;
+}
@@ -0,0 +1,28 @@
+/**
+ * \file cave-frontier.h
+ * \brief The edge of the player's knowledge of a level
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+#ifndef CAVE_FRONTIER_H
+#define CAVE_FRONTIER_H
+
+#include "cave.h"
+
+void frontier_free(struct chunk *known);
+void frontier_note(struct chunk *known, struct loc grid);
+bool frontier_has(struct chunk *known, struct loc grid);
+int frontier_grids(struct chunk *known, const struct loc **list);
+
+#endif /* !CAVE_FRONTIER_H */
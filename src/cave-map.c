@@ -18,6 +18,7 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "cave-frontier.h"
 #include "game-world.h"
 #include "init.h"
 #include "monster.h"
@@ -28,6 +29,7 @@
 #include "obj-tval.h"
 #include "obj-util.h"
 #include "player-calcs.h"
+#include "player-path.h"
 #include "player-timed.h"
 #include "trap.h"
 
@@ -655,4 +657,9 @@ void cave_known(struct player *p)
 			}
 		}
 	}
+
+	/* Too much has changed to patch up the frontier */
+	frontier_free(p->cave);
+	path_regions_free(p->cave);
+	cave_memory_changed(p->cave);
 }
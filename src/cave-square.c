@@ -18,13 +18,17 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "cave-frontier.h"
 #include "game-world.h"
 #include "init.h"
+#include "mon-index.h"
+#include "mon-sched.h"
 #include "monster.h"
 #include "obj-knowledge.h"
 #include "obj-pile.h"
 #include "obj-util.h"
 #include "object.h"
+#include "player-path.h"
 #include "player-quest.h"
 #include "player-timed.h"
 #include "player-util.h"
@@ -1519,6 +1523,10 @@ void square_set_feat(struct chunk *c, struct loc grid, int feat)
 		if (!square_isobjectholding(c, grid))
 			square_excise_pile(c, grid);
 
+		/* A monster here may now be in trouble */
+		if (square(c, grid)->mon > 0)
+			mon_sched_wake(c, square_monster(c, grid));
+
 		square_note_spot(c, grid);
 		square_light_spot(c, grid);
 	} else {
@@ -1534,8 +1542,20 @@ void square_set_feat(struct chunk *c, struct loc grid, int feat)
  */
 static void square_set_known_feat(struct chunk *c, struct loc grid, int feat)
 {
+	struct square *known;
+	bool was_known;
+
 	if (c != cave) return;
-	player->cave->squares[grid.y][grid.x].feat = feat;
+	known = &player->cave->squares[grid.y][grid.x];
+	was_known = known->feat != FEAT_NONE;
+	if (known->feat != feat) {
+		cave_memory_changed(player->cave);
+		path_regions_note(player->cave, grid);
+	}
+	known->feat = feat;
+	if (was_known != (feat != FEAT_NONE)) {
+		frontier_note(player->cave, grid);
+	}
 }
 
 /**
@@ -1543,7 +1563,10 @@ static void square_set_known_feat(struct chunk *c, struct loc grid, int feat)
  */
 void square_set_mon(struct chunk *c, struct loc grid, int midx)
 {
+	int old_midx = c->squares[grid.y][grid.x].mon;
+
 	c->squares[grid.y][grid.x].mon = midx;
+	mon_index_set(c, grid, old_midx, midx);
 }
 
 /**
@@ -26,6 +26,10 @@
 #include "player-timed.h"
 #include "player-util.h"
 #include "trap.h"
+#include "z-profile.h"
+
+PROFILE_COUNTER(update_view, "grids");
+PROFILE_COUNTER(calc_lighting, "grids");
 
 /**
  * Approximate distance between two points.
@@ -665,6 +669,7 @@ static void calc_lighting(struct chunk *c, struct player *p)
 	int light = p->state.cur_light, radius = ABS(light) - 1;
 	int old_light = square_light(c, p->grid);
 	bool sunlit = is_daytime() && outside();
+	PROFILE_START(calc_lighting);
 
 	/* Starting values based on permanent light */
 	for (y = 0; y < c->height; y++) {
@@ -732,6 +737,7 @@ static void calc_lighting(struct chunk *c, struct player *p)
 	if (square_light(c, p->grid) != old_light) {
 		p->upkeep->redraw |= PR_LIGHT;
 	}
+	PROFILE_STOP(calc_lighting, c->height * c->width);
 }
 
 /**
@@ -882,6 +888,7 @@ static void update_one(struct chunk *c, struct loc grid, struct player *p)
 void update_view(struct chunk *c, struct player *p)
 {
 	int x, y;
+	PROFILE_START(update_view);
 
 	/* Record the current view */
 	mark_wasseen(c);
@@ -916,6 +923,7 @@ void update_view(struct chunk *c, struct player *p)
 	for (y = 0; y < c->height; y++)
 		for (x = 0; x < c->width; x++)
 			update_one(c, loc(x, y), p);
+	PROFILE_STOP(update_view, c->height * c->width);
 }
 
 
@@ -18,6 +18,7 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "cave-frontier.h"
 #include "cmds.h"
 #include "cmd-core.h"
 #include "game-event.h"
@@ -25,16 +26,24 @@
 #include "generate.h"
 #include "init.h"
 #include "mon-group.h"
+#include "mon-index.h"
+#include "mon-sched.h"
 #include "monster.h"
 #include "obj-ignore.h"
 #include "obj-pile.h"
 #include "obj-tval.h"
 #include "obj-util.h"
 #include "object.h"
+#include "player-path.h"
 #include "player-timed.h"
 #include "trap.h"
+#include "z-index.h"
+#include "z-profile.h"
 #include "z-queue.h"
 
+PROFILE_COUNTER(make_noise, "grids");
+PROFILE_COUNTER(update_scent, "grids");
+
 struct feature *f_info;
 struct chunk *cave = NULL;
 
@@ -314,6 +323,22 @@ struct loc next_grid(struct loc grid, int dir)
 	return loc(grid.x + ddgrid[dir].x, grid.y + ddgrid[dir].y);
 }
 
+/**
+ * Index of terrain features by name
+ */
+static struct name_index *feat_by_name;
+static int feats_indexed;
+
+/**
+ * Throw away the terrain feature index, when f_info is freed
+ */
+void feat_index_free(void)
+{
+	name_index_free(feat_by_name);
+	feat_by_name = NULL;
+	feats_indexed = 0;
+}
+
 /**
  * Find a terrain feature index by name
  */
@@ -322,15 +347,17 @@ int lookup_feat(const char *name)
 	int i;
 
 	/* Look for it */
-	for (i = 0; i < z_info->f_max; i++) {
-		struct feature *feat = &f_info[i];
-		if (!feat->name)
-			continue;
-
-		/* Test for equality */
-		if (streq(name, feat->name))
-			return i;
+	if (feats_indexed != z_info->f_max) {
+		feat_index_free();
+		feat_by_name = name_index_new(false);
+		for (i = 0; i < z_info->f_max; i++) {
+			if (!f_info[i].name) continue;
+			name_index_add(feat_by_name, 0, f_info[i].name, i);
+		}
+		feats_indexed = z_info->f_max;
 	}
+	i = name_index_find(feat_by_name, 0, name);
+	if (i >= 0) return i;
 
 	/* Fail horribly */
 	quit_fmt("Failed to find terrain feature %s", name);
@@ -396,6 +423,21 @@ void heatmap_free(struct chunk *c, struct heatmap map)
 	mem_free(map.grids);
 }
 
+/**
+ * Source of the stamps marking changes to the player's memory of a chunk;
+ * no two changes to any chunk get the same stamp
+ */
+static uint32_t memory_stamps;
+
+/**
+ * Note a change to the player's memory of a chunk, so anything worked out
+ * from the old memory (such as pathfinding distances) is known to be stale
+ */
+void cave_memory_changed(struct chunk *c)
+{
+	c->memory_stamp = ++memory_stamps;
+}
+
 /**
  * Allocate a new chunk of the world
  */
@@ -430,6 +472,7 @@ struct chunk *cave_new(int height, int width) {
 	c->ghost = mem_zalloc(sizeof(struct ghost_info));
 
 	c->turn = turn;
+	cave_memory_changed(c);
 	return c;
 }
 
@@ -479,6 +522,10 @@ void cave_free(struct chunk *c) {
 
 	mem_free(c->feat_count);
 	mem_free(c->objects);
+	mon_sched_free(c);
+	mon_index_free(c);
+	frontier_free(c);
+	path_regions_free(c);
 	mem_free(c->monsters);
 	mem_free(c->monster_groups);
 	if (c->ghost) {
@@ -804,9 +851,11 @@ void make_noise(struct chunk *c, struct player *p, struct monster *mon)
 	int y, x, d;
 	int noise = 0;
 	int noise_increment = p && p->timed[TMD_COVERTRACKS] ? 4 : 1;
+	int heard = 1;
     struct queue *queue = q_new(c->height * c->width);
 	struct loc decoy = cave_find_decoy(c);
 	struct heatmap noise_map = p ? c->noise : mon->noise;
+	PROFILE_START(make_noise);
 
 	/* Set all the grids to silence */
 	for (y = 1; y < c->height - 1; y++) {
@@ -859,6 +908,7 @@ void make_noise(struct chunk *c, struct player *p, struct monster *mon)
 
 			/* Save the noise */
 			noise_map.grids[grid.y][grid.x] = noise;
+			heard++;
 
 			/* Enqueue that entry */
 			q_push_int(queue, grid_to_i(grid, c->width));
@@ -866,6 +916,7 @@ void make_noise(struct chunk *c, struct player *p, struct monster *mon)
 	}
 
 	q_free(queue);
+	PROFILE_STOP(make_noise, heard);
 }
 
 /**
@@ -893,6 +944,7 @@ void update_scent(struct chunk *c, struct player *p, struct monster *mon)
 		{2, 2, 2, 2, 2},
 	};
 	struct heatmap scent_map = p ? c->scent : mon->scent;
+	PROFILE_START(update_scent);
 
 	/* Update scent for all grids */
 	for (y = 1; y < c->height - 1; y++) {
@@ -904,7 +956,10 @@ void update_scent(struct chunk *c, struct player *p, struct monster *mon)
 	}
 
 	/* Scentless player */
-	if (player->timed[TMD_COVERTRACKS]) return;
+	if (player->timed[TMD_COVERTRACKS]) {
+		PROFILE_STOP(update_scent, c->height * c->width);
+		return;
+	}
 
 	/* Lay down new scent around the player */
 	for (y = 0; y < 5; y++) {
@@ -950,4 +1005,5 @@ void update_scent(struct chunk *c, struct player *p, struct monster *mon)
 			scent_map.grids[scent.y][scent.x] = new_scent;
 		}
 	}
+	PROFILE_STOP(update_scent, c->height * c->width);
 }
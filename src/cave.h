@@ -25,6 +25,10 @@
 struct player;
 struct monster;
 struct monster_group;
+struct frontier;
+struct pf_regions;
+struct mon_index;
+struct mon_sched;
 
 extern const int16_t ddd[9];
 extern const int16_t ddx[10];
@@ -219,6 +223,11 @@ struct chunk {
 	uint16_t mon_cnt;
 	int mon_current;
 	int num_repro;
+	struct mon_sched *sched;
+	struct mon_index *mon_index;
+	struct frontier *frontier;
+	struct pf_regions *path_regions;
+	uint32_t memory_stamp;
 	struct ghost_info *ghost;
 
 	struct monster_group **monster_groups;
@@ -514,11 +523,13 @@ void square_unmark(struct chunk *c, struct loc grid);
 /* cave.c */
 int motion_dir(struct loc source, struct loc target);
 struct loc next_grid(struct loc grid, int dir);
+void feat_index_free(void);
 int lookup_feat(const char *name);
 void set_terrain(void);
 uint16_t **heatmap_new(struct chunk *c);
 void heatmap_free(struct chunk *c, struct heatmap map);
 struct chunk *cave_new(int height, int width);
+void cave_memory_changed(struct chunk *c);
 void cave_connectors_free(struct connector *join);
 void cave_free(struct chunk *c);
 void list_object(struct chunk *c, struct object *obj);
@@ -29,6 +29,7 @@
 #include "mon-desc.h"
 #include "mon-lore.h"
 #include "mon-predicate.h"
+#include "mon-sched.h"
 #include "mon-spell.h"
 #include "mon-timed.h"
 #include "mon-util.h"
@@ -123,42 +124,6 @@ void do_cmd_move_house(struct command *cmd)
 	return;
 }
 
-/**
- * Get the direction a path is heading
- */
-static const char *path_direction(int feat)
-{
-	if (feat == FEAT_LESS_NORTH) return "north";
-	if (feat == FEAT_MORE_NORTH) return "north";
-	if (feat == FEAT_LESS_EAST) return "east";
-	if (feat == FEAT_MORE_EAST) return "east";
-	if (feat == FEAT_LESS_SOUTH) return "south";
-	if (feat == FEAT_MORE_SOUTH) return "south";
-	if (feat == FEAT_LESS_WEST) return "west";
-	if (feat == FEAT_MORE_WEST) return "west";
-	if (feat == FEAT_LESS) return "up";
-	if (feat == FEAT_MORE) return "down";
-	return "";
-}
-
-/**
- * Get the return path of a path or stair (sigh)
- */
-static int return_path(int feat)
-{
-	if (feat == FEAT_LESS_NORTH) return FEAT_MORE_SOUTH;
-	if (feat == FEAT_MORE_NORTH) return FEAT_LESS_SOUTH;
-	if (feat == FEAT_LESS_EAST) return FEAT_MORE_WEST;
-	if (feat == FEAT_MORE_EAST) return FEAT_LESS_WEST;
-	if (feat == FEAT_LESS_SOUTH) return FEAT_MORE_NORTH;
-	if (feat == FEAT_MORE_SOUTH) return FEAT_LESS_NORTH;
-	if (feat == FEAT_LESS_WEST) return FEAT_MORE_EAST;
-	if (feat == FEAT_MORE_WEST) return FEAT_LESS_EAST;
-	if (feat == FEAT_LESS) return FEAT_MORE;
-	if (feat == FEAT_MORE) return FEAT_LESS;
-	return -1;
-}
-
 /**
  * Go up one level
  */
@@ -197,7 +162,7 @@ void do_cmd_go_up(struct command *cmd)
 	//	return;
 	//}
 
-	new_place = player_get_next_place(player->place, path_direction(feat), 1);
+	new_place = player_stairs_place(player, feat);
 
 	/* Take a turn */
 	player->upkeep->energy_use = z_info->move_energy;
@@ -228,16 +193,7 @@ void do_cmd_go_up(struct command *cmd)
 	}
 
 	/* Create a way back */
-	player->upkeep->create_stair = return_path(feat);
-
-	/* Record the non-obvious exit coordinate */
-	if ((feat == FEAT_LESS_NORTH) || (feat == FEAT_MORE_NORTH) ||
-		(feat == FEAT_LESS_SOUTH) || (feat == FEAT_MORE_SOUTH)) {
-		player->upkeep->path_coord = player->grid.x;
-	} else if ((feat == FEAT_LESS_EAST) || (feat == FEAT_MORE_EAST) ||
-			   (feat == FEAT_LESS_WEST) || (feat == FEAT_MORE_WEST)) {
-		player->upkeep->path_coord = player->grid.y;
-	}
+	player_set_way_back(player, feat);
 
 	/* Change level */
 	player_change_place(player, new_place);
@@ -282,7 +238,7 @@ void do_cmd_go_down(struct command *cmd)
 		}
 	}
 
-	new_place = player_get_next_place(player->place, path_direction(feat), 1);
+	new_place = player_stairs_place(player, feat);
 
 	/* Warn a force_descend player if they're going to a quest level */
 	//if (OPT(player, birth_force_descend) && quest_forbid_downstairs(new_place)) {
@@ -302,16 +258,7 @@ void do_cmd_go_down(struct command *cmd)
 	}
 
 	/* Create a way back */
-	player->upkeep->create_stair = return_path(feat);
-
-	/* Record the non-obvious exit coordinate */
-	if ((feat == FEAT_LESS_NORTH) || (feat == FEAT_MORE_NORTH) ||
-		(feat == FEAT_LESS_SOUTH) || (feat == FEAT_MORE_SOUTH)) {
-		player->upkeep->path_coord = player->grid.x;
-	} else if ((feat == FEAT_LESS_EAST) || (feat == FEAT_MORE_EAST) ||
-			   (feat == FEAT_LESS_WEST) || (feat == FEAT_MORE_WEST)) {
-		player->upkeep->path_coord = player->grid.y;
-	}
+	player_set_way_back(player, feat);
 
 	/* Change level */
 	player_change_place(player, new_place);
@@ -2062,6 +2009,7 @@ void do_cmd_mon_command(struct command *cmd)
 				msg("No target monster selected!");
 				return;
 			}
+			mon_sched_wake(cave, mon);
 			mon->target.midx = t_mon->midx;
 
 			/* Pick a random spell and cast it */
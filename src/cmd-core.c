@@ -20,6 +20,7 @@
 #include "angband.h"
 #include "cmds.h"
 #include "cmd-core.h"
+#include "cmd-record.h"
 #include "effects-info.h"
 #include "game-input.h"
 #include "game-world.h"
@@ -263,6 +264,24 @@ static struct command last_command = {
 static bool repeat_prev_allowed = false;
 static bool repeating = false;
 
+/**
+ * Whether commands being queued now come from the player
+ */
+static bool player_input = false;
+
+/**
+ * Ask the UI for the player's next command
+ */
+errr cmd_get_player_command(cmd_context c)
+{
+	errr result;
+
+	player_input = true;
+	result = cmd_get_hook(c);
+	player_input = false;
+	return result;
+}
+
 
 struct command *cmdq_peek(void)
 {
@@ -296,6 +315,7 @@ errr cmdq_push_copy(struct command *cmd)
 		}
 		cmd_release(&cmd_queue[cmd_head]);
 		cmd_queue[cmd_head] = *cmd;
+		cmd_queue[cmd_head].from_player = player_input;
 	} else if (!repeat_prev_allowed) {
 		return 1;
 	} else {
@@ -316,6 +336,7 @@ errr cmdq_push_copy(struct command *cmd)
 		} else {
 			return 1;
 		}
+		cmd_queue[cmd_head].from_player = player_input;
 	}
 
 	/* Advance point in queue, wrapping around at the end */
@@ -341,6 +362,9 @@ static void process_command(cmd_context ctx, struct command *cmd)
 
 	if (idx == -1) return;
 
+	/* Objects may change, so describe them afresh */
+	object_desc_forget();
+
 	/* Command repetition */
 	if (game_cmds[idx].repeat_allowed) {
 		/* Auto-repeat only if there isn't already a repeat length. */
@@ -402,6 +426,8 @@ static void process_command(cmd_context ctx, struct command *cmd)
 bool cmdq_pop(cmd_context c)
 {
 	struct command *cmd;
+	bool record;
+	int nrepeats;
 
 	/* If we're repeating, just pull the last command again. */
 	if (repeating) {
@@ -416,11 +442,18 @@ bool cmdq_pop(cmd_context c)
 		return false;
 	}
 
+	/* Record what the player asked for, but not each repeat of it */
+	record = !repeating && cmd_recording()
+		&& (cmd->from_player || c == CTX_STORE);
+	nrepeats = cmd->nrepeats;
+
 	/* Now process it */
 	if (!cmd->background_command) {
 		last_command_idx = prev_cmd_idx(cmd_tail);
 	}
+	if (record) cmd_record_begin(cmd);
 	process_command(c, cmd);
+	if (record) cmd_record_end(cmd, nrepeats);
 	return true;
 }
 
@@ -625,6 +658,9 @@ static void cmd_set_arg(struct command *cmd, const char *name,
 	cmd->arg[idx].type = type;
 	cmd->arg[idx].data = data;
 	my_strcpy(cmd->arg[idx].name, name, sizeof cmd->arg[0].name);
+
+	/* Note it now, while whatever it refers to is where it was chosen */
+	if (cmd_recording()) cmd_record_arg(cmd, &cmd->arg[idx]);
 }
 
 /**
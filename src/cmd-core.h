@@ -253,6 +253,9 @@ struct command {
 	 */
 	int background_command;
 
+	/* Whether the player gave this command, rather than the game */
+	bool from_player;
+
 	/* Arguments */
 	struct cmd_arg arg[CMD_MAX_ARGS];
 };
@@ -302,6 +305,7 @@ struct command *cmdq_peek(void);
  * A function called by the game to get a command from the UI.
  */
 extern errr (*cmd_get_hook)(cmd_context c);
+errr cmd_get_player_command(cmd_context c);
 
 /**
  * Gets the next command from the queue and processes it
@@ -0,0 +1,590 @@
+/**
+ * \file cmd-record.c
+ * \brief Recording the player's commands, and playing them back
+ *
+ * While recording, each command the player gives is written to a log once it
+ * has been carried out, with all the arguments it ended up with, whether they
+ * came with the command or were asked for along the way.  Items and targets
+ * are written as where they were when chosen, since the objects and monsters
+ * themselves won't be the same ones when the log is played back.  Commands
+ * the game queues for itself, like the steps of a run, aren't written; they
+ * will be queued again on playing back.
+ *
+ * The log starts with the name of a savefile written as recording began, and
+ * the state of the random number generator.  Playing back loads that save,
+ * puts the random number generator back as it was, and then queues the
+ * commands one at a time as the game asks for them.  Each command also notes
+ * the turn and the state of the random number generator when it was given,
+ * so anything which makes the game go differently is noticed.
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "buildid.h"
+#include "cave.h"
+#include "cmd-record.h"
+#include "game-world.h"
+#include "parser.h"
+#include "player.h"
+#include "savefile.h"
+#include "store.h"
+#include "target.h"
+
+/**
+ * A command read from a log
+ */
+struct replay_command {
+	int32_t turn;
+	uint32_t check;
+	int code;
+	int nrepeats;
+	int background;
+	char *args;
+};
+
+struct cmd_replay {
+	char *save;
+	uint32_t rng_value, rng_i;
+	uint32_t state[RAND_DEG];
+	struct replay_command *cmds;
+	int num, max;
+	int next;			/* The next command to queue */
+	int diverged;		/* Commands not given at the recorded moment */
+};
+
+/**
+ * The log being written, and the command being recorded
+ */
+static ang_file *record_file;
+static const struct command *record_cmd;
+static int32_t record_turn;
+static uint32_t record_check;
+static struct {
+	char name[20];
+	char text[256];
+} record_args[CMD_MAX_ARGS];
+static int record_num_args;
+
+/**
+ * ------------------------------------------------------------------------
+ * Writing arguments
+ * ------------------------------------------------------------------------ */
+/**
+ * Get a number which changes whenever the random number generator is used
+ */
+static uint32_t rng_check(void)
+{
+	return STATE[state_i] ^ (state_i << 24) ^ Rand_value;
+}
+
+/**
+ * Write a string so it has no spaces or separators in it
+ */
+static void record_string(char *buf, size_t len, const char *s)
+{
+	size_t n = 0;
+
+	for (; *s && n + 4 < len; s++) {
+		unsigned char c = (unsigned char) *s;
+
+		if (isalnum(c) || c == '-' || c == '_' || c == '.') {
+			buf[n++] = c;
+		} else {
+			n += strnfmt(buf + n, len - n, "%%%02X", c);
+		}
+	}
+	buf[n] = '\0';
+}
+
+/**
+ * Write where an item is, as the place in a list of objects the player can
+ * get at
+ */
+static void record_item(char *buf, size_t len, const struct object *obj)
+{
+	const struct object *o;
+	struct store *store;
+	int i;
+
+	if (!obj) {
+		my_strcpy(buf, "none", len);
+		return;
+	}
+	for (o = player->gear, i = 0; o; o = o->next, i++) {
+		if (o == obj) {
+			strnfmt(buf, len, "gear/%d", i);
+			return;
+		}
+	}
+	if (cave && square_in_bounds(cave, obj->grid)) {
+		for (o = square_object(cave, obj->grid), i = 0; o;
+				o = o->next, i++) {
+			if (o == obj) {
+				strnfmt(buf, len, "floor/%d/%d/%d", obj->grid.x,
+					obj->grid.y, i);
+				return;
+			}
+		}
+	}
+	store = cave ? store_at(cave, player->grid) : NULL;
+	if (store) {
+		for (o = store->stock, i = 0; o; o = o->next, i++) {
+			if (o == obj) {
+				strnfmt(buf, len, "store/%d", i);
+				return;
+			}
+		}
+	}
+	my_strcpy(buf, "none", len);
+}
+
+static void record_arg_text(char *buf, size_t len, const struct cmd_arg *arg)
+{
+	char part[200];
+	struct loc grid;
+
+	switch (arg->type) {
+		case arg_STRING:
+			record_string(part, sizeof(part), arg->data.string);
+			strnfmt(buf, len, "string/%s", part);
+			break;
+		case arg_CHOICE:
+			strnfmt(buf, len, "choice/%d", arg->data.choice);
+			break;
+		case arg_NUMBER:
+			strnfmt(buf, len, "number/%d", arg->data.number);
+			break;
+		case arg_DIRECTION:
+			strnfmt(buf, len, "direction/%d", arg->data.direction);
+			break;
+		case arg_TARGET:
+			/* Aiming at the target means saying what the target was */
+			if (arg->data.direction == DIR_TARGET && target_is_set()) {
+				target_get(&grid);
+				strnfmt(buf, len, "target/%d/%d/%d/%d",
+					arg->data.direction, grid.x, grid.y,
+					target_get_monster() ? 1 : 0);
+			} else {
+				strnfmt(buf, len, "target/%d", arg->data.direction);
+			}
+			break;
+		case arg_POINT:
+			strnfmt(buf, len, "point/%d/%d", arg->data.point.x,
+				arg->data.point.y);
+			break;
+		case arg_ITEM:
+			record_item(part, sizeof(part), arg->data.obj);
+			strnfmt(buf, len, "item/%s", part);
+			break;
+		default:
+			my_strcpy(buf, "none", len);
+			break;
+	}
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Recording
+ * ------------------------------------------------------------------------ */
+/**
+ * Start recording the player's commands.
+ *
+ * \param path is the log to write; the game is saved alongside it, to the
+ * same path with ".sav" added, to play the log back from
+ * \return whether the save and the log could both be written
+ */
+bool cmd_record_start(const char *path)
+{
+	char save[1024];
+	int i;
+
+	cmd_record_stop();
+	strnfmt(save, sizeof(save), "%s.sav", path);
+	if (!savefile_save(save)) return false;
+	record_file = file_open(path, MODE_WRITE, FTYPE_TEXT);
+	if (!record_file) return false;
+
+	file_putf(record_file, "# Commands given in %s, for playing back\n",
+		buildid);
+	file_putf(record_file, "version:%s\n", buildver);
+	file_putf(record_file, "save:%s\n", save);
+	file_putf(record_file, "rng:%lu:%lu\n", (unsigned long) Rand_value,
+		(unsigned long) state_i);
+	for (i = 0; i < RAND_DEG; i++) {
+		file_putf(record_file, "state:%d:%lu\n", i,
+			(unsigned long) STATE[i]);
+	}
+	return true;
+}
+
+/**
+ * Stop recording, if recording
+ */
+void cmd_record_stop(void)
+{
+	if (!record_file) return;
+	file_close(record_file);
+	record_file = NULL;
+	record_cmd = NULL;
+}
+
+bool cmd_recording(void)
+{
+	return record_file != NULL;
+}
+
+/**
+ * Note a command the player has given, which is about to be carried out
+ */
+void cmd_record_begin(const struct command *cmd)
+{
+	int i;
+
+	if (!record_file) return;
+	record_cmd = cmd;
+	record_turn = turn;
+	record_check = rng_check();
+	record_num_args = 0;
+	for (i = 0; i < CMD_MAX_ARGS; i++) {
+		if (cmd->arg[i].name[0]) cmd_record_arg(cmd, &cmd->arg[i]);
+	}
+}
+
+/**
+ * Note an argument of the command being carried out, as it is given
+ */
+void cmd_record_arg(const struct command *cmd, const struct cmd_arg *arg)
+{
+	int i;
+
+	if (!record_file || cmd != record_cmd) return;
+	for (i = 0; i < record_num_args; i++) {
+		if (streq(record_args[i].name, arg->name)) break;
+	}
+	if (i == record_num_args) {
+		if (record_num_args == CMD_MAX_ARGS) return;
+		record_num_args++;
+	}
+	my_strcpy(record_args[i].name, arg->name, sizeof(record_args[i].name));
+	record_arg_text(record_args[i].text, sizeof(record_args[i].text), arg);
+}
+
+/**
+ * Write out a command once it has been carried out
+ *
+ * \param cmd is the command
+ * \param nrepeats is how many times it was to be repeated when given
+ */
+void cmd_record_end(const struct command *cmd, int nrepeats)
+{
+	int i;
+
+	if (!record_file || cmd != record_cmd) return;
+	file_putf(record_file, "cmd:%ld:%lu:%d:%d:%d", (long) record_turn,
+		(unsigned long) record_check, (int) cmd->code, nrepeats,
+		cmd->background_command);
+	for (i = 0; i < record_num_args; i++) {
+		file_putf(record_file, "%s%s=%s", i ? " " : ":",
+			record_args[i].name, record_args[i].text);
+	}
+	file_putf(record_file, "\n");
+	record_cmd = NULL;
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Reading logs
+ * ------------------------------------------------------------------------ */
+static enum parser_error parse_replay_version(struct parser *p)
+{
+	if (!streq(parser_getstr(p, "version"), buildver)) {
+		plog_fmt("Commands were recorded in version %s",
+			parser_getstr(p, "version"));
+	}
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_replay_save(struct parser *p)
+{
+	struct cmd_replay *replay = parser_priv(p);
+
+	string_free(replay->save);
+	replay->save = string_make(parser_getstr(p, "path"));
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_replay_rng(struct parser *p)
+{
+	struct cmd_replay *replay = parser_priv(p);
+
+	replay->rng_value = parser_getuint(p, "value");
+	replay->rng_i = parser_getuint(p, "index");
+	if (replay->rng_i >= RAND_DEG) return PARSE_ERROR_OUT_OF_BOUNDS;
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_replay_state(struct parser *p)
+{
+	struct cmd_replay *replay = parser_priv(p);
+	int i = parser_getint(p, "index");
+
+	if (i < 0 || i >= RAND_DEG) return PARSE_ERROR_OUT_OF_BOUNDS;
+	replay->state[i] = parser_getuint(p, "value");
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error parse_replay_cmd(struct parser *p)
+{
+	struct cmd_replay *replay = parser_priv(p);
+	struct replay_command *rc;
+
+	if (replay->num == replay->max) {
+		replay->max = replay->max ? 2 * replay->max : 256;
+		replay->cmds = mem_realloc(replay->cmds,
+			replay->max * sizeof(*replay->cmds));
+	}
+	rc = &replay->cmds[replay->num++];
+	rc->turn = parser_getint(p, "turn");
+	rc->check = parser_getuint(p, "check");
+	rc->code = parser_getint(p, "code");
+	rc->nrepeats = parser_getint(p, "repeats");
+	rc->background = parser_getint(p, "background");
+	rc->args = string_make(parser_hasval(p, "args") ?
+		parser_getstr(p, "args") : "");
+	return PARSE_ERROR_NONE;
+}
+
+/**
+ * Read a log of commands
+ *
+ * \return the commands, or NULL if the log can't be read
+ */
+struct cmd_replay *cmd_replay_load(const char *path)
+{
+	struct cmd_replay *replay;
+	struct parser *p;
+	ang_file *f;
+	char buf[1024];
+	errr err = PARSE_ERROR_NONE;
+
+	f = file_open(path, MODE_READ, FTYPE_TEXT);
+	if (!f) return NULL;
+
+	replay = mem_zalloc(sizeof(*replay));
+	p = parser_new();
+	parser_setpriv(p, replay);
+	parser_reg(p, "version str version", parse_replay_version);
+	parser_reg(p, "save str path", parse_replay_save);
+	parser_reg(p, "rng uint value uint index", parse_replay_rng);
+	parser_reg(p, "state int index uint value", parse_replay_state);
+	parser_reg(p, "cmd int turn uint check int code int repeats "
+		"int background ?str args", parse_replay_cmd);
+	while (!err && file_getl(f, buf, sizeof(buf))) {
+		err = parser_parse(p, buf);
+	}
+	parser_destroy(p);
+	file_close(f);
+
+	if (err || !replay->save) {
+		cmd_replay_free(replay);
+		return NULL;
+	}
+	return replay;
+}
+
+/**
+ * Get the savefile to load before playing back a log
+ */
+const char *cmd_replay_savefile(const struct cmd_replay *replay)
+{
+	return replay->save;
+}
+
+/**
+ * Get ready to play back a log, once the savefile has been loaded
+ */
+void cmd_replay_start(struct cmd_replay *replay)
+{
+	Rand_value = replay->rng_value;
+	state_i = replay->rng_i;
+	memcpy(STATE, replay->state, sizeof(STATE));
+	replay->next = 0;
+	replay->diverged = 0;
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Playing back
+ * ------------------------------------------------------------------------ */
+/**
+ * Turn a written string back into the string
+ */
+static char *replay_string(const char *text)
+{
+	char *s = string_make(text), *out = s;
+
+	for (; *text; text++) {
+		unsigned int c;
+
+		if (*text == '%' && sscanf(text + 1, "%2x", &c) == 1) {
+			*out++ = (char) c;
+			text += 2;
+		} else {
+			*out++ = *text;
+		}
+	}
+	*out = '\0';
+	return s;
+}
+
+/**
+ * Find the item at a written place
+ */
+static struct object *replay_item(const char *text)
+{
+	struct object *obj = NULL;
+	struct loc grid;
+	int i;
+
+	if (sscanf(text, "gear/%d", &i) == 1) {
+		obj = player->gear;
+	} else if (sscanf(text, "floor/%d/%d/%d", &grid.x, &grid.y, &i) == 3) {
+		if (!square_in_bounds(cave, grid)) return NULL;
+		obj = square_object(cave, grid);
+	} else if (sscanf(text, "store/%d", &i) == 1) {
+		struct store *store = store_at(cave, player->grid);
+
+		if (!store) return NULL;
+		obj = store->stock;
+	} else {
+		return NULL;
+	}
+	while (obj && i-- > 0) obj = obj->next;
+	return obj;
+}
+
+/**
+ * Give a command an argument read from a log
+ */
+static void replay_arg(struct command *cmd, const char *name,
+		const char *text)
+{
+	int value, x, y, mon;
+
+	if (prefix(text, "string/")) {
+		char *s = replay_string(text + strlen("string/"));
+
+		cmd_set_arg_string(cmd, name, s);
+		string_free(s);
+	} else if (sscanf(text, "choice/%d", &value) == 1) {
+		cmd_set_arg_choice(cmd, name, value);
+	} else if (sscanf(text, "number/%d", &value) == 1) {
+		cmd_set_arg_number(cmd, name, value);
+	} else if (sscanf(text, "direction/%d", &value) == 1) {
+		cmd_set_arg_direction(cmd, name, value);
+	} else if (sscanf(text, "target/%d/%d/%d/%d", &value, &x, &y,
+			&mon) == 4) {
+		struct loc grid = loc(x, y);
+
+		/* Put the target back as it was */
+		if (mon && square_in_bounds(cave, grid)
+				&& square_monster(cave, grid)) {
+			target_set_monster(square_monster(cave, grid));
+		} else {
+			target_set_location(y, x);
+		}
+		cmd_set_arg_target(cmd, name, value);
+	} else if (sscanf(text, "target/%d", &value) == 1) {
+		cmd_set_arg_target(cmd, name, value);
+	} else if (sscanf(text, "point/%d/%d", &x, &y) == 2) {
+		cmd_set_arg_point(cmd, name, loc(x, y));
+	} else if (prefix(text, "item/")) {
+		struct object *obj = replay_item(text + strlen("item/"));
+
+		if (obj) cmd_set_arg_item(cmd, name, obj);
+	}
+}
+
+/**
+ * Queue the next command from a log
+ *
+ * \return false if there are no more commands
+ */
+bool cmd_replay_next(struct cmd_replay *replay)
+{
+	struct command cmd = {
+		.context = CTX_INIT,
+		.code = CMD_NULL,
+		.nrepeats = 0,
+		.background_command = 0,
+		.arg = { { 0 } }
+	};
+	struct replay_command *rc;
+	char *args, *arg;
+
+	if (replay->next >= replay->num) return false;
+	rc = &replay->cmds[replay->next++];
+	if (rc->turn != turn || rc->check != rng_check()) {
+		replay->diverged++;
+	}
+
+	cmd.code = rc->code;
+	cmd.nrepeats = rc->nrepeats;
+	cmd.background_command = rc->background;
+	args = string_make(rc->args);
+	for (arg = strtok(args, " "); arg; arg = strtok(NULL, " ")) {
+		char *text = strchr(arg, '=');
+
+		if (!text) continue;
+		*text++ = '\0';
+		replay_arg(&cmd, arg, text);
+	}
+	string_free(args);
+
+	if (cmdq_push_copy(&cmd)) {
+		cmd_release(&cmd);
+	}
+	return true;
+}
+
+/**
+ * Get the number of commands in a log
+ */
+int cmd_replay_count(const struct cmd_replay *replay)
+{
+	return replay->num;
+}
+
+/**
+ * Get the number of commands so far which weren't given on the turn, or
+ * with the random number generator in the state, they were recorded with
+ */
+int cmd_replay_diverged(const struct cmd_replay *replay)
+{
+	return replay->diverged;
+}
+
+void cmd_replay_free(struct cmd_replay *replay)
+{
+	int i;
+
+	if (!replay) return;
+	for (i = 0; i < replay->num; i++) {
+		string_free(replay->cmds[i].args);
+	}
+	mem_free(replay->cmds);
+	string_free(replay->save);
+	mem_free(replay);
+}
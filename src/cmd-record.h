@@ -0,0 +1,40 @@
+/**
+ * \file cmd-record.h
+ * \brief Recording the player's commands, and playing them back
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+#ifndef CMD_RECORD_H
+#define CMD_RECORD_H
+
+#include "cmd-core.h"
+
+struct cmd_replay;
+
+bool cmd_record_start(const char *path);
+void cmd_record_stop(void);
+bool cmd_recording(void);
+void cmd_record_begin(const struct command *cmd);
+void cmd_record_arg(const struct command *cmd, const struct cmd_arg *arg);
+void cmd_record_end(const struct command *cmd, int nrepeats);
+
+struct cmd_replay *cmd_replay_load(const char *path);
+const char *cmd_replay_savefile(const struct cmd_replay *replay);
+void cmd_replay_start(struct cmd_replay *replay);
+bool cmd_replay_next(struct cmd_replay *replay);
+int cmd_replay_count(const struct cmd_replay *replay);
+int cmd_replay_diverged(const struct cmd_replay *replay);
+void cmd_replay_free(struct cmd_replay *replay);
+
+#endif /* !CMD_RECORD_H */
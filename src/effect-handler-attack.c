@@ -21,7 +21,9 @@
 #include "game-input.h"
 #include "init.h"
 #include "mon-desc.h"
+#include "mon-index.h"
 #include "mon-make.h"
+#include "mon-sched.h"
 #include "mon-spell.h"
 #include "mon-util.h"
 #include "obj-desc.h"
@@ -1478,7 +1480,8 @@ bool effect_handler_PROJECT_LOS(effect_handler_context_t *context)
  */
 bool effect_handler_PROJECT_LOS_AWARE(effect_handler_context_t *context)
 {
-	int i;
+	int i, n;
+	int16_t *near;
 	int dam = effect_calculate_value(context, context->other ? true : false);
 	int typ = context->subtype;
 
@@ -1486,9 +1489,10 @@ bool effect_handler_PROJECT_LOS_AWARE(effect_handler_context_t *context)
 
 	if (context->aware) flg |= PROJECT_AWARE;
 
-	/* Affect all (nearby) monsters */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
+	/* Affect all monsters in view */
+	n = mon_index_in_view(cave, player, &near);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, near[i]);
 		struct loc grid;
 
 		/* Paranoia -- Skip dead monsters */
@@ -1507,6 +1511,7 @@ bool effect_handler_PROJECT_LOS_AWARE(effect_handler_context_t *context)
 		(void)project(source_player(), 0, grid, dam, typ, flg, 0, 0, context->obj);
 		context->ident = true;
 	}
+	mem_free(near);
 
 	/* Result */
 	return true;
@@ -2024,8 +2029,10 @@ bool effect_handler_ENERGY_DRAIN(effect_handler_context_t *context)
 			if (!mon) continue;
 
 			/* Take the energy */
+			mon_sched_sync(cave, mon);
 			player->energy += mon->energy;
 			mon->energy = 0;
+			mon_sched_update(cave, mon);
 		}
 	}
 
@@ -24,6 +24,7 @@
 #include "generate.h"
 #include "init.h"
 #include "mon-desc.h"
+#include "mon-index.h"
 #include "mon-lore.h"
 #include "mon-make.h"
 #include "mon-predicate.h"
@@ -1841,36 +1842,21 @@ bool effect_handler_DETECT_OBJECTS(effect_handler_context_t *context)
  */
 static bool detect_monsters(int y_dist, int x_dist, monster_predicate pred)
 {
-	int i, x, y;
-	int x1, x2, y1, y2;
+	int i, n;
+	int16_t *near;
 
 	bool monsters = false;
 
-	/* Set the detection area */
-	y1 = player->grid.y - y_dist;
-	y2 = player->grid.y + y_dist;
-	x1 = player->grid.x - x_dist;
-	x2 = player->grid.x + x_dist;
-
-	if (y1 < 0) y1 = 0;
-	if (x1 < 0) x1 = 0;
-	if (y2 > cave->height - 1) y2 = cave->height - 1;
-	if (x2 > cave->width - 1) x2 = cave->width - 1;
-
-	/* Scan monsters */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
+	/* Scan monsters in the detection area */
+	n = mon_index_in_rect(cave,
+		loc(player->grid.x - x_dist, player->grid.y - y_dist),
+		loc(player->grid.x + x_dist, player->grid.y + y_dist), &near);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, near[i]);
 
 		/* Skip dead monsters */
 		if (!mon->race) continue;
 
-		/* Location */
-		y = mon->grid.y;
-		x = mon->grid.x;
-
-		/* Only detect nearby monsters */
-		if (x < x1 || y < y1 || x > x2 || y > y2) continue;
-
 		/* Detect all appropriate, obvious monsters */
 		if (pred(mon) && !monster_is_camouflaged(mon)) {
 			/* Detect the monster */
@@ -1895,6 +1881,7 @@ static bool detect_monsters(int y_dist, int x_dist, monster_predicate pred)
 			monsters = true;
 		}
 	}
+	mem_free(near);
 
 	return monsters;
 }
@@ -2303,17 +2290,19 @@ bool effect_handler_ACQUIRE(effect_handler_context_t *context)
  */
 bool effect_handler_WAKE(effect_handler_context_t *context)
 {
-	int i;
+	int i, n;
+	int16_t *near;
 	bool woken = false;
 
 	struct loc origin = origin_get_loc(context->origin);
+	int radius = player->themed_level ? z_info->max_sight :
+		z_info->max_sight * 2;
 
 	/* Wake everyone nearby */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
+	n = mon_index_in_radius(cave, origin, radius - 1, &near);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, near[i]);
 		if (mon->race) {
-			int radius = player->themed_level ? z_info->max_sight :
-				z_info->max_sight * 2;
 			int dist = distance(origin, mon->grid);
 
 			/* Skip monsters too far away */
@@ -2324,6 +2313,7 @@ bool effect_handler_WAKE(effect_handler_context_t *context)
 			}
 		}
 	}
+	mem_free(near);
 
 	/* Messages */
 	if (woken) {
@@ -2438,7 +2428,8 @@ bool effect_handler_SUMMON(effect_handler_context_t *context)
  */
 bool effect_handler_BANISH(effect_handler_context_t *context)
 {
-	int i;
+	int i, n;
+	int16_t *near;
 	unsigned dam = 0;
 
 	bool hurt = true;
@@ -2463,9 +2454,17 @@ bool effect_handler_BANISH(effect_handler_context_t *context)
 		}
 	}
 
+	/* Find the monsters in range, or on the whole level */
+	if (context->radius) {
+		n = mon_index_in_radius(cave, ref_mon->grid, context->radius, &near);
+	} else {
+		n = mon_index_in_rect(cave, loc(0, 0),
+			loc(cave->width - 1, cave->height - 1), &near);
+	}
+
 	/* Delete the monsters of that "type" */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, near[i]);
 
 		/* Paranoia -- Skip dead monsters */
 		if (!mon->race) continue;
@@ -2484,20 +2483,15 @@ bool effect_handler_BANISH(effect_handler_context_t *context)
 			if ((char) mon->race->d_char != typ) continue;
 		}
 
-		/* Skip distant monsters if needed */
-		if (context->radius &&
-			(distance(mon->grid, ref_mon->grid) > context->radius)) {
-			continue;
-		}
-
 		/* Delete the monster */
-		delete_monster_idx(cave, i);
+		delete_monster_idx(cave, near[i]);
 
 		/* Take some damage */
 		if (hurt) {
 			dam += randint1(4);
 		}
 	}
+	mem_free(near);
 
 	/* Hurt the player */
 	dam = player_apply_damage_reduction(player, dam);
@@ -2519,7 +2513,8 @@ bool effect_handler_BANISH(effect_handler_context_t *context)
  */
 bool effect_handler_MASS_BANISH(effect_handler_context_t *context)
 {
-	int i;
+	int i, n;
+	int16_t *near;
 	int radius = context->radius ? context->radius : z_info->max_sight;
 	unsigned dam = 0;
 
@@ -2532,8 +2527,9 @@ bool effect_handler_MASS_BANISH(effect_handler_context_t *context)
 	}
 
 	/* Delete the (nearby) monsters */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
+	n = mon_index_in_radius(cave, player->grid, radius, &near);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, near[i]);
 
 		/* Paranoia -- Skip dead monsters */
 		if (!mon->race) continue;
@@ -2541,15 +2537,13 @@ bool effect_handler_MASS_BANISH(effect_handler_context_t *context)
 		/* Skip unique monsters */
 		if (monster_is_unique(mon)) continue;
 
-		/* Skip distant monsters */
-		if (mon->cdis > radius) continue;
-
 		/* Delete the monster */
-		delete_monster_idx(cave, i);
+		delete_monster_idx(cave, near[i]);
 
 		/* Take some damage */
 		dam += randint1(3);
 	}
+	mem_free(near);
 
 	/* Hurt the player */
 	dam = player_apply_damage_reduction(player, dam);
@@ -2569,20 +2563,19 @@ bool effect_handler_MASS_BANISH(effect_handler_context_t *context)
  */
 bool effect_handler_PROBE(effect_handler_context_t *context)
 {
-	int i;
+	int i, n;
+	int16_t *near;
 
 	bool probe = false;
 
-	/* Probe all (nearby) monsters */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
+	/* Probe all monsters in view */
+	n = mon_index_in_view(cave, player, &near);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, near[i]);
 
 		/* Paranoia -- Skip dead monsters */
 		if (!mon->race) continue;
 
-		/* Require line of sight */
-		if (!square_isview(cave, mon->grid)) continue;
-
 		/* Probe visible monsters */
 		if (monster_is_visible(mon)) {
 			char m_name[80];
@@ -2604,6 +2597,7 @@ bool effect_handler_PROBE(effect_handler_context_t *context)
 			probe = true;
 		}
 	}
+	mem_free(near);
 
 	/* Done */
 	if (probe) {
@@ -28,6 +28,7 @@
 #include "player-util.h"
 #include "project.h"
 #include "trap.h"
+#include "z-index.h"
 
 
 /**
@@ -116,21 +117,40 @@ const char *effect_desc(const struct effect *effect)
 	return effects[effect->index].desc;
 }
 
+/**
+ * Index of effect names, made the first time one is looked up
+ */
+static struct name_index *effect_by_name;
+
 effect_index effect_lookup(const char *name)
 {
-	size_t i;
+	int i;
 
-	for (i = 0; i < N_ELEMENTS(effect_names); i++) {
-		const char *effect_name = effect_names[i];
+	if (!effect_by_name) {
+		size_t j;
 
-		/* Test for equality */
-		if (effect_name != NULL && streq(name, effect_name))
-			return i;
+		effect_by_name = name_index_new(false);
+		for (j = 0; j < N_ELEMENTS(effect_names); j++) {
+			if (!effect_names[j]) continue;
+			name_index_add(effect_by_name, 0, effect_names[j], (int) j);
+		}
 	}
+	i = name_index_find(effect_by_name, 0, name);
 
-	return EF_MAX;
+	return (i >= 0) ? (effect_index) i : EF_MAX;
 }
 
+static void cleanup_effects(void)
+{
+	name_index_free(effect_by_name);
+	effect_by_name = NULL;
+}
+
+struct init_module effects_module = {
+	.name = "effects",
+	.cleanup = cleanup_effects
+};
+
 /**
  * Check whether two effects are equal (assumes dice contain no expressions)
  */
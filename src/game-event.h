@@ -94,7 +94,10 @@ typedef enum game_event_type
 
 	/* Events for introspection into dungeon generation */
 	EVENT_GEN_LEVEL_START, /* has string in event data for profile name */
+	EVENT_GEN_LEVEL_PHASE, /* has string in event data for phase name */
+	EVENT_GEN_LEVEL_FAIL, /* has string in event data for the reason */
 	EVENT_GEN_LEVEL_END, /* has flag in event data indicating success */
+	EVENT_GEN_LEVEL_GUESSED, /* level made ahead; END follows if it's used */
 	EVENT_GEN_ROOM_START, /* has string in event data for room type */
 	EVENT_GEN_ROOM_CHOOSE_SIZE, /* has size in event data */
 	EVENT_GEN_ROOM_CHOOSE_SUBTYPE, /* has string in event data with name */
@@ -24,6 +24,7 @@
 #include "init.h"
 #include "mon-make.h"
 #include "mon-move.h"
+#include "mon-sched.h"
 #include "mon-util.h"
 #include "obj-curse.h"
 #include "obj-desc.h"
@@ -37,6 +38,7 @@
 #include "source.h"
 #include "target.h"
 #include "trap.h"
+#include "z-profile.h"
 
 uint16_t daycount = 0;
 uint32_t seed_randart;		/* Consistent random artifacts */
@@ -396,6 +398,9 @@ static void sun_banish(void)
 	struct monster_race *race;
 	int i;
 
+	/* This runs outside the usual turn order, so drop the schedule */
+	mon_sched_flush(cave);
+
 	/* Process all monsters */
 	for (i = 1; i < cave_monster_max(cave) - 1; i++) {
 		/* Access the monster */
@@ -633,7 +638,7 @@ void process_world(struct chunk *c)
 
 	/* Check for light change */
 	if (player_has(player, PF_UNLIGHT)) {
-		player->upkeep->update |= PU_BONUS;
+		player->upkeep->update |= PU_BONUS_QUICK;
 	}
 
 	/* See if there is already a player ghost on the level */
@@ -760,7 +765,7 @@ void process_world(struct chunk *c)
 		/* Digest quickly when gorged */
 		player_dec_timed(player, TMD_FOOD, 5000 / z_info->food_value,
 			false, true);
-		player->upkeep->update |= PU_BONUS;
+		player->upkeep->update |= PU_BONUS_QUICK;
 	}
 
 	/* Faint or starving */
@@ -803,13 +808,13 @@ void process_world(struct chunk *c)
 		 * characters, Heighten Power decays quickly when highly charged */
 		int decrement = 10 + (player->heighten_power / 55);
 		player->heighten_power = MAX(0, player->heighten_power - decrement);
-		player->upkeep->update |= (PU_BONUS);
+		player->upkeep->update |= (PU_BONUS_QUICK);
 	}
 
 	/* Decay special speed boost */
 	if (player->speed_boost) {
 		player->speed_boost = MAX(player->speed_boost - 10, 0);
-		player->upkeep->update |= (PU_BONUS);
+		player->upkeep->update |= (PU_BONUS_QUICK);
 	}
 
 	/* Process light */
@@ -1081,8 +1086,11 @@ void process_player(void)
 		}
 
 		/* Get a command from the queue if there is one */
-		if (!cmdq_pop(CTX_GAME))
+		if (!cmdq_pop(CTX_GAME)) {
+			/* Make the level beyond any stairs while the player decides */
+			level_speculate(player);
 			break;
+		}
 
 		if (!player->upkeep->playing)
 			break;
@@ -1269,6 +1277,8 @@ void run_game_loop(void)
 
 			/* Count game turns */
 			turn++;
+			object_desc_forget();
+			profile_new_turn();
 		}
 
 		/* Make a new level if requested */
@@ -845,6 +845,8 @@ static void do_traditional_tunneling(struct chunk *c)
 	int i;
 	struct loc grid;
 
+	event_signal_string(EVENT_GEN_LEVEL_PHASE, "tunnels");
+
 	/*
 	 * Scramble the order in which the rooms will be connected.  Use
 	 * indirect indexing so dun->ent2room can be left as it is.
@@ -957,6 +959,7 @@ static void handle_level_stairs(struct chunk *c, bool persistent,
 	 */
 	int minsep = MAX(MIN(c->width, c->height) / 4, (persistent) ? 4 : 0);
 
+	event_signal_string(EVENT_GEN_LEVEL_PHASE, "populate");
 	if (!persistent || !chunk_find_adjacent(c->depth, "down")) {
 		alloc_stairs(c, FEAT_MORE, down_count, minsep, false,
 			dun->one_off_below);
@@ -1734,235 +1737,98 @@ static void mutate_cavern(struct chunk *c) {
 }
 
 /**
- * Fill an int[] with a single value.
- * \param data is the array
- * \param value is what it's being filled with
- * \param size is the array length
- */
-static void array_filler(int data[], int value, int size) {
-	int i;
-	for (i = 0; i < size; i++) data[i] = value;
-}
-
-/**
- * Determine if we need to worry about coloring a point, or can ignore it.
+ * Determine whether a grid joins up the grids around it, so belongs to a
+ * region: passable grids and doors do.
  * \param c is the current chunk
- * \param colors is the array of current point colors
  * \param grid is the coordinates of the point of interest
  */
-static int ignore_point(struct chunk *c, int colors[], struct loc grid) {
-	int n = grid_to_i(grid, c->width);
-
-	if (!square_in_bounds(c, grid)) return true;
-	if (colors[n]) return true;
-	if (square_ispassable(c, grid)) return false;
-	if (square_isdoor(c, grid)) return false;
-	return true;
-}
-
-/**
- * Color a particular point, and all adjacent points.
- * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
- * \param stairs If not NULL, stairs is an array with the same number of
- * elements as counts.  At exit, stairs[i] will indicate whether the region
- * with color i includes a staircase.
- * \param grid is the location
- * \param color is the color we are coloring
- * \param diagonal controls whether we can progress diagonally
- */
-static void build_color_point(struct chunk *c, int colors[], int counts[],
-		bool *stairs, struct loc grid, int color, bool diagonal) {
-	int h = c->height;
-	int w = c->width;
-	int size = h * w;
-	struct queue *queue = q_new(size);
-
-	int *added = mem_zalloc(size * sizeof(int));
-
-	array_filler(added, 0, size);
-
-	q_push_int(queue, grid_to_i(grid, w));
-
-	counts[color] = 0;
-
-	while (q_len(queue) > 0) {
-		int i;
-		struct loc grid1;
-		int n1 = q_pop_int(queue);
-
-		i_to_grid(n1, w, &grid1);
-
-		if (ignore_point(c, colors, grid1)) continue;
-
-		colors[n1] = color;
-		counts[color]++;
-		if (stairs && square_isstairs(c, grid1)) stairs[color] = true;
-
-		for (i = 0; i < (diagonal ? 8 : 4); i++) {
-			struct loc grid2 = loc_sum(grid1, ddgrid_ddd[i]);
-			int n2 = grid_to_i(grid2, w);
-			if (ignore_point(c, colors, grid2)) continue;
-			if (added[n2]) continue;
-
-			q_push_int(queue, n2);
-			added[n2] = 1;
-		}
-	}
-
-	mem_free(added);
-	q_free(queue);
-}
-
-/**
- * Create a color for each "NESW contiguous" region of the dungeon.
- * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
- * \param stairs If not NULL, stairs is an array with the same number of
- * elements as counts.  At exit, stairs[i] will indicate whether the region
- * with color i includes a staircase.
- * \param diagonal controls whether we can progress diagonally
- */
-static void build_colors(struct chunk *c, int colors[], int counts[],
-		bool *stairs, bool diagonal)
-{
-	int y, x;
-	int h = c->height;
-	int w = c->width;
-	int color = 1;
-
-	for (y = 0; y < h; y++) {
-		for (x = 0; x < w; x++) {
-			if (ignore_point(c, colors, loc(x, y))) continue;
-			build_color_point(c, colors, counts, stairs,
-				loc(x, y), color, diagonal);
-			color++;
-		}
-	}
+static bool square_isconnecting(struct chunk *c, struct loc grid) {
+	return square_ispassable(c, grid) || square_isdoor(c, grid);
 }
 
 /**
  * Find and delete all small (<9 square) open regions.
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
- * \param stairs If not NULL, stairs is an array with the same number of
- * elements as counts and stairs[i] will indicate whether the region with
- * color i includes a staircase.  Regions with staircases will not be deleted.
+ * \param r is the labelling of the chunk's regions
+ * \param keep_stairs If true, regions with staircases will not be deleted.
  */
-static void clear_small_regions(struct chunk *c, int colors[], int counts[],
-		bool *stairs)
+static void clear_small_regions(struct chunk *c, struct region_labels *r,
+		bool keep_stairs)
 {
-	int i, y, x;
-	int h = c->height;
-	int w = c->width;
-	int size = h * w;
-
-	int *deleted = mem_zalloc(size * sizeof(int));
-	array_filler(deleted, 0, size);
+	int i;
+	bool *deleted = mem_zalloc((r->num + 1) * sizeof(bool));
+	struct loc grid;
 
-	for (i = 0; i < size; i++) {
-		if (counts[i] < 9 && (!stairs || !stairs[i])) {
-			deleted[i] = 1;
-			counts[i] = 0;
-		}
+	for (i = 1; i <= r->num; i++) {
+		deleted[i] = r->size[i] > 0 && r->size[i] < 9
+			&& (!keep_stairs || !r->stairs[i]);
 	}
 
-	for (y = 1; y < c->height - 1; y++) {
-		for (x = 1; x < c->width - 1; x++) {
-			struct loc grid = loc(x, y);
-			i = grid_to_i(grid, w);
-
-			if (!deleted[colors[i]]) continue;
+	for (grid.y = 1; grid.y < c->height - 1; grid.y++) {
+		for (grid.x = 1; grid.x < c->width - 1; grid.x++) {
+			if (!deleted[region_of(r, grid)]) continue;
 
-			colors[i] = 0;
+			region_remove_grid(r, grid);
 			set_marked_granite(c, grid, SQUARE_WALL_SOLID);
 		}
 	}
-	mem_free(deleted);
-}
-
-/**
- * Return the number of colors which have active cells.
- * \param counts is the array of current color counts
- * \param size is the total area
- */
-static int count_colors(int counts[], int size) {
-	int i;
-	int num = 0;
-	for (i = 0; i < size; i++) if (counts[i] > 0) num++;
-	return num;
-}
 
-/**
- * Return the first color which has one or more active cells.
- * \param counts is the array of current color counts
- * \param size is the total area
- */
-static int first_color(int counts[], int size) {
-	int i;
-	for (i = 0; i < size; i++) if (counts[i] > 0) return i;
-	return -1;
-}
-
-/**
- * Find all cells of 'fromcolor' and repaint them to 'tocolor'.
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
- * \param from is the color to change
- * \param to is the color to change to
- * \param size is the total area
- */
-static void fix_colors(int colors[], int counts[], int from, int to, int size) {
-	int i;
-	for (i = 0; i < size; i++) if (colors[i] == from) colors[i] = to;
-	counts[to] += counts[from];
-	counts[from] = 0;
+	/* Anything left on the edges of the chunk doesn't count */
+	for (i = 1; i <= r->num; i++) {
+		if (deleted[i]) r->size[i] = 0;
+	}
+	mem_free(deleted);
 }
 
 /**
  * Create a tunnel connecting a region to one of its nearest neighbors.
  * Set new_color = -1 for any neighbour, the required color for a specific one
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
- * \param color is the color of the region we want to connect
- * \param new_color is the color of the region we want to connect to (if used)
+ * \param r is the labelling of the chunk's regions
+ * \param color is the region we want to connect
+ * \param new_color is the region we want to connect to (if used)
  * \param allow_vault_disconnect If true, vaults can be included in path
  * planning which can leave regions disconnected.
  */
-static void join_region(struct chunk *c, int colors[], int counts[], int color,
+static void join_region(struct chunk *c, struct region_labels *r, int color,
 	int new_color, bool allow_vault_disconnect)
 {
 	int i;
-	int h = c->height;
 	int w = c->width;
-	int size = h * w;
+	struct loc grid;
 
-	/* Allocate a processing queue */
-	struct queue *queue = q_new(size);
+	/* The squares to process, in order; head is the next to look at */
+	int *queue = r->list;
+	int head = 0, tail = 0;
 
-	/* Allocate an array to keep track of handled squares, and which square
-	 * we reached them from.
+	/* Keep track of handled squares, and which square we reached them
+	 * from; the labels come with this all unset.
 	 */
-	int *previous = mem_zalloc(size * sizeof(int));
-	array_filler(previous, -1, size);
+	int *previous = r->work;
+
+	if (!color) return;
 
 	/* Push all squares of the given color onto the queue */
-	for (i = 0; i < size; i++) {
-		if (colors[i] == color) {
-			q_push_int(queue, i);
-			previous[i] = i;
+	for (grid.y = r->top_left[color].y; grid.y <= r->bottom_right[color].y;
+			grid.y++) {
+		for (grid.x = r->top_left[color].x;
+				grid.x <= r->bottom_right[color].x; grid.x++) {
+			if (region_of(r, grid) == color) {
+				i = grid_to_i(grid, w);
+				queue[tail++] = i;
+				previous[i] = i;
+			}
 		}
 	}
 
 	/* Process all squares into the queue */
-	while (q_len(queue) > 0) {
+	while (head < tail) {
 		/* Get the current square and its color */
-		int n1 = q_pop_int(queue);
-		int color2 = colors[n1];
+		int n1 = queue[head++];
+		int color2;
+
+		i_to_grid(n1, w, &grid);
+		color2 = region_of(r, grid);
 
 		/* If we're not looking for a specific color, any new one will do */
 		if ((new_color == -1) && color2 && (color2 != color))
@@ -1971,14 +1837,8 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
 		/* See if we've reached a square with a new color */
 		if (color2 == new_color) {
 			/* Step backward through the path, turning stone to tunnel */
-			while (colors[n1] != color) {
-				struct loc grid;
-				i_to_grid(n1, w, &grid);
-				if (colors[n1] > 0) {
-					--counts[colors[n1]];
-				}
-				++counts[color];
-				colors[n1] = color;
+			while (region_of(r, grid) != color) {
+				region_add_grid(r, grid, color);
 				/* Don't break permanent walls or vaults.  Also
 				 * don't override terrain that already allows
 				 * passage. */
@@ -1989,10 +1849,11 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
 					square_set_feat(c, grid, FEAT_FLOOR);
 				}
 				n1 = previous[n1];
+				i_to_grid(n1, w, &grid);
 			}
 
-			/* Update the color mapping to combine the two colors */
-			fix_colors(colors, counts, color2, color, size);
+			/* Combine the two colors */
+			region_merge(r, color2, color);
 
 			/* We're done now */
 			break;
@@ -2003,55 +1864,51 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
 		 */
 		for (i = 0; i < 4; i++) {
 			int n2;
-			struct loc grid;
-			i_to_grid(n1, w, &grid);
 
 			/* Move to the adjacent square */
-			grid = loc_sum(grid, ddgrid_ddd[i]);
+			struct loc adj = loc_sum(grid, ddgrid_ddd[i]);
 
 			/* Make sure we stay inside the boundaries */
-			if (!square_in_bounds(c, grid)) continue;
+			if (!square_in_bounds(c, adj)) continue;
 
 			/* If the cell hasn't already been processed and we're
 			 * willing to include it, add it to the queue */
-			n2 = grid_to_i(grid, w);
+			n2 = grid_to_i(adj, w);
 			if (previous[n2] >= 0) continue;
-			if (square_isperm(c, grid)) continue;
-			if (square_isvault(c, grid) &&
+			if (square_isperm(c, adj)) continue;
+			if (square_isvault(c, adj) &&
 				!allow_vault_disconnect) continue;
-			q_push_int(queue, n2);
+			queue[tail++] = n2;
 			previous[n2] = n1;
 		}
 	}
 
-	/* Free the memory we've allocated */
-	q_free(queue);
-	mem_free(previous);
+	/* Unset only the squares we touched, ready for next time */
+	for (i = 0; i < tail; i++) previous[queue[i]] = -1;
 }
 
 
 /**
  * Start connecting regions, stopping when the cave is entirely connected.
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
+ * \param r is the labelling of the chunk's regions
  * \param allow_vault_disconnect will, if true, allows vaults to be included in
  * path planning which can leave regions disconnected
  */
-static void join_regions(struct chunk *c, int colors[], int counts[],
+static void join_regions(struct chunk *c, struct region_labels *r,
 		bool allow_vault_disconnect) {
-	int h = c->height;
-	int w = c->width;
-	int size = h * w;
-	int num = count_colors(counts, size);
+	int num = region_count(r);
+
+	event_signal_string(EVENT_GEN_LEVEL_PHASE, "connect");
 
-	/* While we have multiple colors (i.e. disconnected regions), join one
-	 * of the regions to another one.
+	/* While we have multiple colors (i.e. disconnected regions), join the
+	 * smallest of the regions to its nearest neighbour.  Flooding out from
+	 * a small region finds a neighbour much sooner than flooding out from
+	 * one which has already swallowed most of the level.
 	 */
 	while (num > 1) {
-		int color = first_color(counts, size);
-		join_region(c, colors, counts, color, -1,
-			allow_vault_disconnect);
+		int color = region_smallest(r);
+		join_region(c, r, color, -1, allow_vault_disconnect);
 		num--;
 	}
 }
@@ -2067,15 +1924,9 @@ static void join_regions(struct chunk *c, int colors[], int counts[],
  * information to join them into one conected region.
  */
 void ensure_connectedness(struct chunk *c, bool allow_vault_disconnect) {
-	int size = c->height * c->width;
-	int *colors = mem_zalloc(size * sizeof(int));
-	int *counts = mem_zalloc(size * sizeof(int));
+	struct region_labels *r = label_regions(c, square_isconnecting, true);
 
-	build_colors(c, colors, counts, NULL, true);
-	join_regions(c, colors, counts, allow_vault_disconnect);
-
-	mem_free(colors);
-	mem_free(counts);
+	join_regions(c, r, allow_vault_disconnect);
 }
 
 
@@ -2099,9 +1950,7 @@ static struct chunk *cavern_chunk(struct player *p, int h, int w,
 	int density = rand_range(25, 40);
 	int times = rand_range(3, 6);
 
-	int *colors = mem_zalloc(size * sizeof(int));
-	int *counts = mem_zalloc(size * sizeof(int));
-	bool *stairs = (join) ? mem_zalloc(size * sizeof(*stairs)) : NULL;
+	struct region_labels *r;
 	int tries;
 
 	struct chunk *c = cave_new(h, w);
@@ -2127,16 +1976,13 @@ static struct chunk *cavern_chunk(struct player *p, int h, int w,
 
 	/* If we couldn't make a big enough cavern then fail */
 	if (tries == MAX_CAVERN_TRIES) {
-		mem_free(colors);
-		mem_free(counts);
-		mem_free(stairs);
 		cave_free(c);
 		return NULL;
 	}
 
-	build_colors(c, colors, counts, stairs, false);
-	clear_small_regions(c, colors, counts, stairs);
-	join_regions(c, colors, counts, true);
+	r = label_regions(c, square_isconnecting, false);
+	clear_small_regions(c, r, join != NULL);
+	join_regions(c, r, true);
 
 	/* Convert the permanent rock walls near stairs back to granite. */
 	while (join) {
@@ -2150,10 +1996,6 @@ static struct chunk *cavern_chunk(struct player *p, int h, int w,
 		join = join->next;
 	}
 
-	mem_free(colors);
-	mem_free(counts);
-	mem_free(stairs);
-
 	return c;
 }
 
@@ -3489,34 +3331,26 @@ static struct chunk *vault_chunk(struct player *p)
 static void connect_caverns(struct chunk *c, struct loc floor[])
 {
 	int i;
-	int size = c->height * c->width;
-	int *colors = mem_zalloc(size * sizeof(int));
-	int *counts = mem_zalloc(size * sizeof(int));
+	struct region_labels *r;
 	int color_of_floor[4];
 
+	event_signal_string(EVENT_GEN_LEVEL_PHASE, "connect");
+
 	/* Color the regions, find which cavern is which color */
-	build_colors(c, colors, counts, NULL, true);
+	r = label_regions(c, square_isconnecting, true);
 	for (i = 0; i < 4; i++) {
-		int spot = grid_to_i(floor[i], c->width);
-		color_of_floor[i] = colors[spot];
+		color_of_floor[i] = region_of(r, floor[i]);
 	}
 
 	/* Join left and upper, right and lower */
-	join_region(c, colors, counts, color_of_floor[0], color_of_floor[1],
-		false);
-	join_region(c, colors, counts, color_of_floor[2], color_of_floor[3],
-		false);
+	join_region(c, r, color_of_floor[0], color_of_floor[1], false);
+	join_region(c, r, color_of_floor[2], color_of_floor[3], false);
 
 	/* Join the two big caverns */
 	for (i = 1; i < 3; i++) {
-		int spot = grid_to_i(floor[i], c->width);
-		color_of_floor[i] = colors[spot];
+		color_of_floor[i] = region_of(r, floor[i]);
 	}
-	join_region(c, colors, counts, color_of_floor[1], color_of_floor[2],
-		false);
-
-	mem_free(colors);
-	mem_free(counts);
+	join_region(c, r, color_of_floor[1], color_of_floor[2], false);
 }
 /**
  * Generate a hard centre level - a greater vault surrounded by caverns
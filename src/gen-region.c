@@ -0,0 +1,328 @@
+/**
+ * \file gen-region.c
+ * \brief Connected regions of a level under construction
+ *
+ * Several level builders need to know which open grids of a chunk can reach
+ * each other, so they can join up or throw away the pieces.  This used to be
+ * done with a flood fill started from each uncoloured grid in turn, each with
+ * its own level-sized queue and markers, and by repainting the whole level
+ * each time two regions were joined.
+ *
+ * Here the regions are labelled in two passes over the rows of the chunk.
+ * The first pass gives each open grid the label of an open neighbour it has
+ * already seen, noting in a union-find forest any labels that turn out to
+ * meet; the second gives every grid the final label of its set.  Regions
+ * joined later are merged in a second forest over the final labels, so no
+ * grids need repainting.  The buffers are kept from one level to the next.
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "cave.h"
+#include "generate.h"
+#include "init.h"
+
+/**
+ * The labels of the last chunk labelled, and the storage behind them
+ */
+static struct region_labels labels;
+static int labels_grids;
+static int *provisional;
+
+/**
+ * ------------------------------------------------------------------------
+ * Union-find
+ * ------------------------------------------------------------------------ */
+/**
+ * Find the label at the root of a set, shortening the way there as we go
+ */
+static int find_root(int *parent, int label)
+{
+	while (parent[label] != label) {
+		parent[label] = parent[parent[label]];
+		label = parent[label];
+	}
+	return label;
+}
+
+/**
+ * Put the sets with two provisional labels together
+ */
+static void join_provisional(int a, int b)
+{
+	a = find_root(provisional, a);
+	b = find_root(provisional, b);
+	if (a < b) {
+		provisional[b] = a;
+	} else if (b < a) {
+		provisional[a] = b;
+	}
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Labelling
+ * ------------------------------------------------------------------------ */
+/**
+ * Make sure the buffers have room for a chunk of the given number of grids
+ */
+static void labels_reserve(int grids)
+{
+	if (grids <= labels_grids) return;
+
+	/* Every other grid can start a region, so allow for one per grid */
+	labels_grids = grids;
+	labels.label = mem_realloc(labels.label, grids * sizeof(int));
+	labels.work = mem_realloc(labels.work, (grids + 1) * sizeof(int));
+	provisional = mem_realloc(provisional, (grids + 1) * sizeof(int));
+	labels.parent = mem_realloc(labels.parent, (grids + 1) * sizeof(int));
+	labels.size = mem_realloc(labels.size, (grids + 1) * sizeof(int));
+	labels.top_left = mem_realloc(labels.top_left,
+		(grids + 1) * sizeof(struct loc));
+	labels.bottom_right = mem_realloc(labels.bottom_right,
+		(grids + 1) * sizeof(struct loc));
+	labels.stairs = mem_realloc(labels.stairs, (grids + 1) * sizeof(bool));
+	labels.list = mem_realloc(labels.list, grids * sizeof(int));
+}
+
+/**
+ * Give a grid the provisional label of any open neighbour already seen
+ */
+static int label_from_neighbours(int i, struct loc grid, bool diagonal)
+{
+	int w = labels.width, found = 0, k;
+	int near[4];
+	int n = 0;
+
+	if (grid.x > 0) near[n++] = i - 1;
+	if (grid.y > 0) {
+		near[n++] = i - w;
+		if (diagonal && grid.x > 0) near[n++] = i - w - 1;
+		if (diagonal && grid.x < w - 1) near[n++] = i - w + 1;
+	}
+	for (k = 0; k < n; k++) {
+		int other = labels.label[near[k]];
+
+		if (!other) continue;
+		if (!found) {
+			found = other;
+		} else if (other != found) {
+			join_provisional(found, other);
+		}
+	}
+	return found;
+}
+
+/**
+ * Label the connected regions of open grids in a chunk.
+ *
+ * \param c is the chunk
+ * \param open says which grids belong to regions
+ * \param diagonal is whether grids which only touch diagonally are connected
+ * \return the labels, which last until the next call
+ *
+ * Regions are numbered from 1 in the order their first grids come in the
+ * chunk, reading along the rows from the top.
+ */
+struct region_labels *label_regions(struct chunk *c, square_predicate open,
+		bool diagonal)
+{
+	int size = c->height * c->width;
+	int next = 1, k;
+	struct loc grid;
+
+	labels_reserve(size);
+	labels.width = c->width;
+	labels.height = c->height;
+	labels.num = 0;
+
+	/* First pass: provisional labels, and which of them meet */
+	for (grid.y = 0; grid.y < c->height; grid.y++) {
+		for (grid.x = 0; grid.x < c->width; grid.x++) {
+			int i = grid_to_i(grid, c->width);
+			int label = 0;
+
+			if (open(c, grid)) {
+				label = label_from_neighbours(i, grid, diagonal);
+				if (!label) {
+					label = next++;
+					provisional[label] = label;
+				}
+			}
+			labels.label[i] = label;
+		}
+	}
+
+	/* Second pass: final labels, in order of first appearance */
+	memset(labels.work, 0, next * sizeof(int));
+	for (grid.y = 0; grid.y < c->height; grid.y++) {
+		for (grid.x = 0; grid.x < c->width; grid.x++) {
+			int i = grid_to_i(grid, c->width);
+			int root, label;
+
+			if (!labels.label[i]) continue;
+			root = find_root(provisional, labels.label[i]);
+			label = labels.work[root];
+			if (!label) {
+				label = ++labels.num;
+				labels.work[root] = label;
+				labels.parent[label] = label;
+				labels.size[label] = 0;
+				labels.top_left[label] = grid;
+				labels.bottom_right[label] = grid;
+				labels.stairs[label] = false;
+			}
+			labels.label[i] = label;
+			labels.size[label]++;
+			labels.top_left[label].x =
+				MIN(labels.top_left[label].x, grid.x);
+			labels.bottom_right[label].x =
+				MAX(labels.bottom_right[label].x, grid.x);
+			labels.bottom_right[label].y = grid.y;
+			if (square_isstairs(c, grid)) labels.stairs[label] = true;
+		}
+	}
+
+	/* Leave the workspace as callers expect to find it */
+	for (k = 0; k < size; k++) labels.work[k] = -1;
+	return &labels;
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Changing regions
+ * ------------------------------------------------------------------------ */
+/**
+ * Get the region a grid is in now, allowing for any merges; 0 means none
+ */
+int region_of(struct region_labels *r, struct loc grid)
+{
+	int label = r->label[grid_to_i(grid, r->width)];
+
+	return label ? find_root(r->parent, label) : 0;
+}
+
+static void region_stretch(struct region_labels *r, int region,
+		struct loc top_left, struct loc bottom_right)
+{
+	r->top_left[region].x = MIN(r->top_left[region].x, top_left.x);
+	r->top_left[region].y = MIN(r->top_left[region].y, top_left.y);
+	r->bottom_right[region].x = MAX(r->bottom_right[region].x,
+		bottom_right.x);
+	r->bottom_right[region].y = MAX(r->bottom_right[region].y,
+		bottom_right.y);
+}
+
+/**
+ * Move a grid into a region
+ */
+void region_add_grid(struct region_labels *r, struct loc grid, int region)
+{
+	int i = grid_to_i(grid, r->width);
+	int old = region_of(r, grid);
+
+	if (old == region) return;
+	if (old) r->size[old]--;
+	r->label[i] = region;
+	r->size[region]++;
+	region_stretch(r, region, grid, grid);
+}
+
+/**
+ * Take a grid out of whatever region it is in
+ */
+void region_remove_grid(struct region_labels *r, struct loc grid)
+{
+	int old = region_of(r, grid);
+
+	if (!old) return;
+	r->size[old]--;
+	r->label[grid_to_i(grid, r->width)] = 0;
+}
+
+/**
+ * Merge one region into another, so all its grids belong to the other
+ */
+void region_merge(struct region_labels *r, int from, int to)
+{
+	if (from == to) return;
+	r->parent[from] = to;
+	r->size[to] += r->size[from];
+	r->size[from] = 0;
+	r->stairs[to] = r->stairs[to] || r->stairs[from];
+	region_stretch(r, to, r->top_left[from], r->bottom_right[from]);
+}
+
+/**
+ * Count the regions which still have grids in them
+ */
+int region_count(struct region_labels *r)
+{
+	int region, num = 0;
+
+	for (region = 1; region <= r->num; region++) {
+		if (r->size[region] > 0) num++;
+	}
+	return num;
+}
+
+/**
+ * Get the lowest numbered region which still has grids in it, or 0
+ */
+int region_first(struct region_labels *r)
+{
+	int region;
+
+	for (region = 1; region <= r->num; region++) {
+		if (r->size[region] > 0) return region;
+	}
+	return 0;
+}
+
+/**
+ * Get the smallest region which still has grids in it, or 0; of regions the
+ * same size, the lowest numbered
+ */
+int region_smallest(struct region_labels *r)
+{
+	int region, best = 0;
+
+	for (region = 1; region <= r->num; region++) {
+		if (r->size[region] <= 0) continue;
+		if (!best || r->size[region] < r->size[best]) best = region;
+	}
+	return best;
+}
+
+static void cleanup_region_labels(void)
+{
+	mem_free(labels.label);
+	mem_free(labels.work);
+	mem_free(provisional);
+	mem_free(labels.parent);
+	mem_free(labels.size);
+	mem_free(labels.top_left);
+	mem_free(labels.bottom_right);
+	mem_free(labels.stairs);
+	mem_free(labels.list);
+	memset(&labels, 0, sizeof(labels));
+	provisional = NULL;
+	labels_grids = 0;
+}
+
+struct init_module region_module = {
+	.name = "generate regions",
+	.cleanup = cleanup_region_labels
+};
@@ -3786,6 +3786,7 @@ bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 
 	struct loc centre;
 
+	event_signal_string(EVENT_GEN_LEVEL_PHASE, "rooms");
 	event_signal_string(EVENT_GEN_ROOM_START, profile.name);
 	/* Enforce the room profile's minimum depth */
 	if (c->depth < profile.level) {
@@ -446,6 +446,8 @@ bool new_player_spot(struct chunk *c, struct player *p)
 {
 	struct loc grid;
 
+	event_signal_string(EVENT_GEN_LEVEL_PHASE, "populate");
+
 	/* Try to find a good place to put the player */
 	if (OPT(p, birth_levels_persist) &&
 			square_in_bounds_fully(c, p->grid) &&
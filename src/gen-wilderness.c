@@ -22,6 +22,7 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "game-event.h"
 #include "game-world.h"
 #include "generate.h"
 #include "init.h"
@@ -725,6 +726,8 @@ static int populate(struct chunk *c, bool valley)
 	/* Basic "amount" */
 	int k = (c->depth / 2);
 
+	event_signal_string(EVENT_GEN_LEVEL_PHASE, "populate");
+
 	if (valley) {
 		if (k > 30)
 			k = 30;
@@ -1393,6 +1396,7 @@ struct chunk *mtntop_gen(struct player *p, int height, int width,
 
 	/* Basic "amount" */
 	k = c->depth;
+	event_signal_string(EVENT_GEN_LEVEL_PHASE, "populate");
 
 	/* Build the monster probability table. */
 	(void) get_mon_num(c->depth, c->depth);
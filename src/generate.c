@@ -37,6 +37,7 @@
 #include "init.h"
 #include "mon-make.h"
 #include "mon-move.h"
+#include "mon-sched.h"
 #include "mon-spell.h"
 #include "monster.h"
 #include "obj-tval.h"
@@ -55,6 +56,7 @@ struct vault *themed_levels;
 static struct cave_profile *cave_profiles;
 struct dun_data *dun;
 struct room_template *room_templates;
+bool level_guessing;
 
 static const struct {
 	const char *name;
@@ -76,6 +78,19 @@ static const struct {
 	#undef ROOM
 };
 
+/**
+ * The phases of building a level, in the order builders usually go through
+ * them; builders say when they move on to one with EVENT_GEN_LEVEL_PHASE, and
+ * each level starts in the first
+ */
+static const char *level_phases[] = {
+	"layout",
+	"rooms",
+	"tunnels",
+	"connect",
+	"populate"
+};
+
 static const char *room_flags[] = {
 	"NONE",
 	#define ROOMF(a, b) #a,
@@ -1591,11 +1606,13 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 				msg("Generation restarted: %s.", error);
 			}
 			cleanup_dun_data(dun);
+			event_signal_string(EVENT_GEN_LEVEL_FAIL, error);
 			event_signal_flag(EVENT_GEN_LEVEL_END, false);
 			continue;
 		}
 
 		/* Ensure quest monsters */
+		event_signal_string(EVENT_GEN_LEVEL_PHASE, "populate");
 		if (quest && !quest->complete) {
 			struct monster_race *race = quest->race;
 			struct monster_group_info info = { 0, 0, 0 };
@@ -1643,12 +1660,17 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 				msg("Generation restarted: %s.", error);
 			}
 
-			/* Clear the monsters */
-			wipe_mon_list(chunk, p);
+			/* Clear the monsters, sparing the current level's if guessing */
+			if (level_guessing) {
+				wipe_mon_chunk(chunk, p);
+			} else {
+				wipe_mon_list(chunk, p);
+			}
 
 			/* Free the chunk */
 			uncreate_artifacts(chunk);
 			cave_free(chunk);
+			event_signal_string(EVENT_GEN_LEVEL_FAIL, error);
 			event_signal_flag(EVENT_GEN_LEVEL_END, false);
 		}
 
@@ -1691,6 +1713,201 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 	return chunk;
 }
 
+/**
+ * ------------------------------------------------------------------------
+ * Speculative generation
+ * ------------------------------------------------------------------------ */
+/**
+ * A level made ahead of time for the far end of the stairs or path the player
+ * is standing on.  It is made with the player set up just as taking the
+ * stairs would leave them, and everything generation changes is then put
+ * back, so the guess can be handed over whole if the player does take the
+ * stairs, or thrown away if they go anywhere else.
+ *
+ * While a guess is held its uniques and artifacts count as existing, so the
+ * current level can't make them, and uniques and artifacts on the current
+ * level can't appear in the guess.  Player ghosts are never put in a guess,
+ * as there is only one ghost record, which belongs to the current level.
+ * Only non-persistent levels other than towns and arenas are guessed at.
+ */
+static struct level_guess {
+	struct chunk *chunk;		/* The level, or NULL for no guess */
+	struct chunk *known;		/* The player's (empty) map of it */
+
+	/* Where the player stood, and what the level was made for */
+	int from_place;
+	struct loc from;
+	int place, last_place;
+	int create_stair, path_coord;
+	int themed_level;
+
+	/* What making the level did to the player */
+	struct loc grid;
+	int new_create_stair, new_path_coord;
+	bool light_level;
+	int new_themed_level;
+	uint32_t themed_level_appeared;
+	int num_traps;
+} guess;
+
+/**
+ * Throw away any level made ahead of time
+ */
+void level_guess_forget(struct player *p)
+{
+	if (!guess.chunk) return;
+	wipe_mon_chunk(guess.chunk, p);
+	uncreate_artifacts(guess.chunk);
+	cave_free(guess.chunk);
+	cave_free(guess.known);
+	guess.chunk = NULL;
+	guess.known = NULL;
+}
+
+/**
+ * Get the place the stairs or path the player is on lead to, if it is worth
+ * making the level there ahead of time, or -1
+ */
+static int level_guess_place(struct player *p, int feat)
+{
+	int place;
+
+	if (OPT(p, birth_levels_persist) || p->upkeep->arena_level) return -1;
+	if (!square_isstairs(cave, p->grid) && !square_ispath(cave, p->grid)) {
+		return -1;
+	}
+	if (square_isdownstairs(cave, p->grid)
+			&& p->depth == z_info->max_depth - 1) {
+		return -1;
+	}
+
+	/* Dungeon-only games have magic portals instead of some up stairs */
+	if (feat == FEAT_LESS && streq(world->name, "Hybrid Dungeon")) {
+		return -1;
+	}
+
+	/* Underworld and mountaintop levels are edited when entered */
+	place = player_stairs_place(p, feat);
+	if (place < 0 || place == p->place || !world->levels[place].depth) {
+		return -1;
+	}
+	if (world->levels[place].locality == LOC_UNDERWORLD
+			|| world->levels[place].locality == LOC_MOUNTAIN_TOP
+			|| world->levels[p->place].locality == LOC_UNDERWORLD
+			|| world->levels[p->place].locality == LOC_MOUNTAIN_TOP) {
+		return -1;
+	}
+	return place;
+}
+
+/**
+ * Make the level at the far end of the stairs or path the player is standing
+ * on, if the player wants levels made ahead of time and there isn't one
+ * already.  Any guess made from somewhere else is thrown away.
+ *
+ * The level is made from a random number stream of its own, so the game goes
+ * on exactly as it would have without the guess.  It ends with
+ * EVENT_GEN_LEVEL_GUESSED; EVENT_GEN_LEVEL_END is only sent for it when the
+ * player arrives and it is used.
+ */
+void level_speculate(struct player *p)
+{
+	struct player saved_player = *p;
+	struct player_upkeep saved_upkeep = *p->upkeep;
+	bool saved_quick = Rand_quick, saved_dungeon = character_dungeon;
+	uint32_t saved_value = Rand_value, saved_i = state_i;
+	uint32_t saved_state[RAND_DEG];
+	int feat, place;
+
+	if (!character_dungeon || !OPT(p, speculate_levels)) {
+		level_guess_forget(p);
+		return;
+	}
+	feat = square_feat(cave, p->grid)->fidx;
+	if (guess.chunk) {
+		if (guess.from_place == p->place && loc_eq(guess.from, p->grid)) {
+			return;
+		}
+		level_guess_forget(p);
+	}
+	place = level_guess_place(p, feat);
+	if (place < 0) return;
+
+	/* Fork the random number stream without moving it on */
+	memcpy(saved_state, STATE, sizeof(STATE));
+	Rand_quick = false;
+	Rand_state_init(STATE[state_i] ^ Rand_value ^ (uint32_t) turn);
+
+	/* Set the player up as taking the stairs would */
+	guess.from_place = p->place;
+	guess.from = p->grid;
+	player_set_way_back(p, feat);
+	p->last_place = p->place;
+	p->place = place;
+	p->depth = world->levels[place].depth;
+	p->num_traps = 0;
+	guess.place = p->place;
+	guess.last_place = p->last_place;
+	guess.create_stair = p->upkeep->create_stair;
+	guess.path_coord = p->upkeep->path_coord;
+	guess.themed_level = p->themed_level;
+
+	level_guessing = true;
+	guess.chunk = cave_generate(p, 0, 0);
+	level_guessing = false;
+	event_signal(EVENT_GEN_LEVEL_GUESSED);
+	guess.known = p->cave;
+	guess.grid = p->grid;
+	guess.new_create_stair = p->upkeep->create_stair;
+	guess.new_path_coord = p->upkeep->path_coord;
+	guess.light_level = p->upkeep->light_level;
+	guess.new_themed_level = p->themed_level;
+	guess.themed_level_appeared = p->themed_level_appeared;
+	guess.num_traps = p->num_traps;
+
+	/* Put everything back */
+	*p->upkeep = saved_upkeep;
+	*p = saved_player;
+	character_dungeon = saved_dungeon;
+	Rand_quick = saved_quick;
+	Rand_value = saved_value;
+	state_i = saved_i;
+	memcpy(STATE, saved_state, sizeof(STATE));
+}
+
+/**
+ * Use the level made ahead of time if it was made for where the player is
+ * going, and otherwise throw it away
+ *
+ * \return whether the level was used
+ */
+static bool level_guess_take(struct player *p)
+{
+	if (!guess.chunk) return false;
+	if (guess.place != p->place || guess.last_place != p->last_place
+			|| guess.create_stair != p->upkeep->create_stair
+			|| guess.path_coord != p->upkeep->path_coord
+			|| guess.themed_level != p->themed_level) {
+		level_guess_forget(p);
+		return false;
+	}
+
+	/* Hand the level over */
+	cave = guess.chunk;
+	p->cave = guess.known;
+	p->grid = guess.grid;
+	p->upkeep->create_stair = guess.new_create_stair;
+	p->upkeep->path_coord = guess.new_path_coord;
+	p->upkeep->light_level = guess.light_level;
+	p->themed_level = guess.new_themed_level;
+	p->themed_level_appeared = guess.themed_level_appeared;
+	p->num_traps = guess.num_traps;
+	cave->turn = turn;
+	guess.chunk = NULL;
+	guess.known = NULL;
+	return true;
+}
+
 /**
  * Prepare the level the player is about to enter, either by generating
  * or reloading
@@ -1707,10 +1924,18 @@ void prepare_next_level(struct player *p)
 			  sizeof(prev_name));
 	my_strcpy(new_name, level_name(&world->levels[p->place]), sizeof(new_name));
 
+	/* Levels made ahead of time are only kept for non-persistent levels */
+	if (persist) {
+		level_guess_forget(p);
+	}
+
 	/* Deal with any existing current level */
 	if (character_dungeon) {
 		assert (p->cave);
 
+		/* Bring the monsters' energy up to date */
+		mon_sched_flush(cave);
+
 		if (persist) {
 			/* Arenas don't get stored */
 			if (!cave->name || !streq(cave->name, "arena")) {
@@ -1830,6 +2055,9 @@ void prepare_next_level(struct player *p)
 			cave = cave_generate(p, min_height, min_width);
 			event_signal_flag(EVENT_GEN_LEVEL_END, true);
 		}
+	} else if (level_guess_take(p)) {
+		/* The level made ahead of time is only finished with now */
+		event_signal_flag(EVENT_GEN_LEVEL_END, true);
 	} else {
 		/* Just generate a new level */
 		cave = cave_generate(p, 0, 0);
@@ -1887,6 +2115,37 @@ const char *get_room_builder_name_from_index(int i)
 		room_builders[i].name : NULL;
 }
 
+/**
+ * Return the number of phases of level building.
+ */
+int get_level_phase_count(void)
+{
+	return (int) N_ELEMENTS(level_phases);
+}
+
+/**
+ * Convert the name of a phase of level building into its index.  Return -1
+ * if the name does not match any of the phases.
+ */
+int get_level_phase_index_from_name(const char *name)
+{
+	int i;
+
+	for (i = 0; i < get_level_phase_count(); i++) {
+		if (streq(name, level_phases[i])) return i;
+	}
+	return -1;
+}
+
+/**
+ * Get the name of a phase of level building given its index.  Return NULL if
+ * the index is out of bounds.
+ */
+const char *get_level_phase_name_from_index(int i)
+{
+	return (i >= 0 && i < get_level_phase_count()) ? level_phases[i] : NULL;
+}
+
 /**
  * Convert the name of a level profile into its index in the cave_profiles
  * list.  Return -1 if the name does not match any of the profiles.
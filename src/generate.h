@@ -300,6 +300,22 @@ struct room_template {
     uint8_t tval;		/*!< tval for objects in this room */
 };
 
+/**
+ * The connected regions of a chunk, as labelled by label_regions()
+ */
+struct region_labels {
+	int width, height;		/*!< Size of the chunk labelled */
+	int *label;			/*!< Label of each grid, 0 for none; use region_of() */
+	int num;			/*!< Regions are numbered from 1 to num */
+	int *parent;		/*!< Region each region was merged into */
+	int *size;			/*!< Number of grids in each region */
+	struct loc *top_left;	/*!< Bounding box of each region */
+	struct loc *bottom_right;
+	bool *stairs;		/*!< Whether each region has a staircase */
+	int *work;			/*!< One int per grid for callers, left all -1 */
+	int *list;			/*!< Room for a list of every grid, for callers */
+};
+
 /**
  * Constants for working with random symmetry transforms
  */
@@ -313,14 +329,20 @@ extern struct dun_data *dun;
 extern struct vault *vaults;
 extern struct vault *themed_levels;
 extern struct room_template *room_templates;
+extern bool level_guessing;
 
 /* generate.c */
+void level_guess_forget(struct player *p);
+void level_speculate(struct player *p);
 void prepare_next_level(struct player *p);
 int get_room_builder_count(void);
 int get_room_builder_index_from_name(const char *name);
 const char *get_room_builder_name_from_index(int i);
 int get_level_profile_index_from_name(const char *name);
 const char *get_level_profile_name_from_index(int i);
+int get_level_phase_count(void);
+int get_level_phase_index_from_name(const char *name);
+const char *get_level_phase_name_from_index(int i);
 
 /* gen-cave.c */
 struct chunk *town_gen(struct player *p, int min_height, int min_width,
@@ -383,6 +405,17 @@ bool chunk_copy(struct chunk *dest, struct player *p, struct chunk *source,
 void chunk_validate_objects(struct chunk *c);
 
 
+/* gen-region.c */
+struct region_labels *label_regions(struct chunk *c, square_predicate open,
+	bool diagonal);
+int region_of(struct region_labels *r, struct loc grid);
+void region_add_grid(struct region_labels *r, struct loc grid, int region);
+void region_remove_grid(struct region_labels *r, struct loc grid);
+void region_merge(struct region_labels *r, int from, int to);
+int region_count(struct region_labels *r);
+int region_first(struct region_labels *r);
+int region_smallest(struct region_labels *r);
+
 /* gen-room.c */
 void fill_rectangle(struct chunk *c, int y1, int x1, int y2, int x2, int feat,
 					int flag);
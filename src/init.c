@@ -2404,6 +2404,7 @@ static void cleanup_feat(void) {
 		string_free(f_info[idx].name);
 	}
 	mem_free(f_info);
+	feat_index_free();
 }
 
 struct file_parser feat_parser = {
@@ -4694,11 +4695,15 @@ static struct init_module arrays_module = {
 
 extern struct init_module z_quark_module;
 extern struct init_module generate_module;
+extern struct init_module region_module;
 extern struct init_module rune_module;
 extern struct init_module obj_make_module;
 extern struct init_module ignore_module;
 extern struct init_module mon_make_module;
 extern struct init_module player_module;
+extern struct init_module project_module;
+extern struct init_module effects_module;
+extern struct init_module path_module;
 extern struct init_module store_module;
 extern struct init_module messages_module;
 extern struct init_module options_module;
@@ -4712,6 +4717,10 @@ static struct init_module *modules[] = {
 	&arrays_module,
 	&player_module,
 	&generate_module,
+	&region_module,
+	&project_module,
+	&effects_module,
+	&path_module,
 	&rune_module,
 	&obj_make_module,
 	&ignore_module,
@@ -4771,7 +4780,8 @@ void cleanup_angband(void)
 {
 	int i;
 
-	/* Free the chunk list */
+	/* Free any level made ahead of time, and the chunk list */
+	level_guess_forget(player);
 	for (i = 0; i < chunk_list_max; i++) {
 		wipe_mon_list(chunk_list[i], player);
 		cave_free(chunk_list[i]);
@@ -4804,6 +4814,9 @@ void cleanup_angband(void)
 	/* Free the format() buffer */
 	vformat_kill();
 
+	/* Free the textblocks kept for reuse */
+	textblock_cleanup();
+
 	/* Free the directories */
 	string_free(ANGBAND_DIR_GAMEDATA);
 	string_free(ANGBAND_DIR_CUSTOMIZE);
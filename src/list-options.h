@@ -55,6 +55,8 @@ OP(notify_recharge,       "Notify on object recharge",
 INTERFACE, false)
 OP(effective_speed,       "Show effective speed as multiplier",
 INTERFACE, false)
+OP(speculate_levels,      "Make the level beyond stairs while waiting",
+INTERFACE, false)
 OP(cheat_hear,            "Cheat: Peek into monster creation",
 CHEAT, false)
 OP(score_hear,            "Score: Peek into monster creation",
@@ -9,56 +9,56 @@
  */
 
 /* symbol		flag_redraw						flag_update */
-TMD(FAST,		PR_STATUS,						PU_BONUS)
-TMD(SLOW,		PR_STATUS,								PU_BONUS)
+TMD(FAST,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(SLOW,		PR_STATUS,								PU_BONUS_QUICK)
 TMD(BLIND,		PR_MAP,							PU_UPDATE_VIEW | PU_MONSTERS) 
-TMD(PARALYZED,	PR_STATUS,						PU_BONUS)
-TMD(CONFUSED,	PR_STATUS,						PU_BONUS)
-TMD(AFRAID,		PR_STATUS,						PU_BONUS)
-TMD(IMAGE,		PR_MAP | PR_MONLIST | PR_ITEMLIST,	PU_BONUS)
-TMD(POISONED,	PR_STATUS,						PU_BONUS)
-TMD(CUT,		PR_STATUS,						PU_BONUS)
-TMD(STUN,		PR_STATUS,						PU_BONUS)
-TMD(FOOD,		PR_STATUS,						PU_BONUS)
-TMD(PROTEVIL,	PR_STATUS,						PU_BONUS)
-TMD(INVULN,		PR_STATUS,						PU_BONUS)
-TMD(HERO,		PR_STATUS,						PU_BONUS)
-TMD(SHERO,		PR_STATUS,						PU_BONUS)
-TMD(SHIELD,		PR_STATUS,						PU_BONUS)
-TMD(BLESSED,	PR_STATUS,						PU_BONUS)
-TMD(SINVIS,		PR_STATUS,						PU_BONUS | PU_MONSTERS)
-TMD(SINFRA,		PR_STATUS,						PU_BONUS | PU_MONSTERS)
-TMD(OPP_ACID,	PR_STATUS,						PU_BONUS)
-TMD(OPP_ELEC,	PR_STATUS,						PU_BONUS)
-TMD(OPP_FIRE,	PR_STATUS,						PU_BONUS)
-TMD(OPP_COLD,	PR_STATUS,						PU_BONUS)
-TMD(OPP_POIS,	PR_STATUS,						PU_BONUS)
-TMD(OPP_CONF,	PR_STATUS,						PU_BONUS)
-TMD(AMNESIA,	PR_STATUS,						PU_BONUS)
-TMD(TELEPATHY,	PR_STATUS,						PU_BONUS)
-TMD(STONESKIN,	PR_STATUS,						PU_BONUS)
-TMD(TERROR,		PR_STATUS,						PU_BONUS)
-TMD(SPRINT,		PR_STATUS,						PU_BONUS)
-TMD(BOLD,		PR_STATUS,						PU_BONUS)
-TMD(SCRAMBLE,   PR_STATUS,		   				PU_BONUS)
-TMD(TRAPSAFE,	PR_STATUS,						PU_BONUS)
-TMD(FASTCAST,	PR_STATUS,						PU_BONUS)
-TMD(ATT_ACID,	PR_STATUS,						PU_BONUS)
-TMD(ATT_ELEC,	PR_STATUS,						PU_BONUS)
-TMD(ATT_FIRE,	PR_STATUS,						PU_BONUS)
-TMD(ATT_COLD,	PR_STATUS,						PU_BONUS)
-TMD(ATT_POIS,	PR_STATUS,						PU_BONUS)
-TMD(ATT_CONF,	PR_STATUS,						PU_BONUS)
-TMD(ATT_EVIL,	PR_STATUS,						PU_BONUS)
-TMD(ATT_DEMON,	PR_STATUS,						PU_BONUS)
-TMD(ATT_VAMP,	PR_STATUS,						PU_BONUS)
-TMD(HEAL,		PR_STATUS,						PU_BONUS)
-TMD(COMMAND,	PR_STATUS,						PU_BONUS)
-TMD(ATT_RUN,	PR_STATUS,						PU_BONUS)
-TMD(COVERTRACKS,PR_STATUS,						PU_BONUS)
-TMD(POWERSHOT,	PR_STATUS,						PU_BONUS)
-TMD(TAUNT,		PR_STATUS,						PU_BONUS)
-TMD(BLOODLUST,	PR_STATUS,						PU_BONUS)
-TMD(BLACKBREATH,PR_STATUS,						PU_BONUS)
-TMD(STEALTH,	PR_STATUS,						PU_BONUS)
-TMD(FREE_ACT,	PR_STATUS,						PU_BONUS)
+TMD(PARALYZED,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(CONFUSED,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(AFRAID,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(IMAGE,		PR_MAP | PR_MONLIST | PR_ITEMLIST,	PU_BONUS_QUICK)
+TMD(POISONED,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(CUT,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(STUN,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(FOOD,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(PROTEVIL,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(INVULN,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(HERO,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(SHERO,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(SHIELD,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(BLESSED,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(SINVIS,		PR_STATUS,						PU_BONUS_QUICK | PU_MONSTERS)
+TMD(SINFRA,		PR_STATUS,						PU_BONUS_QUICK | PU_MONSTERS)
+TMD(OPP_ACID,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(OPP_ELEC,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(OPP_FIRE,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(OPP_COLD,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(OPP_POIS,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(OPP_CONF,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(AMNESIA,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(TELEPATHY,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(STONESKIN,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(TERROR,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(SPRINT,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(BOLD,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(SCRAMBLE,   PR_STATUS,		   				PU_BONUS_QUICK)
+TMD(TRAPSAFE,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(FASTCAST,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(ATT_ACID,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(ATT_ELEC,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(ATT_FIRE,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(ATT_COLD,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(ATT_POIS,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(ATT_CONF,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(ATT_EVIL,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(ATT_DEMON,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(ATT_VAMP,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(HEAL,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(COMMAND,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(ATT_RUN,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(COVERTRACKS,PR_STATUS,						PU_BONUS_QUICK)
+TMD(POWERSHOT,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(TAUNT,		PR_STATUS,						PU_BONUS_QUICK)
+TMD(BLOODLUST,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(BLACKBREATH,PR_STATUS,						PU_BONUS_QUICK)
+TMD(STEALTH,	PR_STATUS,						PU_BONUS_QUICK)
+TMD(FREE_ACT,	PR_STATUS,						PU_BONUS_QUICK)
@@ -1334,7 +1334,7 @@ int rd_gear(void)
 /**
  * Read store contents
  */
-static int rd_stores_aux(rd_item_t rd_item_version)
+static int rd_stores_aux(rd_item_t rd_item_version, bool read_owed)
 {
 	int i;
 	uint16_t tmp16u;
@@ -1356,6 +1356,10 @@ static int rd_stores_aux(rd_item_t rd_item_version)
 			/* Read the basic info */
 			rd_byte(&own);
 			rd_byte(&num);
+			store->days_owed = 0;
+			if (read_owed) {
+				rd_u16b(&store->days_owed);
+			}
 
 			/* XXX: refactor into store.c */
 			store->owner = store_ownerbyidx(store, own);
@@ -1399,7 +1403,8 @@ static int rd_stores_aux(rd_item_t rd_item_version)
 /**
  * Read the stores - wrapper functions
  */
-int rd_stores(void) { return rd_stores_aux(rd_item); }
+int rd_stores(void) { return rd_stores_aux(rd_item, false); }
+int rd_stores_2(void) { return rd_stores_aux(rd_item, true); }
 
 
 /**
@@ -0,0 +1,924 @@
+/**
+ * \file main-bench.c
+ * \brief Headless front end which times a fixed piece of play
+ *
+ * The benchmark births the same character from the same seed every time,
+ * then follows a script of simple commands (taking the way on, exploring,
+ * running, filling the level with monsters and casting at them, resting),
+ * pushing the matching game commands and running the game loop after each.
+ * The script is split into named phases, and for each phase it reports the
+ * time taken along with counts of what the game did, so the same build run
+ * twice should do exactly the same work, and two builds can be compared.
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+
+#ifdef USE_BENCH
+
+#include "cave.h"
+#include "cmd-core.h"
+#include "cmd-record.h"
+#include "game-event.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "main.h"
+#include "mon-lore.h"
+#include "mon-make.h"
+#include "obj-info.h"
+#include "obj-knowledge.h"
+#include "obj-make.h"
+#include "obj-pile.h"
+#include "obj-tval.h"
+#include "player-birth.h"
+#include "player-calcs.h"
+#include "player-spell.h"
+#include "player-timed.h"
+#include "player-util.h"
+#include "project.h"
+#include "savefile.h"
+#include "source.h"
+#include "store.h"
+#include "target.h"
+#include "ui-game.h"
+#include "ui-mon-lore.h"
+#include "z-profile.h"
+#include <time.h>
+
+/**
+ * The script followed when none is given
+ */
+static const char *default_script[] = {
+	"level 25",
+	"phase breathe",
+	"breathe 500",
+	"phase descend",
+	"descend 12",
+	"phase explore",
+	"explore 60",
+	"phase run",
+	"run 6 8",
+	"run 2 8",
+	"run 4 8",
+	"run 8 8",
+	"phase crowd",
+	"crowd 60",
+	"cast Magic Missile 40",
+	"cast Fire Ball 40",
+	"phase rest",
+	"rest 200",
+	"phase describe",
+	"describe 5",
+	"phase away",
+	"away 1000",
+	NULL
+};
+
+/**
+ * What is counted for each phase of the script
+ */
+struct bench_counts {
+	double seconds;			/* Time taken */
+	double gen_seconds;		/* Time spent making levels */
+	int32_t turns;			/* Game turns */
+	int32_t moves;			/* Times the player moved */
+	int32_t levels;			/* Levels made */
+	int32_t tries;			/* Attempts at making a level */
+	int32_t casts;			/* Spells cast */
+	int32_t texts;			/* Recalls and descriptions made */
+};
+
+struct bench_phase {
+	char *name;
+	struct bench_counts counts;
+};
+
+/**
+ * Time spent in each phase of level generation, over the whole script
+ */
+struct bench_gen_phase {
+	char *name;
+	double seconds;
+};
+
+static uint32_t seed = 0x0be4c4;
+static const char *race_name = NULL;
+static const char *class_name = "Mage";
+static const char *script_path = NULL;
+static const char *replay_path = NULL;
+static bool quiet = false;
+
+static struct bench_phase *phases;
+static int phase_num, phase_max;
+static struct bench_counts counts;
+static int32_t phase_start_turn;
+static double phase_start;
+
+static struct bench_gen_phase *gen_phases;
+static int gen_phase_num, gen_phase_max;
+static int gen_phase_current = -1;
+static double gen_phase_start, gen_level_start, gen_guess_seconds;
+
+/**
+ * ------------------------------------------------------------------------
+ * Timing and counting
+ * ------------------------------------------------------------------------ */
+/**
+ * Get the wall clock time in seconds, from some fixed start
+ */
+static double bench_now(void)
+{
+#ifdef CLOCK_MONOTONIC
+	struct timespec now;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &now) == 0) {
+		return now.tv_sec + now.tv_nsec / 1e9;
+	}
+#endif
+	return (double) clock() / CLOCKS_PER_SEC;
+}
+
+static void bench_gen_phase_end(double now)
+{
+	if (gen_phase_current >= 0) {
+		gen_phases[gen_phase_current].seconds += now - gen_phase_start;
+		gen_phase_current = -1;
+	}
+}
+
+static void bench_gen_phase_begin(const char *name, double now)
+{
+	int i;
+
+	bench_gen_phase_end(now);
+	for (i = 0; i < gen_phase_num; i++) {
+		if (streq(gen_phases[i].name, name)) break;
+	}
+	if (i == gen_phase_num) {
+		if (gen_phase_num == gen_phase_max) {
+			gen_phase_max = gen_phase_max ? 2 * gen_phase_max : 8;
+			gen_phases = mem_realloc(gen_phases,
+				gen_phase_max * sizeof(*gen_phases));
+		}
+		gen_phases[i].name = string_make(name);
+		gen_phases[i].seconds = 0.0;
+		gen_phase_num++;
+	}
+	gen_phase_current = i;
+	gen_phase_start = now;
+}
+
+static void bench_gen_start(game_event_type type, game_event_data *data,
+		void *user)
+{
+	double now = bench_now();
+
+	counts.tries++;
+	if (gen_level_start < 0.0) gen_level_start = now;
+
+	/* Each try starts in the first phase, whatever the builder */
+	bench_gen_phase_begin("layout", now);
+}
+
+static void bench_gen_phase(game_event_type type, game_event_data *data,
+		void *user)
+{
+	bench_gen_phase_begin(data->string ? data->string : "unknown",
+		bench_now());
+}
+
+static void bench_gen_end(game_event_type type, game_event_data *data,
+		void *user)
+{
+	double now = bench_now();
+
+	bench_gen_phase_end(now);
+	if (!data->flag) return;
+	counts.levels++;
+
+	/* A level made ahead of time took what it took to make */
+	if (gen_level_start < 0.0) {
+		counts.gen_seconds += gen_guess_seconds;
+	} else {
+		counts.gen_seconds += now - gen_level_start;
+	}
+	gen_level_start = -1.0;
+}
+
+static void bench_gen_guessed(game_event_type type, game_event_data *data,
+		void *user)
+{
+	double now = bench_now();
+
+	/* Only count it as a level if the player goes there */
+	bench_gen_phase_end(now);
+	gen_guess_seconds = now - gen_level_start;
+	gen_level_start = -1.0;
+}
+
+static void bench_moved(game_event_type type, game_event_data *data,
+		void *user)
+{
+	counts.moves++;
+}
+
+/**
+ * Finish the current phase of the script, if any, and start another
+ */
+static void bench_phase_begin(const char *name)
+{
+	double now = bench_now();
+
+	if (phase_num) {
+		struct bench_phase *last = &phases[phase_num - 1];
+
+		last->counts = counts;
+		last->counts.seconds = now - phase_start;
+		last->counts.turns = turn - phase_start_turn;
+	}
+	if (!name) return;
+
+	if (phase_num == phase_max) {
+		phase_max = phase_max ? 2 * phase_max : 8;
+		phases = mem_realloc(phases, phase_max * sizeof(*phases));
+	}
+	phases[phase_num].name = string_make(name);
+	memset(&phases[phase_num].counts, 0, sizeof(counts));
+	phase_num++;
+	memset(&counts, 0, sizeof(counts));
+	phase_start = now;
+	phase_start_turn = turn;
+}
+
+static void bench_report_line(const char *name, const struct bench_counts *c)
+{
+	printf("%-12s %10.1f %8ld %8ld %7ld %7ld %10.1f %7ld %7ld\n", name,
+		c->seconds * 1000.0, (long) c->turns, (long) c->moves,
+		(long) c->levels, (long) c->tries, c->gen_seconds * 1000.0,
+		(long) c->casts, (long) c->texts);
+}
+
+static void bench_report(void)
+{
+	struct bench_counts total;
+	struct profile_counter *pc;
+	int i;
+
+	memset(&total, 0, sizeof(total));
+	printf("%-12s %10s %8s %8s %7s %7s %10s %7s %7s\n", "phase", "ms",
+		"turns", "moves", "levels", "tries", "gen ms", "casts", "texts");
+	for (i = 0; i < phase_num; i++) {
+		const struct bench_counts *c = &phases[i].counts;
+
+		bench_report_line(phases[i].name, c);
+		total.seconds += c->seconds;
+		total.gen_seconds += c->gen_seconds;
+		total.turns += c->turns;
+		total.moves += c->moves;
+		total.levels += c->levels;
+		total.tries += c->tries;
+		total.casts += c->casts;
+		total.texts += c->texts;
+	}
+	bench_report_line("total", &total);
+
+	printf("\n%-12s %10s\n", "generation", "ms");
+	for (i = 0; i < gen_phase_num; i++) {
+		printf("%-12s %10.1f\n", gen_phases[i].name,
+			gen_phases[i].seconds * 1000.0);
+	}
+
+	/* What the performance counters saw, if they are built in */
+	if (!profile_counters()) return;
+	printf("\n%-16s %10s %10s %10s %12s\n", "counter", "calls", "ms",
+		"max us", "work per call");
+	for (pc = profile_counters(); pc; pc = pc->next) {
+		printf("%-16s %10lu %10.1f %10.1f %12.1f %s\n", pc->name,
+			(unsigned long) pc->total.calls,
+			pc->total.ns / 1000000.0, pc->total.max_ns / 1000.0,
+			pc->total.calls ?
+			(double) pc->total.work / pc->total.calls : 0.0,
+			pc->unit);
+	}
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Playing
+ * ------------------------------------------------------------------------ */
+/**
+ * Keep the character able to carry on, whatever happened last command
+ */
+static void bench_restore(void)
+{
+	player->chp = player->mhp;
+	player->chp_frac = 0;
+	player->csp = player->msp;
+	player->csp_frac = 0;
+	player_set_timed(player, TMD_FOOD, PY_FOOD_FULL - 1, false, false);
+	player_clear_timed(player, TMD_CONFUSED, false, false);
+	player_clear_timed(player, TMD_BLIND, false, false);
+	player_clear_timed(player, TMD_PARALYZED, false, false);
+	player_clear_timed(player, TMD_AFRAID, false, false);
+}
+
+/**
+ * Run the game until it wants another command; false if the character
+ * can't go on
+ */
+static bool bench_play(void)
+{
+	run_game_loop();
+	if (player->is_dead || !player->upkeep->playing) {
+		printf("bench: the character could not go on\n");
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Stand on the way off the level which goes deepest, as far as can be
+ * told from where it leads, and get the command to take it
+ */
+static bool bench_way_on(cmd_code *code)
+{
+	struct loc grid, best = loc(-1, -1);
+	int best_depth = -1;
+
+	for (grid.y = 0; grid.y < cave->height; grid.y++) {
+		for (grid.x = 0; grid.x < cave->width; grid.x++) {
+			int feat = square(cave, grid)->feat, place, depth;
+
+			if (!square_isstairs(cave, grid)
+					&& !square_ispath(cave, grid)) {
+				continue;
+			}
+			if (square_monster(cave, grid)) continue;
+			place = player_stairs_place(player, feat);
+			if (place < 0) continue;
+			depth = world->levels[place].depth;
+			if (depth > best_depth) {
+				best_depth = depth;
+				best = grid;
+			}
+		}
+	}
+	if (best_depth < 0) return false;
+
+	player_place(cave, player, best);
+	*code = square_isdownstairs(cave, best) ? CMD_GO_DOWN : CMD_GO_UP;
+	return true;
+}
+
+static bool c_descend(int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		cmd_code code;
+
+		bench_restore();
+		if (!bench_way_on(&code)) {
+			printf("bench: no way on from this level\n");
+			return true;
+		}
+		cmdq_push(code);
+		if (!bench_play()) return false;
+	}
+	return true;
+}
+
+static bool c_explore(int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		bench_restore();
+
+		/* Exploring stops for monsters, so let them come */
+		if (player_has_monster_in_view(player)) {
+			cmdq_push(CMD_HOLD);
+		} else {
+			cmdq_push(CMD_EXPLORE);
+		}
+		if (!bench_play()) return false;
+	}
+	return true;
+}
+
+static bool c_run(int dir, int n)
+{
+	int i;
+
+	if (dir < 1 || dir > 9 || dir == 5) {
+		printf("bench: bad direction %d\n", dir);
+		return true;
+	}
+	for (i = 0; i < n; i++) {
+		bench_restore();
+		cmdq_push(CMD_RUN);
+		cmd_set_arg_direction(cmdq_peek(), "direction", dir);
+		if (!bench_play()) return false;
+	}
+	return true;
+}
+
+static bool c_crowd(int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		pick_and_place_distant_monster(cave, player->grid, 4, false,
+			player->depth);
+	}
+	return true;
+}
+
+static bool c_cast(const char *name, int n)
+{
+	int i, index = -1;
+
+	for (i = 0; i < player->class->magic.total_spells; i++) {
+		if (my_stricmp(spell_by_index(player, i)->name, name) == 0) {
+			index = i;
+			break;
+		}
+	}
+	if (index < 0 || !spell_okay_to_cast(player, index)) {
+		printf("bench: can't cast '%s'\n", name);
+		return true;
+	}
+
+	for (i = 0; i < n; i++) {
+		bench_restore();
+		cmdq_push(CMD_CAST);
+		cmd_set_arg_choice(cmdq_peek(), "spell", index);
+		if (spell_needs_aim(index)) {
+			int dir = DIR_TARGET;
+
+			/* Aim at the closest monster, or go round the compass */
+			if (!target_set_closest(TARGET_KILL | TARGET_QUIET, NULL)) {
+				dir = ddd[i % 8];
+			}
+			cmd_set_arg_target(cmdq_peek(), "target", dir);
+		}
+		counts.casts++;
+		if (!bench_play()) return false;
+	}
+	return true;
+}
+
+/**
+ * Work out the area of n breaths of the largest radius around the player,
+ * without them affecting anything
+ */
+static bool c_breathe(int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		struct loc grid = loc_sum(player->grid,
+			loc(i % 9 - 4, (i / 9) % 9 - 4));
+
+		if (!square_in_bounds_fully(cave, grid)
+				|| !square_isprojectable(cave, grid)) {
+			grid = player->grid;
+		}
+		project(source_none(), 20, grid, 0, PROJ_FIRE, PROJECT_HIDE, 0, 0,
+			NULL);
+	}
+	return true;
+}
+
+static bool c_rest(int n)
+{
+	bench_restore();
+	cmdq_push(CMD_REST);
+	cmd_set_arg_choice(cmdq_peek(), "choice", n);
+	return bench_play();
+}
+
+/**
+ * Come back to each town in turn after n days away
+ */
+static bool c_away(int n)
+{
+	int place = player->place, i;
+
+	for (i = 0; i < world->num_towns; i++) {
+		player->place = world->towns[i].index;
+		daycount = n;
+		store_update();
+	}
+	player->place = place;
+	return true;
+}
+
+/**
+ * Wrap a recall or description to the width of the screen, as showing it
+ * would, and throw it away
+ */
+static void bench_text_done(textblock *tb)
+{
+	size_t *line_starts = NULL, *line_lengths = NULL;
+
+	(void) textblock_calculate_lines(tb, &line_starts, &line_lengths, 80);
+	mem_free(line_starts);
+	mem_free(line_lengths);
+	textblock_free(tb);
+	counts.texts++;
+}
+
+/**
+ * Make the monster recall for every race and the description of every
+ * object kind, n times over
+ */
+static bool c_describe(int n)
+{
+	int i, j;
+
+	for (j = 0; j < n; j++) {
+		for (i = 1; i < z_info->r_max; i++) {
+			const struct monster_race *race = &r_info[i];
+			textblock *tb;
+
+			if (!race->name || !race->base || rf_has(race->flags, RF_PLAYER_GHOST)) {
+				continue;
+			}
+			/* Everything is known, so each recall is as long as it gets
+			 * (and has no title, which needs the display's symbols) */
+			tb = textblock_new();
+			lore_description(tb, race, get_lore(race), true);
+			bench_text_done(tb);
+		}
+		for (i = 0; i < z_info->k_max; i++) {
+			struct object_kind *kind = &k_info[i];
+			struct object *obj, *known_obj;
+
+			if (!kind->name || !kind->base || tval_is_money_k(kind)) {
+				continue;
+			}
+			obj = object_new();
+			known_obj = object_new();
+			object_prep(obj, kind, 0, EXTREMIFY);
+			object_copy(known_obj, obj);
+			obj->known = known_obj;
+			bench_text_done(object_info(obj, OINFO_NONE));
+			object_delete(NULL, NULL, &known_obj);
+			object_delete(NULL, NULL, &obj);
+		}
+	}
+	return true;
+}
+
+/**
+ * Raise the character to a level, knowing every spell that allows
+ */
+static bool c_level(int lev)
+{
+	int i;
+
+	if (lev < 2 || lev > PY_MAX_LEVEL) {
+		printf("bench: bad level %d\n", lev);
+		return true;
+	}
+	if (player->exp < player_exp[lev - 2]) {
+		player_exp_gain(player, player_exp[lev - 2] - player->exp);
+	}
+	player->upkeep->update |= (PU_BONUS | PU_HP | PU_SPELLS);
+	update_stuff(player);
+	for (i = 0; i < player->class->magic.total_spells; i++) {
+		if (spell_okay_to_study(player, i)) spell_learn(i);
+	}
+	update_stuff(player);
+	bench_restore();
+	return true;
+}
+
+/**
+ * Do one line of the script; false if the script can't go on
+ */
+static bool bench_do_line(char *line)
+{
+	char *cmd = strtok(line, " \t");
+	char *rest = strtok(NULL, "");
+	int n = 1;
+
+	if (!cmd || cmd[0] == '#') return true;
+	if (rest && isdigit((unsigned char) rest[0])) n = atoi(rest);
+
+	if (streq(cmd, "phase")) {
+		bench_phase_begin(rest ? rest : "unnamed");
+		return true;
+	}
+
+	/* Count anything before the first named phase as setting up */
+	if (!phase_num) bench_phase_begin("setup");
+
+	if (streq(cmd, "descend")) return c_descend(n);
+	if (streq(cmd, "explore")) return c_explore(n);
+	if (streq(cmd, "crowd")) return c_crowd(n);
+	if (streq(cmd, "breathe")) return c_breathe(n);
+	if (streq(cmd, "rest")) return c_rest(n);
+	if (streq(cmd, "level")) return c_level(n);
+	if (streq(cmd, "describe")) return c_describe(n);
+	if (streq(cmd, "away")) return c_away(n);
+	if (streq(cmd, "run")) {
+		int dir = rest ? atoi(rest) : 0;
+		char *count = rest ? strchr(rest, ' ') : NULL;
+
+		return c_run(dir, count ? atoi(count) : 1);
+	}
+	if (streq(cmd, "cast") && rest) {
+		/* A count may follow the name of the spell */
+		char *last = strrchr(rest, ' ');
+
+		if (last && isdigit((unsigned char) last[1])) {
+			*last = '\0';
+			n = atoi(last + 1);
+		}
+		return c_cast(rest, n);
+	}
+
+	printf("bench: bad command '%s'\n", cmd);
+	return true;
+}
+
+static void bench_run_script(void)
+{
+	char buf[1024];
+
+	if (script_path) {
+		ang_file *f = file_open(script_path, MODE_READ, FTYPE_TEXT);
+
+		if (!f) {
+			printf("bench: can't open '%s'\n", script_path);
+			return;
+		}
+		while (file_getl(f, buf, sizeof(buf))) {
+			if (!bench_do_line(buf)) break;
+		}
+		file_close(f);
+	} else {
+		int i;
+
+		for (i = 0; default_script[i]; i++) {
+			my_strcpy(buf, default_script[i], sizeof(buf));
+			if (!bench_do_line(buf)) break;
+		}
+	}
+	bench_phase_begin(NULL);
+}
+
+/**
+ * Play back a log of recorded commands, queueing each when the game is
+ * ready for the next
+ */
+static void bench_replay(struct cmd_replay *replay)
+{
+	bench_phase_begin("replay");
+	while (cmd_replay_next(replay)) {
+		if (!bench_play()) break;
+	}
+	bench_phase_begin(NULL);
+}
+
+/**
+ * Load the save a log of recorded commands starts from
+ */
+static struct cmd_replay *bench_replay_load(void)
+{
+	struct cmd_replay *replay = cmd_replay_load(replay_path);
+
+	if (!replay) {
+		printf("init-bench: can't read commands from '%s'\n",
+			replay_path);
+		return NULL;
+	}
+	if (!savefile_load(cmd_replay_savefile(replay), false)
+			|| player->is_dead) {
+		printf("init-bench: can't load '%s'\n",
+			cmd_replay_savefile(replay));
+		cmd_replay_free(replay);
+		return NULL;
+	}
+	update_player_object_knowledge(player);
+	player->upkeep->autosave = false;
+	if (!character_dungeon) {
+		prepare_next_level(player);
+	}
+	on_new_level();
+	cmd_replay_start(replay);
+	return replay;
+}
+
+static void bench_free(void)
+{
+	int i;
+
+	for (i = 0; i < phase_num; i++) {
+		string_free(phases[i].name);
+	}
+	mem_free(phases);
+	for (i = 0; i < gen_phase_num; i++) {
+		string_free(gen_phases[i].name);
+	}
+	mem_free(gen_phases);
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Front end
+ * ------------------------------------------------------------------------ */
+static errr term_xtra_bench(int n, int v)
+{
+	return 0;
+}
+
+static errr term_curs_bench(int x, int y)
+{
+	return 0;
+}
+
+static errr term_wipe_bench(int x, int y, int n)
+{
+	return 0;
+}
+
+static errr term_text_bench(int x, int y, int n, int a, const wchar_t *s)
+{
+	return 0;
+}
+
+static void term_data_link(int i)
+{
+	static term t;
+
+	term_init(&t, 80, 24, 256);
+
+	/* Ignore some actions for efficiency and safety */
+	t.never_bored = true;
+	t.never_frosh = true;
+
+	t.xtra_hook = term_xtra_bench;
+	t.curs_hook = term_curs_bench;
+	t.wipe_hook = term_wipe_bench;
+	t.text_hook = term_text_bench;
+
+	Term_activate(&t);
+	angband_term[i] = &t;
+}
+
+const char help_bench[] = "Benchmark mode, subopts -f(script file) -s(eed) "
+	"-R(ace name) -C(lass name) -r(ecorded commands) -q(uiet)";
+
+/**
+ * Usage:
+ *
+ * angband -mbench -- [-f file] [-sNNNN] [-Rname] [-Cname] [-r log] [-q]
+ *
+ *   -f file  Follow the script in file rather than the built-in one
+ *   -sNNNN   Use NNNN as the seed for the random number generator
+ *   -Rname   Use name as the character's race (default: the first race in
+ *            lib/gamedata/p_race.txt)
+ *   -Cname   Use name as the character's class (default: Mage)
+ *   -r log   Play back the commands recorded in log (see angband -r) from
+ *            the save made when recording began, instead of following a
+ *            script
+ *   -q       Don't say what is being done, only report the results
+ *
+ * Each line of a script is a command and its arguments; lines starting with
+ * '#' are ignored.  The commands are:
+ *
+ *   phase name       Start timing a new phase called name
+ *   level n          Raise the character to level n, learning all the
+ *                    spells that allows
+ *   descend n        Take the deepest way off the level n times
+ *   explore n        Explore n times, waiting instead while monsters are
+ *                    in view
+ *   run dir n        Run n times in the direction dir (a keypad digit)
+ *   crowd n          Put n awake monsters on the level
+ *   cast spell n     Cast the named spell n times at the closest monster
+ *   breathe n        Work out the area of n breaths of radius 20 near the
+ *                    player, which affect nothing
+ *   rest n           Rest for n turns
+ *   describe n       Make the monster recall for every race and the
+ *                    description of every object kind n times
+ *   away n           Come back to each town in turn after n days away,
+ *                    bringing its stores up to date
+ */
+errr init_bench(int argc, char *argv[])
+{
+	struct cmd_replay *replay = NULL;
+	int i;
+
+	/* Skip over argv[0] */
+	for (i = 1; i < argc; i++) {
+		if (streq(argv[i], "-f") && i + 1 < argc) {
+			script_path = argv[++i];
+			continue;
+		}
+		if (prefix(argv[i], "-s")) {
+			seed = strtoul(&argv[i][2], NULL, 0);
+			continue;
+		}
+		if (prefix(argv[i], "-R")) {
+			race_name = argv[i] + 2;
+			continue;
+		}
+		if (prefix(argv[i], "-C")) {
+			class_name = argv[i] + 2;
+			continue;
+		}
+		if (streq(argv[i], "-r") && i + 1 < argc) {
+			replay_path = argv[++i];
+			continue;
+		}
+		if (streq(argv[i], "-q")) {
+			quiet = true;
+			continue;
+		}
+		printf("init-bench: bad argument '%s'\n", argv[i]);
+		return 1;
+	}
+
+	/* Don't let the savefile set by main.c interfere */
+	savefile[0] = '\0';
+	term_data_link(0);
+
+	init_angband();
+	Rand_quick = false;
+	Rand_state_init(seed);
+	if (replay_path) {
+		replay = bench_replay_load();
+		if (!replay) {
+			cleanup_angband();
+			return 1;
+		}
+	} else {
+		if (!player_make_simple(race_name, class_name, "Bench")) {
+			printf("init-bench: could not make the character\n");
+			cleanup_angband();
+			return 1;
+		}
+		player->opts.opt[OPT_autoexplore_commands] = true;
+		player->upkeep->autosave = false;
+		prepare_next_level(player);
+		on_new_level();
+	}
+
+	if (!quiet && replay) {
+		printf("bench: %s %s, %d commands from %s\n",
+			player->race->name, player->class->name,
+			cmd_replay_count(replay), replay_path);
+	} else if (!quiet) {
+		printf("bench: seed %lu, %s %s, %s\n", (unsigned long) seed,
+			player->race->name, player->class->name,
+			script_path ? script_path : "built-in script");
+	}
+	event_add_handler(EVENT_GEN_LEVEL_START, bench_gen_start, NULL);
+	event_add_handler(EVENT_GEN_LEVEL_PHASE, bench_gen_phase, NULL);
+	event_add_handler(EVENT_GEN_LEVEL_END, bench_gen_end, NULL);
+	event_add_handler(EVENT_GEN_LEVEL_GUESSED, bench_gen_guessed, NULL);
+	event_add_handler(EVENT_PLAYERMOVED, bench_moved, NULL);
+	gen_level_start = -1.0;
+	profile_reset();
+
+	if (replay) {
+		bench_replay(replay);
+	} else {
+		bench_run_script();
+	}
+	bench_report();
+	if (replay) {
+		printf("\nreplayed %d commands, %d not given as recorded\n",
+			cmd_replay_count(replay), cmd_replay_diverged(replay));
+		cmd_replay_free(replay);
+	}
+
+	event_remove_handler(EVENT_GEN_LEVEL_START, bench_gen_start, NULL);
+	event_remove_handler(EVENT_GEN_LEVEL_PHASE, bench_gen_phase, NULL);
+	event_remove_handler(EVENT_GEN_LEVEL_END, bench_gen_end, NULL);
+	event_remove_handler(EVENT_GEN_LEVEL_GUESSED, bench_gen_guessed, NULL);
+	event_remove_handler(EVENT_PLAYERMOVED, bench_moved, NULL);
+	bench_free();
+	wipe_mon_list(cave, player);
+	cleanup_angband();
+	exit(0);
+	return 0;
+}
+
+#endif /* USE_BENCH */
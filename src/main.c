@@ -83,6 +83,10 @@ static const struct module modules[] =
 	{ "test", help_test, init_test, false, true },
 #endif /* !USE_TEST */
 
+#ifdef USE_BENCH
+	{ "bench", help_bench, init_bench, false, true },
+#endif /* USE_BENCH */
+
 #ifdef USE_STATS
 	{ "stats", help_stats, init_stats, false, true },
 #endif /* USE_STATS */
@@ -438,6 +442,11 @@ int main(int argc, char *argv[])
 				arg_force_name = true;
 				break;
 
+			case 'r':
+				if (!*arg) goto usage;
+				my_strcpy(arg_record, arg, sizeof(arg_record));
+				continue;
+
 			case 'm':
 				if (!*arg) goto usage;
 				mstr = arg;
@@ -468,6 +477,7 @@ int main(int argc, char *argv[])
 				puts("  -w             Resurrect dead character (marks savefile)");
 				puts("  -g             Request graphics mode");
 				puts("  -u<who>        Use your <who> savefile");
+				puts("  -r<file>       Record the commands given, for playing back with -mbench");
 				puts("  -d<dir>=<path> Override a specific directory with <path>. <path> can be:");
 				for (i = 0; i < (int)N_ELEMENTS(change_path_values); i++) {
 #ifdef SETGID
@@ -39,6 +39,7 @@ extern errr init_vcs(int argc, char **argv);
 extern errr init_sdl(int argc, char **argv);
 extern errr init_sdl2(int argc, char **argv);
 extern errr init_test(int argc, char **argv);
+extern errr init_bench(int argc, char **argv);
 extern errr init_stats(int argc, char **argv);
 extern errr init_spoil(int argc, char **argv);
 
@@ -59,6 +60,7 @@ extern const char help_dos[];
 extern const char help_sdl[];
 extern const char help_sdl2[];
 extern const char help_test[];
+extern const char help_bench[];
 extern const char help_stats[];
 extern const char help_spoil[];
 
@@ -34,29 +34,30 @@
 #include "init.h"
 #include "player.h"
 
+/**
+ * Messages are kept in a ring of fixed size, so the message of any age can be
+ * found directly; their text lives in a single circular buffer, with each
+ * message's text following that of the message before it.
+ */
 typedef struct _message_t
 {
-	char *str;
-	struct _message_t *newer;
-	struct _message_t *older;
+	uint32_t text;
 	uint16_t type;
 	uint16_t count;
 } message_t;
 
-typedef struct _msgcolor_t
-{
-	uint16_t type;
-	uint8_t color;
-	struct _msgcolor_t *next;
-} msgcolor_t;
-
 typedef struct _msgqueue_t
 {
-	message_t *head;
-	message_t *tail;
-	msgcolor_t *colors;
+	message_t *ring;
+	uint32_t first;
 	uint32_t count;
 	uint32_t max;
+
+	char *text;
+	uint32_t text_head;
+	uint32_t text_size;
+
+	uint8_t colors[MSG_MAX + 1];
 } msgqueue_t;
 
 static msgqueue_t *messages = NULL;
@@ -73,6 +74,9 @@ void messages_init(void)
 {
 	messages = mem_zalloc(sizeof(msgqueue_t));
 	messages->max = 2048;
+	messages->ring = mem_zalloc(messages->max * sizeof(message_t));
+	messages->text_size = messages->max * 64;
+	messages->text = mem_zalloc(messages->text_size);
 }
 
 /**
@@ -80,24 +84,8 @@ void messages_init(void)
  */
 void messages_free(void)
 {
-	msgcolor_t *c = messages->colors;
-	msgcolor_t *nextc;
-	message_t *m = messages->head;
-	message_t *nextm;
-
-	while (m) {
-		nextm = m->older;
-		mem_free(m->str);
-		mem_free(m);
-		m = nextm;
-	}
-
-	while (c) {
-		nextc = c->next;
-		mem_free(c);
-		c = nextc;
-	}
-
+	mem_free(messages->text);
+	mem_free(messages->ring);
 	mem_free(messages);
 }
 
@@ -113,6 +101,51 @@ uint16_t messages_num(void)
  * ------------------------------------------------------------------------
  * Functions for individual messages
  * ------------------------------------------------------------------------ */
+/**
+ * Returns the message of age `age`.
+ */
+static message_t *message_get(uint16_t age)
+{
+	if (age >= messages->count) return NULL;
+	return &messages->ring[(messages->first + messages->count - 1 - age) %
+		messages->max];
+}
+
+/**
+ * Forget the oldest message.
+ */
+static void message_drop_oldest(void)
+{
+	messages->first = (messages->first + 1) % messages->max;
+	messages->count--;
+	if (!messages->count) messages->text_head = 0;
+}
+
+/**
+ * Find room for `len` bytes of text, forgetting the oldest messages until
+ * there is some, and return where it is.  Text is never split, so if it
+ * won't fit before the end of the buffer it goes at the start.
+ */
+static uint32_t message_text_space(uint32_t len)
+{
+	while (messages->count) {
+		uint32_t head = messages->text_head;
+		uint32_t tail = message_get(messages->count - 1)->text;
+
+		if (head + len <= messages->text_size) {
+			/* Fits unless it would run into the oldest text */
+			if (tail < head || tail - head >= len) return head;
+		} else {
+			/* Wrap, unless the start of the buffer is in use */
+			if (tail < head && tail >= len) return 0;
+		}
+		message_drop_oldest();
+	}
+
+	return (messages->text_head + len <= messages->text_size) ?
+		messages->text_head : 0;
+}
+
 /**
  * Save a new message into the memory buffer, with text `str` and type `type`.
  * The type should be one of the MSG_ constants defined in message.h.
@@ -120,61 +153,41 @@ uint16_t messages_num(void)
  * The new message may not be saved if it is identical to the one saved before
  * it, in which case the "count" of the message will be increased instead.
  * This count can be fetched using the message_count() function.
+ *
+ * If there is no room left for the text, the oldest messages are forgotten
+ * until there is.
  */
 void message_add(const char *str, uint16_t type)
 {
-	message_t *m;
+	message_t *m = message_get(0);
+	uint32_t len = (uint32_t)strlen(str) + 1;
+	uint32_t pos;
 
-	if (messages->head &&
-	    messages->head->type == type &&
-	    streq(messages->head->str, str) &&
-	    messages->head->count != (uint16_t)-1) {
-		messages->head->count++;
+	if (m && m->type == type && streq(messages->text + m->text, str) &&
+			m->count != (uint16_t)-1) {
+		m->count++;
 		return;
 	}
 
-	m = mem_zalloc(sizeof(message_t));
-	m->str = string_make(str);
-	m->type = type;
-	m->count = 1;
-	m->older = messages->head;
-
-	if (messages->head)
-		messages->head->newer = m;
-
-	messages->head = m;
-	messages->count++;
-
-	if (!messages->tail)
-		messages->tail = m;
-
-	if (messages->count > messages->max) {
-		message_t *old_tail = messages->tail;
-
-		messages->tail = old_tail->newer;
-		messages->tail->older = NULL;
-		mem_free(old_tail->str);
-		mem_free(old_tail);
-		messages->count--;
+	/* Make room */
+	if (messages->count == messages->max) {
+		message_drop_oldest();
 	}
-}
-
-/**
- * Returns the message of age `age`.
- */
-static message_t *message_get(uint16_t age)
-{
-	message_t *m = messages->head;
-
-	while (m && age) {
-		age--;
-		m = m->older;
+	if (len > messages->text_size) {
+		len = messages->text_size;
 	}
+	pos = message_text_space(len);
+	memcpy(messages->text + pos, str, len - 1);
+	messages->text[pos + len - 1] = '\0';
+	messages->text_head = pos + len;
 
-	return m;
+	messages->count++;
+	m = message_get(0);
+	m->text = pos;
+	m->type = type;
+	m->count = 1;
 }
 
-
 /**
  * Returns the text of the message of age `age`.  The age of the most recently
  * saved message is 0, the one before that is of age 1, etc.
@@ -185,7 +198,7 @@ static message_t *message_get(uint16_t age)
 const char *message_str(uint16_t age)
 {
 	message_t *m = message_get(age);
-	return (m ? m->str : "");
+	return (m ? messages->text + m->text : "");
 }
 
 /**
@@ -235,51 +248,21 @@ uint8_t message_color(uint16_t age)
  */
 void message_color_define(uint16_t type, uint8_t color)
 {
-	msgcolor_t *mc;
-
-	if (!messages->colors)
-	{
-		messages->colors = mem_zalloc(sizeof(msgcolor_t));
-		messages->colors->type = type;
-		messages->colors->color = color;
-		return;
-	}
-
-	mc = messages->colors;
-	while (1)
-	{
-		if (mc->type == type)
-		{
-			mc->color = color;
-			break;
-		}
-		if (! mc->next) {
-			mc->next = mem_zalloc(sizeof(msgcolor_t));
-			mc->next->type = type;
-			mc->next->color = color;
-			break;
-		}
-		mc = mc->next;
-	}
+	if (type > MSG_MAX) return;
+	messages->colors[type] = color;
 }
 
 /**
- * Returns the colour for the message type `type`.
+ * Returns the colour for the message type `type`.  Types with no colour
+ * defined, or defined as dark, are shown in white.
  */
 uint8_t message_type_color(uint16_t type)
 {
-	msgcolor_t *mc;
 	uint8_t color = COLOUR_WHITE;
 
-	if (messages)
-	{
-		mc = messages->colors;
-
-		while (mc && mc->type != type)
-			mc = mc->next;
-
-		if (mc && (mc->color != COLOUR_DARK))
-			color = mc->color;
+	if (messages && type <= MSG_MAX &&
+			messages->colors[type] != COLOUR_DARK) {
+		color = messages->colors[type];
 	}
 
 	return color;
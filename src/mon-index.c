@@ -0,0 +1,383 @@
+/**
+ * \file mon-index.c
+ * \brief Spatial index of the monsters on a chunk
+ *
+ * Finding the monsters near a grid used to mean looking at every monster on
+ * the level, which on a large wilderness level is mostly wasted effort.  The
+ * index divides the chunk into square buckets, each holding a list of the
+ * monsters standing in it, so that the monsters near a grid can be found by
+ * looking at a handful of buckets.
+ *
+ * The index is built the first time it is needed, and from then on kept up
+ * to date by square_set_mon(), which every change of a monster's grid goes
+ * through.  Anything which rearranges the monster list wholesale just throws
+ * the index away, to be rebuilt when it's next wanted.
+ *
+ * The index also remembers which monsters the player can currently see or
+ * has detected, so that a monster which has gone out of range can still be
+ * found in order to be marked as no longer visible, and so that the monster
+ * list can be made without looking at every monster.
+ *
+ * Effects which act on the monsters in an area use the region queries at
+ * the end of this file, which hand back their own copy of the list so that
+ * the monsters can safely be hurt, moved or deleted while it is walked.
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "cave.h"
+#include "init.h"
+#include "mon-index.h"
+#include "mon-predicate.h"
+#include "monster.h"
+#include "player.h"
+
+/**
+ * Buckets are this many grids (as a power of two) on a side
+ */
+#define MON_INDEX_SHIFT 4
+
+struct mon_index {
+	int cols, rows;			/* Size of the bucket array */
+	int max;				/* Number of monster slots covered */
+
+	int16_t *head;			/* First monster in each bucket */
+	int16_t *next;			/* Bucket links, 0 terminated */
+	int16_t *prev;
+	struct loc *at;			/* Grid each monster is filed under */
+
+	uint32_t *seen;			/* Bitmap of monsters the player knows of */
+	uint32_t *picked;		/* Scratch bitmap for mon_index_gather() */
+	int16_t *list;			/* Result of mon_index_gather() */
+};
+
+/**
+ * ------------------------------------------------------------------------
+ * Internal helpers
+ * ------------------------------------------------------------------------ */
+static int index_bucket(const struct mon_index *index, struct loc grid)
+{
+	return (grid.y >> MON_INDEX_SHIFT) * index->cols +
+		(grid.x >> MON_INDEX_SHIFT);
+}
+
+static void index_remove(struct mon_index *index, int idx)
+{
+	if (index->at[idx].x < 0) return;
+
+	if (index->prev[idx]) {
+		index->next[index->prev[idx]] = index->next[idx];
+	} else {
+		index->head[index_bucket(index, index->at[idx])] = index->next[idx];
+	}
+	if (index->next[idx]) {
+		index->prev[index->next[idx]] = index->prev[idx];
+	}
+	index->next[idx] = 0;
+	index->prev[idx] = 0;
+	index->at[idx] = loc(-1, -1);
+}
+
+static void index_add(struct mon_index *index, int idx, struct loc grid)
+{
+	int bucket = index_bucket(index, grid);
+
+	index_remove(index, idx);
+	index->at[idx] = grid;
+	index->prev[idx] = 0;
+	index->next[idx] = index->head[bucket];
+	if (index->head[bucket]) {
+		index->prev[index->head[bucket]] = idx;
+	}
+	index->head[bucket] = idx;
+}
+
+static bool index_is_seen(const struct monster *mon)
+{
+	return monster_is_visible(mon) || monster_is_in_view(mon) ||
+		mflag_has(mon->mflag, MFLAG_MARK);
+}
+
+/**
+ * Build the index for a chunk from its monster list
+ */
+static struct mon_index *index_build(struct chunk *c)
+{
+	struct mon_index *index = mem_zalloc(sizeof(*index));
+	int words = (z_info->level_monster_max + 31) / 32;
+	int i;
+
+	index->cols = (c->width >> MON_INDEX_SHIFT) + 1;
+	index->rows = (c->height >> MON_INDEX_SHIFT) + 1;
+	index->max = z_info->level_monster_max;
+	index->head = mem_zalloc(index->cols * index->rows * sizeof(int16_t));
+	index->next = mem_zalloc(index->max * sizeof(int16_t));
+	index->prev = mem_zalloc(index->max * sizeof(int16_t));
+	index->at = mem_alloc(index->max * sizeof(struct loc));
+	index->seen = mem_zalloc(words * sizeof(uint32_t));
+	index->picked = mem_zalloc(words * sizeof(uint32_t));
+	index->list = mem_zalloc(index->max * sizeof(int16_t));
+	for (i = 0; i < index->max; i++) {
+		index->at[i] = loc(-1, -1);
+	}
+
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race) continue;
+		index_add(index, i, mon->grid);
+		if (index_is_seen(mon)) {
+			index->seen[i / 32] |= 1U << (i % 32);
+		}
+	}
+	c->mon_index = index;
+	return index;
+}
+
+/**
+ * Put the monsters filed under grids in a rectangle in the index's list
+ */
+static int index_collect(struct chunk *c, int x1, int y1, int x2, int y2)
+{
+	struct mon_index *index = c->mon_index ? c->mon_index : index_build(c);
+	int n = 0, x, y;
+
+	x1 = MAX(x1, 0);
+	y1 = MAX(y1, 0);
+	x2 = MIN(x2, c->width - 1);
+	y2 = MIN(y2, c->height - 1);
+
+	for (y = y1 >> MON_INDEX_SHIFT; y <= y2 >> MON_INDEX_SHIFT; y++) {
+		for (x = x1 >> MON_INDEX_SHIFT; x <= x2 >> MON_INDEX_SHIFT; x++) {
+			int idx = index->head[y * index->cols + x];
+
+			for (; idx; idx = index->next[idx]) {
+				struct loc at = index->at[idx];
+				if (at.x < x1 || at.x > x2) continue;
+				if (at.y < y1 || at.y > y2) continue;
+				index->list[n++] = idx;
+			}
+		}
+	}
+
+	return n;
+}
+
+static int cmp_midx(const void *a, const void *b)
+{
+	return *(const int16_t *)a - *(const int16_t *)b;
+}
+
+/**
+ * Hand over a copy of the first n monsters in the index's list, in order of
+ * index
+ */
+static int index_copy(struct chunk *c, int n, int16_t **list)
+{
+	*list = mem_alloc(MAX(n, 1) * sizeof(int16_t));
+	memcpy(*list, c->mon_index->list, n * sizeof(int16_t));
+	sort(*list, n, sizeof(int16_t), cmp_midx);
+	return n;
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Keeping the index up to date
+ * ------------------------------------------------------------------------ */
+/**
+ * Discard the index for a chunk
+ */
+void mon_index_free(struct chunk *c)
+{
+	struct mon_index *index = c->mon_index;
+
+	if (!index) return;
+	mem_free(index->head);
+	mem_free(index->next);
+	mem_free(index->prev);
+	mem_free(index->at);
+	mem_free(index->seen);
+	mem_free(index->picked);
+	mem_free(index->list);
+	mem_free(index);
+	c->mon_index = NULL;
+}
+
+/**
+ * The occupant of a grid has changed from old_midx to midx.  The old
+ * occupant may already have been filed somewhere else, in which case it's
+ * left alone.
+ */
+void mon_index_set(struct chunk *c, struct loc grid, int old_midx, int midx)
+{
+	struct mon_index *index = c->mon_index;
+
+	if (!index) return;
+	if (old_midx > 0 && old_midx < index->max &&
+		loc_eq(index->at[old_midx], grid)) {
+		index_remove(index, old_midx);
+	}
+	if (midx > 0 && midx < index->max) {
+		index_add(index, midx, grid);
+	}
+}
+
+/**
+ * Record whether the player can see, or has detected, a monster
+ */
+void mon_index_note_seen(struct chunk *c, const struct monster *mon)
+{
+	struct mon_index *index = c->mon_index;
+	int idx = mon->midx;
+
+	if (!index || idx <= 0 || idx >= index->max) return;
+	if (index_is_seen(mon)) {
+		index->seen[idx / 32] |= 1U << (idx % 32);
+	} else {
+		index->seen[idx / 32] &= ~(1U << (idx % 32));
+	}
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Finding monsters
+ * ------------------------------------------------------------------------ */
+/**
+ * Find the monsters within radius grids (in each direction) of grid, along
+ * with every monster the player can see or has detected if seen is true.
+ * The list, which holds each monster once, is valid until the next call.
+ *
+ * Returns the number of monsters found.
+ */
+int mon_index_gather(struct chunk *c, struct loc grid, int radius, bool seen,
+		const int16_t **list)
+{
+	int n = index_collect(c, grid.x - radius, grid.y - radius,
+		grid.x + radius, grid.y + radius);
+	struct mon_index *index = c->mon_index;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		index->picked[index->list[i] / 32] |= 1U << (index->list[i] % 32);
+	}
+
+	if (seen) {
+		for (i = 0; i < (index->max + 31) / 32; i++) {
+			uint32_t bits = index->seen[i] & ~index->picked[i];
+			while (bits) {
+				int bit = 0;
+				while (!(bits & (1U << bit))) bit++;
+				bits &= ~(1U << bit);
+				index->list[n++] = i * 32 + bit;
+			}
+		}
+	}
+
+	for (i = 0; i < n; i++) {
+		index->picked[index->list[i] / 32] &= ~(1U << (index->list[i] % 32));
+	}
+
+	*list = index->list;
+	return n;
+}
+
+/**
+ * Find the monsters the player can see or has detected, in order of index;
+ * a monster which has died since the player last saw it may be among them.
+ * The list is valid until the next call.
+ *
+ * Returns the number of monsters found.
+ */
+int mon_index_seen(struct chunk *c, const int16_t **list)
+{
+	struct mon_index *index = c->mon_index ? c->mon_index : index_build(c);
+	int n = 0, i;
+
+	for (i = 0; i < (index->max + 31) / 32; i++) {
+		uint32_t bits = index->seen[i];
+		while (bits) {
+			int bit = 0;
+			while (!(bits & (1U << bit))) bit++;
+			bits &= ~(1U << bit);
+			index->list[n++] = i * 32 + bit;
+		}
+	}
+
+	*list = index->list;
+	return n;
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Region queries
+ *
+ * Each of these finds the monsters in an area, in order of monster index
+ * so that they are met in the same order as when walking the monster list.
+ * The list belongs to the caller, who should free it with mem_free().
+ * ------------------------------------------------------------------------ */
+/**
+ * Find the monsters in the rectangle with corners grid1 and grid2
+ *
+ * Returns the number of monsters found.
+ */
+int mon_index_in_rect(struct chunk *c, struct loc grid1, struct loc grid2,
+		int16_t **list)
+{
+	return index_copy(c, index_collect(c, MIN(grid1.x, grid2.x),
+		MIN(grid1.y, grid2.y), MAX(grid1.x, grid2.x),
+		MAX(grid1.y, grid2.y)), list);
+}
+
+/**
+ * Find the monsters at most radius from grid, as measured by distance()
+ *
+ * Returns the number of monsters found.
+ */
+int mon_index_in_radius(struct chunk *c, struct loc grid, int radius,
+		int16_t **list)
+{
+	int n = index_collect(c, grid.x - radius, grid.y - radius,
+		grid.x + radius, grid.y + radius);
+	int i, kept = 0;
+
+	for (i = 0; i < n; i++) {
+		int idx = c->mon_index->list[i];
+		if (distance(grid, c->mon_index->at[idx]) <= radius) {
+			c->mon_index->list[kept++] = idx;
+		}
+	}
+	return index_copy(c, kept, list);
+}
+
+/**
+ * Find the monsters standing in the player's view.  No grid further than
+ * max_sight from the player is ever in view.
+ *
+ * Returns the number of monsters found.
+ */
+int mon_index_in_view(struct chunk *c, struct player *p, int16_t **list)
+{
+	int n = index_collect(c, p->grid.x - z_info->max_sight,
+		p->grid.y - z_info->max_sight, p->grid.x + z_info->max_sight,
+		p->grid.y + z_info->max_sight);
+	int i, kept = 0;
+
+	for (i = 0; i < n; i++) {
+		int idx = c->mon_index->list[i];
+		if (square_isview(c, c->mon_index->at[idx])) {
+			c->mon_index->list[kept++] = idx;
+		}
+	}
+	return index_copy(c, kept, list);
+}
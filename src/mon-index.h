@@ -0,0 +1,36 @@
+/**
+ * \file mon-index.h
+ * \brief Spatial index of the monsters on a chunk
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+#ifndef MON_INDEX_H
+#define MON_INDEX_H
+
+#include "cave.h"
+#include "monster.h"
+
+void mon_index_free(struct chunk *c);
+void mon_index_set(struct chunk *c, struct loc grid, int old_midx, int midx);
+void mon_index_note_seen(struct chunk *c, const struct monster *mon);
+int mon_index_gather(struct chunk *c, struct loc grid, int radius, bool seen,
+		const int16_t **list);
+int mon_index_seen(struct chunk *c, const int16_t **list);
+int mon_index_in_rect(struct chunk *c, struct loc grid1, struct loc grid2,
+		int16_t **list);
+int mon_index_in_radius(struct chunk *c, struct loc grid, int radius,
+		int16_t **list);
+int mon_index_in_view(struct chunk *c, struct player *p, int16_t **list);
+
+#endif /* !MON_INDEX_H */
@@ -1946,6 +1946,7 @@ static void cleanup_monster(void)
 	mem_free(r_info[z_info->r_max - 1].blow);
 
 	mem_free(r_info);
+	race_index_free();
 }
 
 struct file_parser monster_parser = {
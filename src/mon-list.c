@@ -19,9 +19,9 @@
 
 #include "game-world.h"
 #include "mon-desc.h"
+#include "mon-index.h"
 #include "mon-list.h"
 #include "mon-predicate.h"
-#include "project.h"
 
 /**
  * Allocate a new monster list based on the size of the current cave's monster
@@ -60,6 +60,7 @@ void monster_list_free(monster_list_t *list)
 		list->entries = NULL;
 	}
 
+	mem_free(list->buckets);
 	mem_free(list);
 	list = NULL;
 }
@@ -122,9 +123,12 @@ void monster_list_reset(monster_list_t *list)
 		list->entries = mem_realloc(list->entries, sizeof(list->entries[0])
 									* cave_monster_max(cave));
 		list->entries_size = cave_monster_max(cave);
+		list->distinct_entries = list->entries_size;
 	}
 
-	memset(list->entries, 0, list->entries_size * sizeof(monster_list_entry_t));
+	/* Entries are used from the start, so only those in use need zeroing */
+	memset(list->entries, 0, MIN(list->distinct_entries, list->entries_size)
+		   * sizeof(monster_list_entry_t));
 	memset(list->total_entries, 0, MONSTER_LIST_SECTION_MAX * sizeof(uint16_t));
 	memset(list->total_monsters, 0, MONSTER_LIST_SECTION_MAX * sizeof(uint16_t));
 	list->distinct_entries = 0;
@@ -132,12 +136,89 @@ void monster_list_reset(monster_list_t *list)
 	list->sorted = false;
 }
 
+/**
+ * Hash a race (and player race, for player ghosts) to a bucket.
+ */
+static size_t monster_list_bucket(const monster_list_t *list,
+								  const struct monster_race *race,
+								  const struct player_race *p_race)
+{
+	uint32_t key = race->ridx * 2654435761u;
+
+	if (p_race)
+		key ^= (p_race->ridx + 1) * 40503u;
+
+	return key & (list->buckets_size - 1);
+}
+
+/**
+ * Find the entry for a race, adding one if the race isn't in the list yet.
+ * Returns NULL if the list is full.
+ */
+static monster_list_entry_t *monster_list_entry_for(monster_list_t *list,
+		struct monster_race *race, struct player_race *p_race)
+{
+	size_t b = monster_list_bucket(list, race, p_race);
+	monster_list_entry_t *entry;
+
+	while (list->buckets[b]) {
+		entry = &list->entries[list->buckets[b] - 1];
+		if (entry->race == race && entry->p_race == p_race)
+			return entry;
+		b = (b + 1) & (list->buckets_size - 1);
+	}
+
+	if (list->distinct_entries >= list->entries_size)
+		return NULL;
+
+	/* We found an empty slot, so add this race here. */
+	entry = &list->entries[list->distinct_entries];
+	memset(entry, 0, sizeof(monster_list_entry_t));
+	entry->race = race;
+	entry->p_race = p_race;
+	list->buckets[b] = ++list->distinct_entries;
+	return entry;
+}
+
+/**
+ * Set up the race buckets for the entries already in a list.
+ */
+static void monster_list_buckets_reset(monster_list_t *list)
+{
+	size_t size = 16, i;
+
+	/* Keep the buckets no more than half full */
+	while (size < 2 * list->entries_size)
+		size *= 2;
+
+	if (list->buckets_size != size) {
+		mem_free(list->buckets);
+		list->buckets = mem_alloc(size * sizeof(int));
+		list->buckets_size = size;
+	}
+	memset(list->buckets, 0, size * sizeof(int));
+
+	for (i = 0; i < list->entries_size && list->entries[i].race; i++) {
+		monster_list_entry_t *entry = &list->entries[i];
+		size_t b = monster_list_bucket(list, entry->race, entry->p_race);
+
+		while (list->buckets[b])
+			b = (b + 1) & (size - 1);
+		list->buckets[b] = i + 1;
+	}
+	list->distinct_entries = i;
+}
+
 /**
  * Collect monster information from the current cave's monster list.
+ *
+ * Only the monsters the player can see or has detected are looked at; the
+ * monster index keeps track of those as their visibility changes.
  */
 void monster_list_collect(monster_list_t *list)
 {
-	int i;
+	const int16_t *seen;
+	int i, n;
 
 	if (list == NULL || list->entries == NULL)
 		return;
@@ -145,34 +226,26 @@ void monster_list_collect(monster_list_t *list)
 	if (!monster_list_can_update(list))
 		return;
 
-	/* Use cave_monster_max() here in case the monster list isn't compacted. */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
-		monster_list_entry_t *entry = NULL;
-		int j, field;
+	monster_list_buckets_reset(list);
+
+	/* The seen monsters come in order of index, as in the monster list */
+	n = mon_index_seen(cave, &seen);
+	for (i = 0; i < n; i++) {
+		struct monster *mon;
+		monster_list_entry_t *entry;
+		int field;
 		bool los = false;
 
 		/* Only consider visible, known monsters */
-		if (!monster_is_visible(mon) ||	monster_is_camouflaged(mon))
+		if (seen[i] >= cave_monster_max(cave))
+			continue;
+		mon = cave_monster(cave, seen[i]);
+		if (!mon->race || !monster_is_visible(mon) ||
+			monster_is_camouflaged(mon))
 			continue;
 
 		/* Find or add a list entry. */
-		for (j = 0; j < (int)list->entries_size; j++) {
-			if (list->entries[j].race == NULL) {
-				/* We found an empty slot, so add this race here. */
-				entry = &list->entries[j];
-				memset(entry, 0, sizeof(monster_list_entry_t));
-				entry->race = mon->race;
-				entry->p_race = mon->player_race;
-				break;
-			} else if ((list->entries[j].race == mon->race) &&
-					   (list->entries[j].p_race == mon->player_race)) {
-				/* We found a matching race and we'll use that. */
-				entry = &list->entries[j];
-				break;
-			}
-		}
-
+		entry = monster_list_entry_for(list, mon->race, mon->player_race);
 		if (entry == NULL)
 			continue;
 
@@ -185,9 +258,9 @@ void monster_list_collect(monster_list_t *list)
 		 * Check for LOS
 		 * Hack - we should use (mon->mflag & (MFLAG_VIEW)) here,
 		 * but this does not catch monsters detected by ESP which are
-		 * targetable, so we cheat and use projectable() instead
+		 * targetable, so we use the player's view of the grid instead
 		 */
-		los = projectable(cave, player->grid, mon->grid, PROJECT_NONE);
+		los = square_isview(cave, mon->grid);
 		field = (los) ? MONSTER_LIST_SECTION_LOS : MONSTER_LIST_SECTION_ESP;
 		entry->count[field]++;
 
@@ -203,10 +276,7 @@ void monster_list_collect(monster_list_t *list)
 	}
 
 	/* Collect totals for easier calculations of the list. */
-	for (i = 0; i < (int)list->entries_size; i++) {
-		if (list->entries[i].race == NULL)
-			continue;
-
+	for (i = 0; i < (int)list->distinct_entries; i++) {
 		if (list->entries[i].count[MONSTER_LIST_SECTION_LOS] > 0)
 			list->total_entries[MONSTER_LIST_SECTION_LOS]++;
 
@@ -217,7 +287,6 @@ void monster_list_collect(monster_list_t *list)
 			list->entries[i].count[MONSTER_LIST_SECTION_LOS];
 		list->total_monsters[MONSTER_LIST_SECTION_ESP] +=
 			list->entries[i].count[MONSTER_LIST_SECTION_ESP];
-		list->distinct_entries++;
 	}
 
 	list->creation_turn = turn;
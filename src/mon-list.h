@@ -41,6 +41,8 @@ typedef struct monster_list_entry_s {
 typedef struct monster_list_s {
 	monster_list_entry_t *entries;
 	size_t entries_size;
+	int *buckets;			/* Entry (plus one) for each race, hashed */
+	size_t buckets_size;
 	uint16_t distinct_entries;
 	int32_t creation_turn;
 	bool sorted;
@@ -19,11 +19,14 @@
 #include "angband.h"
 #include "alloc.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "mon-group.h"
+#include "mon-index.h"
 #include "mon-lore.h"
 #include "mon-make.h"
 #include "mon-predicate.h"
+#include "mon-sched.h"
 #include "mon-spell.h"
 #include "mon-timed.h"
 #include "mon-util.h"
@@ -741,6 +744,9 @@ bool prepare_ghost(struct chunk *c, int r_idx, struct monster *mon,
 	if ((race->level < c->depth - 5) && (from_savefile == false))
 		return false;
 
+	/* No ghosts in levels made ahead of time */
+	if (level_guessing) return false;
+
 	/* Store the index of the base race. */
 	c->ghost->race = r_idx;
 
@@ -938,8 +944,10 @@ void delete_monster_idx(struct chunk *c, int m_idx)
 		(void) player_clear_timed(player, TMD_COMMAND, true, true);
 	}
 
-	/* Monster is gone from square and group, and no longer targeted */
+	/* Monster is gone from square, group and schedule, and no longer
+	 * targeted */
 	square_set_mon(c, grid, 0);
+	mon_sched_remove(c, mon);
 	monster_remove_from_groups(c, mon);
 	monster_remove_from_targets(c, mon);
 
@@ -1046,6 +1054,10 @@ void monster_index_move(struct chunk *c, int i1, int i2)
 	mon = cave_monster(c, i1);
 	if (!mon) return;
 
+	/* The schedule and spatial index are indexed by monster, so retire them */
+	mon_sched_flush(c);
+	mon_index_free(c);
+
 	/* Update the cave */
 	square_set_mon(c, mon->grid, i2);
 
@@ -1170,15 +1182,13 @@ void compact_monsters(struct chunk *c, int num_to_compact)
 
 
 /**
- * Deletes all the monsters when the player leaves the level.
- *
- * This is an efficient method of simulating multiple calls to the
- * "delete_monster()" function, with no visual effects.
+ * Deletes all the monsters in a chunk, leaving the target, the monster health
+ * tracking and the player ghost record alone.
  *
- * Note that we must delete the objects the monsters are carrying, but we
- * do nothing with mimicked objects.
+ * This is what throwing away a level made ahead of time needs, as those
+ * belong to the current level.
  */
-void wipe_mon_list(struct chunk *c, struct player *p)
+void wipe_mon_chunk(struct chunk *c, struct player *p)
 {
 	int m_idx, i;
 
@@ -1245,10 +1255,6 @@ void wipe_mon_list(struct chunk *c, struct player *p)
 		memset(mon, 0, sizeof(struct monster));
 	}
 
-	/* Delete the player ghost record completely */
-	mem_free(r_info[PLAYER_GHOST_RACE].blow);
-	memset(&r_info[PLAYER_GHOST_RACE], 0, sizeof(struct monster_race));
-
 	/* Delete all the monster groups */
 	for (i = 1; i < z_info->level_monster_max; i++) {
 		if (c->monster_groups[i]) {
@@ -1256,6 +1262,10 @@ void wipe_mon_list(struct chunk *c, struct player *p)
 		}
 	}
 
+	/* Nothing left to schedule or index */
+	mon_sched_free(c);
+	mon_index_free(c);
+
 	/* Reset "cave->mon_max" */
 	c->mon_max = 1;
 
@@ -1264,6 +1274,24 @@ void wipe_mon_list(struct chunk *c, struct player *p)
 
 	/* Reset "reproducer" count */
 	c->num_repro = 0;
+}
+
+/**
+ * Deletes all the monsters when the player leaves the level.
+ *
+ * This is an efficient method of simulating multiple calls to the
+ * "delete_monster()" function, with no visual effects.
+ *
+ * Note that we must delete the objects the monsters are carrying, but we
+ * do nothing with mimicked objects.
+ */
+void wipe_mon_list(struct chunk *c, struct player *p)
+{
+	wipe_mon_chunk(c, p);
+
+	/* Delete the player ghost record completely */
+	mem_free(r_info[PLAYER_GHOST_RACE].blow);
+	memset(&r_info[PLAYER_GHOST_RACE], 0, sizeof(struct monster_race));
 
 	/* No more target */
 	target_set_monster(0);
@@ -1755,6 +1783,9 @@ int16_t place_monster(struct chunk *c, struct loc grid, struct monster *mon,
 	/* Assign monster to its monster group, or update its entry */
 	monster_group_assign(c, new_mon, info, loading);
 
+	/* Give it its turns */
+	mon_sched_add(c, new_mon);
+
 	update_mon(new_mon, c, true);
 
 	/* Count the number of "reproducers" */
@@ -35,6 +35,7 @@
 #include "mon-make.h"
 #include "mon-move.h"
 #include "mon-predicate.h"
+#include "mon-sched.h"
 #include "mon-spell.h"
 #include "mon-util.h"
 #include "mon-timed.h"
@@ -50,6 +51,9 @@
 #include "player-util.h"
 #include "project.h"
 #include "trap.h"
+#include "z-profile.h"
+
+PROFILE_COUNTER(process_monsters, "monsters");
 
 
 /**
@@ -1896,30 +1900,42 @@ static void monster_turn(struct monster *mon)
  * gets a turn, and/or to decide whether it gets a turn
  * ------------------------------------------------------------------------ */
 /**
- * Determine whether a monster is active or passive
+ * Check whether anything would make a monster active
  */
-static bool monster_check_active(struct monster *mon)
+static bool monster_has_reason_to_act(struct monster *mon)
 {
 	if ((mon->cdis <= mon->race->hearing) && monster_passes_walls(mon)) {
 		/* Character is inside scanning range, monster can go straight there */
-		mflag_on(mon->mflag, MFLAG_ACTIVE);
+		return true;
 	} else if (mon->hp < mon->maxhp) {
 		/* Monster is hurt */
-		mflag_on(mon->mflag, MFLAG_ACTIVE);
+		return true;
 	} else if (square_isview(cave, mon->grid)) {
 		/* Monster can "see" the player (checked backwards) */
-		mflag_on(mon->mflag, MFLAG_ACTIVE);
+		return true;
 	} else if (monster_can_hear(mon)) {
 		/* Monster can hear the player */
-		mflag_on(mon->mflag, MFLAG_ACTIVE);
+		return true;
 	} else if (monster_can_smell(mon)) {
 		/* Monster can smell the player */
-		mflag_on(mon->mflag, MFLAG_ACTIVE);
+		return true;
 	} else if (monster_taking_terrain_damage(cave, mon)) {
 		/* Monster is taking damage from the terrain */
+		return true;
+	}
+
+	/* Otherwise go passive */
+	return false;
+}
+
+/**
+ * Determine whether a monster is active or passive
+ */
+static bool monster_check_active(struct monster *mon)
+{
+	if (monster_has_reason_to_act(mon)) {
 		mflag_on(mon->mflag, MFLAG_ACTIVE);
 	} else {
-		/* Otherwise go passive */
 		mflag_off(mon->mflag, MFLAG_ACTIVE);
 	}
 
@@ -2080,6 +2096,106 @@ static void regen_monster(struct monster *mon, int num)
  * ------------------------------------------------------------------------
  * Monster processing routines to be called by the main game loop
  * ------------------------------------------------------------------------ */
+/**
+ * The energy a monster gains each game turn at its current speed.
+ */
+int monster_energy_gain(const struct monster *mon)
+{
+	int mspeed = mon->mspeed;
+
+	if (mon->m_timed[MON_TMD_FAST])
+		mspeed += 10;
+	if (mon->m_timed[MON_TMD_SLOW]) {
+		int slow_level = monster_effect_level(mon, MON_TMD_SLOW);
+		mspeed -= (2 * slow_level);
+	}
+
+	return turn_energy(mspeed);
+}
+
+/**
+ * Check whether a monster will do nothing but use up energy on its turns
+ * until something disturbs it, provided the player stays well away.  It
+ * must be asleep, not hunting another monster, and have no reason to become
+ * active right now.
+ */
+bool monster_can_lie_dormant(struct monster *mon)
+{
+	if (!mon->m_timed[MON_TMD_SLEEP]) return false;
+	if (mon->target.midx != -1) return false;
+	if (mflag_has(mon->mflag, MFLAG_ACTIVE)) return false;
+	if (monster_is_mimicking(mon)) return false;
+	return !monster_has_reason_to_act(mon);
+}
+
+/**
+ * Energize a single monster, and let it act if it has enough energy.
+ */
+static void process_monster(struct monster *mon, int minimum_energy,
+		bool regen)
+{
+	bool moving;
+
+	/* Ignore monsters that have already been handled */
+	if (mflag_has(mon->mflag, MFLAG_HANDLED))
+		return;
+
+	/* Not enough energy to move yet */
+	if (mon->energy < minimum_energy) return;
+
+	/* Does this monster have enough energy to move? */
+	moving = mon->energy >= z_info->move_energy ? true : false;
+
+	/* Prevent reprocessing */
+	mflag_on(mon->mflag, MFLAG_HANDLED);
+
+	/* Handle monster regeneration if requested */
+	if (regen)
+		regen_monster(mon, 1);
+
+	/* Give this monster some energy */
+	mon->energy += monster_energy_gain(mon);
+
+	/* End the turn of monsters without enough energy to move */
+	if (!moving)
+		return;
+
+	/* Use up "some" energy */
+	mon->energy -= z_info->move_energy;
+
+	/* Mimics lie in wait */
+	if (monster_is_mimicking(mon)) return;
+
+	/* Check if the monster is active */
+	if (monster_check_active(mon)) {
+		/* Process timed effects - skip turn if necessary */
+		if (process_monster_timed(mon))
+			return;
+
+		/*
+		 * Cannot break (only want to do so when it is the
+		 * player's turn to act), but keep the user interface
+		 * responsive.
+		 */
+		(void)check_break(false, 0);
+
+		/* Set this monster to be the current actor */
+		cave->mon_current = mon->midx;
+
+		/* The monster takes its turn */
+		monster_turn(mon);
+
+		/*
+		 * For symmetry with the player, monster can take
+		 * terrain damage after its turn.
+		 */
+		monster_take_terrain_damage(mon);
+
+		/* Monster is no longer current */
+		cave->mon_current = -1;
+	}
+}
+
 /**
  * Process all the "live" monsters, once per game turn.
  *
@@ -2087,118 +2203,73 @@ static void regen_monster(struct monster *mon, int num)
  * (backwards, so we can excise any "freshly dead" monsters), energizing each
  * monster, and allowing fully energized monsters to move, attack, pass, etc.
  *
+ * When the level has a monster schedule (see mon-sched.c), only the monsters
+ * with enough energy to move (or, when regenerating, all those which aren't
+ * dormant) are visited, in the same order; the rest have their energy
+ * credited lazily.
+ *
  * This function and its children are responsible for a considerable fraction
  * of the processor time in normal situations, greater if the character is
  * resting.
  */
 void process_monsters(int minimum_energy)
 {
-	int i;
-	int mspeed;
+	int i, moved = 0;
 
 	/* Only process some things every so often */
 	bool regen = false;
+	PROFILE_START(process_monsters);
 
 	/* Regenerate hitpoints and mana every 100 game turns */
 	if (turn % 100 == 0)
 		regen = true;
 
 	/* Process the monsters (backwards) */
+	mon_sched_begin_pass(cave, minimum_energy, regen);
 	for (i = cave_monster_max(cave) - 1; i >= 1; i--) {
 		struct monster *mon;
-		bool moving;
 
 		/* Handle "leaving" */
 		if (player->is_dead || player->upkeep->generate_level) break;
 
+		/* Skip straight to the next monster due to move */
+		if (cave->sched) {
+			i = mon_sched_next(cave, i);
+			if (!i) break;
+		}
+
 		/* Get a 'live' monster */
 		mon = cave_monster(cave, i);
 		if (!mon->race) continue;
 
-		/* Ignore monsters that have already been handled */
-		if (mflag_has(mon->mflag, MFLAG_HANDLED))
-			continue;
-
-		/* Not enough energy to move yet */
-		if (mon->energy < minimum_energy) continue;
-
-		/* Does this monster have enough energy to move? */
-		moving = mon->energy >= z_info->move_energy ? true : false;
-
-		/* Prevent reprocessing */
-		mflag_on(mon->mflag, MFLAG_HANDLED);
-
-		/* Handle monster regeneration if requested */
-		if (regen)
-			regen_monster(mon, 1);
-
-		/* Calculate the net speed */
-		mspeed = mon->mspeed;
-		if (mon->m_timed[MON_TMD_FAST])
-			mspeed += 10;
-		if (mon->m_timed[MON_TMD_SLOW]) {
-			int slow_level = monster_effect_level(mon, MON_TMD_SLOW);
-			mspeed -= (2 * slow_level);
-		}
-
-		/* Give this monster some energy */
-		mon->energy += turn_energy(mspeed);
-
-		/* End the turn of monsters without enough energy to move */
-		if (!moving)
-			continue;
-
-		/* Use up "some" energy */
-		mon->energy -= z_info->move_energy;
-
-		/* Mimics lie in wait */
-		if (monster_is_mimicking(mon)) continue;
-
-		/* Check if the monster is active */
-		if (monster_check_active(mon)) {
-			/* Process timed effects - skip turn if necessary */
-			if (process_monster_timed(mon))
-				continue;
-
-			/*
-			 * Cannot break (only want to do so when it is the
-			 * player's turn to act), but keep the user interface
-			 * responsive.
-			 */
-			(void)check_break(false, 0);
-
-			/* Set this monster to be the current actor */
-			cave->mon_current = i;
-
-			/* The monster takes its turn */
-			monster_turn(mon);
-
-			/*
-			 * For symmetry with the player, monster can take
-			 * terrain damage after its turn.
-			 */
-			monster_take_terrain_damage(mon);
-
-			/* Monster is no longer current */
-			cave->mon_current = -1;
-		}
+		process_monster(mon, minimum_energy, regen);
+		mon_sched_done(cave, mon);
+		moved++;
 	}
+	mon_sched_end_pass(cave, i);
 
 	/* Update monster visibility after this */
 	/* XXX This may not be necessary */
 	player->upkeep->update |= PU_MONSTERS;
+	PROFILE_STOP(process_monsters, moved);
 }
 
 /**
  * Clear 'moved' status from all monsters.
  *
- * Clear noise if appropriate.
+ * If the level has a monster schedule this just starts its next turn;
+ * otherwise the flags are cleared by hand and a schedule is built.
  */
 void reset_monsters(void)
 {
 	int i;
 	struct monster *mon;
 
+	if (cave->sched) {
+		mon_sched_new_turn(cave);
+		return;
+	}
+
 	/* Process the monsters (backwards) */
 	for (i = cave_monster_max(cave) - 1; i >= 1; i--) {
 		/* Access the monster */
@@ -2207,6 +2278,9 @@ void reset_monsters(void)
 		/* Monster is ready to go again */
 		mflag_off(mon->mflag, MFLAG_HANDLED);
 	}
+
+	/* Schedule them from here on */
+	mon_sched_build(cave);
 }
 
 /**
@@ -26,6 +26,8 @@ enum monster_stagger {
 };
 
 bool multiply_monster(const struct monster *mon);
+int monster_energy_gain(const struct monster *mon);
+bool monster_can_lie_dormant(struct monster *mon);
 void process_monsters(int minimum_energy);
 void reset_monsters(void);
 void restore_monsters(void);
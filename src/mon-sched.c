@@ -0,0 +1,728 @@
+/**
+ * \file mon-sched.c
+ * \brief Energy-ordered scheduling of monster turns
+ *
+ * process_monsters() is called at least once every game turn, and each call
+ * used to visit every monster on the level just to hand out energy.  Most
+ * monsters spend most game turns doing nothing except gaining that energy,
+ * which (for a monster which isn't acting) is a simple linear function of
+ * time.  The scheduler keeps those monsters out of the way, crediting their
+ * energy lazily, and only hands process_monsters() the monsters which have
+ * enough energy to move this turn, in the same (descending index) order the
+ * full scan would have visited them.
+ *
+ * Time is counted in scheduler turns, each of which runs from one call of
+ * reset_monsters() to the next.  For each monster we record the first turn
+ * whose energy has not yet been credited, and the turn at which it will
+ * next have enough energy to move.  Monsters which are due to move sit in a
+ * bitmap of monster indices for the current turn; the others are kept on a
+ * timing wheel keyed by their due turn.
+ *
+ * On the turns when monsters regenerate, every monster has to be visited in
+ * order, so those passes walk a bitmap of all the monsters which are awake
+ * instead of the due ones.
+ *
+ * Monsters which are asleep, unhurt and well beyond the range at which they
+ * could see, hear or smell the player do nothing at all when they get a
+ * move, except use up the energy.  These are moved into a dormant set, out
+ * of the way of the passes entirely; their energy (including the moves they
+ * would have wasted) is worked out in closed form when something wakes them.
+ * Dormant monsters are kept on a second wheel, keyed by how far the player
+ * has to walk before they could possibly come into range.  Anything else
+ * that could make one of them active (damage, a timed effect, a change of
+ * terrain or target, being moved) calls mon_sched_wake() for it.
+ *
+ * The scheduler is only ever an accelerator: mon_sched_flush() writes the
+ * lazily credited energy and the "handled" status back into the monsters
+ * and discards it, after which the plain full scan is used until the next
+ * call to reset_monsters() builds a fresh one.  This is done whenever the
+ * monster list is saved, reordered or left behind, so the results match the
+ * full scan exactly.
+ *
+ * Anything which changes a monster's energy or speed while the scheduler is
+ * live must call mon_sched_sync() before the change and mon_sched_update()
+ * after it.
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "cave.h"
+#include "init.h"
+#include "mon-move.h"
+#include "mon-sched.h"
+#include "monster.h"
+#include "player.h"
+
+/**
+ * Number of slots in the timing wheel; must be a power of two.  Monsters due
+ * further ahead than this are parked in the last slot and re-filed when it
+ * comes round.  The dormant wheel, keyed by the distance the player has
+ * walked, uses the same number of slots after those of the timing wheel.
+ */
+#define SCHED_WHEEL_SIZE 128
+
+/**
+ * A pass of process_monsters() this turn: its minimum energy, and the index
+ * it stopped at (0 if it went right through)
+ */
+struct sched_pass {
+	int min;
+	int stop;
+};
+
+struct mon_sched {
+	uint32_t turn;			/* Current scheduler turn */
+	int max;				/* Number of monster slots covered */
+
+	uint32_t *credit;		/* First turn not yet credited with energy */
+	uint32_t *checked;		/* Turn it was last found not to be handled */
+	int16_t *checked_pass;	/* The first pass that turn not yet looked at */
+	uint32_t *due;			/* Turn the monster next moves, 0 if never;
+							 * for dormant monsters, the odometer reading
+							 * at which to look at them again */
+	int16_t *next;			/* Wheel links, 0 terminated */
+	int16_t *prev;
+	int16_t *slot;			/* Wheel slot, or -1 */
+	int16_t wheel[2 * SCHED_WHEEL_SIZE];
+
+	uint32_t *now;			/* Bitmap of monsters due this turn */
+	uint32_t *awake;		/* Bitmap of monsters which aren't dormant */
+	int words;
+
+	uint32_t odometer;		/* Distance the player has walked */
+	struct loc player_grid;	/* Where the player was last seen */
+	int num_dormant;
+
+	bool in_pass;			/* Inside process_monsters() */
+	bool regen;				/* Pass is visiting every awake monster */
+	int pass_min;			/* Its minimum energy */
+	int cursor;				/* Index of the monster being processed */
+	struct sched_pass *passes;	/* Passes finished this turn */
+	int num_passes;
+	int max_passes;
+};
+
+/**
+ * ------------------------------------------------------------------------
+ * Internal helpers
+ * ------------------------------------------------------------------------ */
+static bool sched_owns(struct chunk *c, const struct monster *mon)
+{
+	struct mon_sched *s = c->sched;
+
+	return s && mon->midx > 0 && mon->midx < s->max &&
+		cave_monster(c, mon->midx) == mon;
+}
+
+static bool sched_is_dormant(struct mon_sched *s, int idx)
+{
+	return s->slot[idx] >= SCHED_WHEEL_SIZE;
+}
+
+static void sched_unlink(struct mon_sched *s, int idx)
+{
+	int slot = s->slot[idx];
+
+	s->now[idx / 32] &= ~(1U << (idx % 32));
+	if (slot < 0) return;
+
+	if (s->prev[idx]) {
+		s->next[s->prev[idx]] = s->next[idx];
+	} else {
+		s->wheel[slot] = s->next[idx];
+	}
+	if (s->next[idx]) {
+		s->prev[s->next[idx]] = s->prev[idx];
+	}
+	s->next[idx] = 0;
+	s->prev[idx] = 0;
+	s->slot[idx] = -1;
+}
+
+static void sched_link(struct mon_sched *s, int idx, int slot)
+{
+	s->slot[idx] = slot;
+	s->prev[idx] = 0;
+	s->next[idx] = s->wheel[slot];
+	if (s->wheel[slot]) {
+		s->prev[s->wheel[slot]] = idx;
+	}
+	s->wheel[slot] = idx;
+}
+
+static void sched_file(struct mon_sched *s, int idx)
+{
+	uint32_t when = s->due[idx];
+
+	if (when <= s->turn) {
+		s->now[idx / 32] |= 1U << (idx % 32);
+		return;
+	}
+
+	/* Far future monsters wait in the slot that comes round last */
+	if (when - s->turn >= SCHED_WHEEL_SIZE) {
+		when = s->turn + SCHED_WHEEL_SIZE - 1;
+	}
+	sched_link(s, idx, when & (SCHED_WHEEL_SIZE - 1));
+}
+
+static void sched_file_dormant(struct mon_sched *s, int idx)
+{
+	uint32_t when = s->due[idx];
+
+	if (when - s->odometer >= SCHED_WHEEL_SIZE) {
+		when = s->odometer + SCHED_WHEEL_SIZE - 1;
+	}
+	sched_link(s, idx, SCHED_WHEEL_SIZE + (when & (SCHED_WHEEL_SIZE - 1)));
+}
+
+/**
+ * Take the list of monsters in a wheel slot, leaving the slot empty
+ */
+static int sched_take_slot(struct mon_sched *s, int slot)
+{
+	int idx = s->wheel[slot];
+	int i;
+
+	s->wheel[slot] = 0;
+	for (i = idx; i; i = s->next[i]) {
+		s->slot[i] = -1;
+	}
+	return idx;
+}
+
+/**
+ * Whether a pass this turn has gone over a monster which hasn't been credited
+ * for the turn, while it had the energy to be handled.  Energy only changes
+ * after a call to this (through mon_sched_sync()), so the passes are only
+ * looked at once each, with the energy the monster had when they went by.
+ */
+static bool sched_passed(struct mon_sched *s, const struct monster *mon)
+{
+	int idx = mon->midx;
+	int first = (s->checked[idx] == s->turn) ? s->checked_pass[idx] : 0;
+	bool passing = s->in_pass && idx > s->cursor;
+	int i;
+
+	for (i = first; i < s->num_passes; i++) {
+		if (idx > s->passes[i].stop && mon->energy >= s->passes[i].min) {
+			return true;
+		}
+	}
+	if (passing && first <= s->num_passes && mon->energy >= s->pass_min) {
+		return true;
+	}
+	s->checked[idx] = s->turn;
+	s->checked_pass[idx] = s->num_passes + (passing ? 1 : 0);
+	return false;
+}
+
+/**
+ * Credit a monster with the energy it would have gained in the turns it was
+ * left alone.  A monster which a pass of process_monsters() would already
+ * have handled this turn gets the current turn as well.
+ */
+static void sched_credit(struct mon_sched *s, struct monster *mon)
+{
+	int idx = mon->midx;
+	int gain = monster_energy_gain(mon);
+
+	if (s->credit[idx] < s->turn) {
+		mon->energy += (s->turn - s->credit[idx]) * gain;
+		s->credit[idx] = s->turn;
+	}
+	if (s->credit[idx] == s->turn && sched_passed(s, mon)) {
+		mon->energy += gain;
+		s->credit[idx]++;
+	}
+}
+
+/**
+ * Work out when a monster will next have enough energy to move, and file it
+ */
+static void sched_place(struct mon_sched *s, struct monster *mon)
+{
+	int idx = mon->midx;
+	int need = z_info->move_energy - mon->energy;
+	int gain = monster_energy_gain(mon);
+
+	sched_unlink(s, idx);
+	if (need <= 0) {
+		s->due[idx] = s->credit[idx];
+	} else if (gain > 0) {
+		s->due[idx] = s->credit[idx] + (need + gain - 1) / gain;
+	} else {
+		/* Never moves unless something changes its speed */
+		s->due[idx] = 0;
+		return;
+	}
+	sched_file(s, idx);
+}
+
+/**
+ * Find the highest index monster at or below from which is in a bitmap
+ */
+static int sched_highest(const uint32_t *map, int from)
+{
+	int word = from / 32;
+	uint32_t bits;
+
+	if (from <= 0) return 0;
+	bits = map[word] & (0xFFFFFFFFU >> (31 - (from % 32)));
+	while (true) {
+		if (bits) {
+			int bit = 31;
+			while (!(bits & (1U << bit))) bit--;
+			return word * 32 + bit;
+		}
+		if (--word < 0) return 0;
+		bits = map[word];
+	}
+}
+
+/**
+ * The range inside which a monster might notice the player; any closer and
+ * it could see the player's grid, hear the player or find fresh scent.
+ */
+static int sched_notice_range(const struct monster *mon)
+{
+	return MAX(MAX(mon->race->hearing, z_info->max_sight), 2);
+}
+
+static int sched_player_dist(const struct monster *mon)
+{
+	return MAX(ABS(mon->grid.y - player->grid.y),
+		ABS(mon->grid.x - player->grid.x));
+}
+
+/**
+ * A monster which has just been handled may become dormant if it will do
+ * nothing but use up energy on its turns until something disturbs it.
+ * Energy of twice the move energy or more would allow two moves in a row,
+ * which the closed form in sched_wake() doesn't allow for.
+ */
+static bool sched_doze(struct chunk *c, struct monster *mon)
+{
+	struct mon_sched *s = c->sched;
+	int idx = mon->midx;
+	int dist = sched_player_dist(mon);
+	int range = sched_notice_range(mon);
+
+	if (dist <= range) return false;
+	if (mon->energy >= 2 * z_info->move_energy) return false;
+	if (!loc_is_zero(cave_find_decoy(c))) return false;
+	if (!monster_can_lie_dormant(mon)) return false;
+
+	sched_unlink(s, idx);
+	s->awake[idx / 32] &= ~(1U << (idx % 32));
+	s->due[idx] = s->odometer + (dist - range);
+	sched_file_dormant(s, idx);
+	s->num_dormant++;
+	return true;
+}
+
+/**
+ * Bring a dormant monster back into the schedule.  Its energy is brought up
+ * to date as though it had been handled by every pass since it went to
+ * sleep, each move simply using up energy; a monster which starts with less
+ * than twice the move energy, and gains no more than the move energy each
+ * turn, has moved once for every full move energy it would have had by the
+ * start of its last turn.
+ */
+static void sched_wake(struct chunk *c, struct monster *mon)
+{
+	struct mon_sched *s = c->sched;
+	int idx = mon->midx;
+	int32_t gain = monster_energy_gain(mon);
+	int32_t move = z_info->move_energy;
+
+	sched_unlink(s, idx);
+	s->awake[idx / 32] |= 1U << (idx % 32);
+	s->num_dormant--;
+
+	/* Catch up to the start of this turn */
+	if (s->credit[idx] < s->turn) {
+		int64_t turns = s->turn - s->credit[idx];
+		int64_t total = mon->energy + (turns - 1) * gain;
+		mon->energy = (uint8_t)(total + gain - move * (total / move));
+		s->credit[idx] = s->turn;
+	}
+
+	/* Work out whether a pass has already handled it this turn */
+	if (s->credit[idx] == s->turn && sched_passed(s, mon)) {
+		bool moving = mon->energy >= move;
+		mon->energy += gain;
+		if (moving) mon->energy -= move;
+		s->credit[idx]++;
+	}
+
+	sched_place(s, mon);
+}
+
+/**
+ * Wake every dormant monster
+ */
+static void sched_wake_all(struct chunk *c)
+{
+	struct mon_sched *s = c->sched;
+	int slot;
+
+	for (slot = SCHED_WHEEL_SIZE; slot < 2 * SCHED_WHEEL_SIZE; slot++) {
+		int idx = s->wheel[slot];
+		while (idx) {
+			int next = s->next[idx];
+			sched_wake(c, cave_monster(c, idx));
+			idx = next;
+		}
+	}
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Setting up and tearing down
+ * ------------------------------------------------------------------------ */
+/**
+ * Build a scheduler for a chunk.  This must be called at the start of a
+ * turn, when no monster has been handled.
+ */
+void mon_sched_build(struct chunk *c)
+{
+	struct mon_sched *s;
+	int i;
+
+	mon_sched_free(c);
+	s = mem_zalloc(sizeof(*s));
+	s->max = z_info->level_monster_max;
+	s->turn = 1;
+	s->credit = mem_zalloc(s->max * sizeof(uint32_t));
+	s->checked = mem_zalloc(s->max * sizeof(uint32_t));
+	s->checked_pass = mem_zalloc(s->max * sizeof(int16_t));
+	s->due = mem_zalloc(s->max * sizeof(uint32_t));
+	s->next = mem_zalloc(s->max * sizeof(int16_t));
+	s->prev = mem_zalloc(s->max * sizeof(int16_t));
+	s->slot = mem_alloc(s->max * sizeof(int16_t));
+	s->words = (s->max + 31) / 32;
+	s->now = mem_zalloc(s->words * sizeof(uint32_t));
+	s->awake = mem_zalloc(s->words * sizeof(uint32_t));
+	s->player_grid = player->grid;
+	s->cursor = -1;
+	for (i = 0; i < s->max; i++) {
+		s->slot[i] = -1;
+	}
+	c->sched = s;
+
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race) continue;
+		s->credit[i] = s->turn;
+		s->awake[i / 32] |= 1U << (i % 32);
+		sched_place(s, mon);
+	}
+}
+
+/**
+ * Write the lazily credited energy and handled status back to the monsters
+ * and discard the scheduler.
+ */
+void mon_sched_flush(struct chunk *c)
+{
+	struct mon_sched *s = c->sched;
+	int i;
+
+	if (!s) return;
+	sched_wake_all(c);
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race) continue;
+		sched_credit(s, mon);
+		if (s->credit[i] > s->turn) {
+			mflag_on(mon->mflag, MFLAG_HANDLED);
+		}
+	}
+	mon_sched_free(c);
+}
+
+/**
+ * Discard a scheduler without writing anything back
+ */
+void mon_sched_free(struct chunk *c)
+{
+	struct mon_sched *s = c->sched;
+
+	if (!s) return;
+	mem_free(s->credit);
+	mem_free(s->checked);
+	mem_free(s->checked_pass);
+	mem_free(s->passes);
+	mem_free(s->due);
+	mem_free(s->next);
+	mem_free(s->prev);
+	mem_free(s->slot);
+	mem_free(s->now);
+	mem_free(s->awake);
+	mem_free(s);
+	c->sched = NULL;
+}
+
+/**
+ * Start a new turn, moving the monsters which become due out of the wheel
+ */
+void mon_sched_new_turn(struct chunk *c)
+{
+	struct mon_sched *s = c->sched;
+	int slot, idx;
+
+	if (!s) return;
+	s->turn++;
+	s->num_passes = 0;
+	slot = s->turn & (SCHED_WHEEL_SIZE - 1);
+	idx = s->wheel[slot];
+	while (idx) {
+		int next = s->next[idx];
+		sched_unlink(s, idx);
+		sched_file(s, idx);
+		idx = next;
+	}
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Running process_monsters()
+ * ------------------------------------------------------------------------ */
+/**
+ * Start a pass of process_monsters() with the given minimum energy; a pass
+ * in which monsters regenerate has to visit all of them.
+ */
+void mon_sched_begin_pass(struct chunk *c, int minimum_energy, bool regen)
+{
+	struct mon_sched *s = c->sched;
+
+	if (!s) return;
+
+	/* Catch any player movement or decoy that slipped past unnoticed */
+	mon_sched_player_moved(c);
+	if (s->num_dormant && !loc_is_zero(cave_find_decoy(c))) {
+		sched_wake_all(c);
+	}
+
+	s->in_pass = true;
+	s->regen = regen;
+	s->pass_min = minimum_energy;
+	s->cursor = cave_monster_max(c);
+}
+
+/**
+ * Return the next monster, at or below index from, which process_monsters()
+ * should handle, or 0 if there are none.  Monsters skipped over are treated
+ * as having been passed by the pass.
+ */
+int mon_sched_next(struct chunk *c, int from)
+{
+	struct mon_sched *s = c->sched;
+	const uint32_t *map = s->regen ? s->awake : s->now;
+	int idx = sched_highest(map, from);
+
+	while (idx) {
+		struct monster *mon = cave_monster(c, idx);
+
+		sched_credit(s, mon);
+		if (s->credit[idx] <= s->turn && mon->energy >= s->pass_min) {
+			break;
+		}
+		idx = sched_highest(map, idx - 1);
+	}
+	s->cursor = idx;
+	return idx;
+}
+
+/**
+ * A monster has been handled by process_monsters(); reschedule it, or let it
+ * go dormant
+ */
+void mon_sched_done(struct chunk *c, struct monster *mon)
+{
+	struct mon_sched *s = c->sched;
+
+	if (!sched_owns(c, mon) || !mon->race) return;
+	if (mflag_has(mon->mflag, MFLAG_HANDLED)) {
+		mflag_off(mon->mflag, MFLAG_HANDLED);
+		s->credit[mon->midx] = s->turn + 1;
+		if (sched_doze(c, mon)) return;
+	}
+	sched_place(s, mon);
+}
+
+/**
+ * Finish a pass of process_monsters().  If a full pass stopped early at
+ * index stop, the monsters at or below that index were never handled, and
+ * so must not be credited with energy for this turn.
+ */
+void mon_sched_end_pass(struct chunk *c, int stop)
+{
+	struct mon_sched *s = c->sched;
+	int i;
+
+	if (!s) return;
+	if (stop > 0) {
+		/* Sort out dormant monsters while it's known who was handled */
+		s->cursor = stop;
+		sched_wake_all(c);
+	}
+	if (!s->pass_min && stop > 0) {
+		for (i = MIN(stop, cave_monster_max(c) - 1); i >= 1; i--) {
+			struct monster *mon = cave_monster(c, i);
+			if (!mon->race || s->credit[i] > s->turn) continue;
+			sched_credit(s, mon);
+			s->credit[i] = s->turn + 1;
+			sched_place(s, mon);
+		}
+	}
+
+	/* Remember the pass for monsters not credited for this turn yet */
+	if (s->num_passes == s->max_passes) {
+		s->max_passes = s->max_passes ? 2 * s->max_passes : 4;
+		s->passes = mem_realloc(s->passes,
+			s->max_passes * sizeof(*s->passes));
+	}
+	s->passes[s->num_passes].min = s->pass_min;
+	s->passes[s->num_passes].stop = MAX(stop, 0);
+	s->num_passes++;
+	s->in_pass = false;
+	s->cursor = -1;
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Keeping up with changes to the monsters
+ * ------------------------------------------------------------------------ */
+/**
+ * Add a newly placed monster.  If a full pass has already gone past its
+ * index it will not be handled, and so gains no energy, this turn.
+ */
+void mon_sched_add(struct chunk *c, struct monster *mon)
+{
+	struct mon_sched *s = c->sched;
+
+	if (!sched_owns(c, mon)) return;
+	s->credit[mon->midx] = s->turn;
+	if (s->in_pass && !s->pass_min && mon->midx >= s->cursor) {
+		s->credit[mon->midx]++;
+	}
+
+	/* Passes before it arrived don't count */
+	s->checked[mon->midx] = s->turn;
+	s->checked_pass[mon->midx] = s->num_passes +
+		((s->in_pass && mon->midx >= s->cursor) ? 1 : 0);
+	s->awake[mon->midx / 32] |= 1U << (mon->midx % 32);
+	sched_place(s, mon);
+}
+
+/**
+ * Remove a monster which is about to be deleted
+ */
+void mon_sched_remove(struct chunk *c, struct monster *mon)
+{
+	struct mon_sched *s = c->sched;
+	int idx = mon->midx;
+
+	if (!sched_owns(c, mon)) return;
+	if (sched_is_dormant(s, idx)) s->num_dormant--;
+	sched_unlink(s, idx);
+	s->awake[idx / 32] &= ~(1U << (idx % 32));
+}
+
+/**
+ * Bring a monster's energy up to date before changing its energy or speed
+ */
+void mon_sched_sync(struct chunk *c, struct monster *mon)
+{
+	if (!sched_owns(c, mon) || !mon->race) return;
+	if (sched_is_dormant(c->sched, mon->midx)) {
+		sched_wake(c, mon);
+	} else {
+		sched_credit(c->sched, mon);
+	}
+}
+
+/**
+ * Reschedule a monster after changing its energy or speed
+ */
+void mon_sched_update(struct chunk *c, struct monster *mon)
+{
+	if (!sched_owns(c, mon) || !mon->race) return;
+	if (sched_is_dormant(c->sched, mon->midx)) {
+		sched_wake(c, mon);
+		return;
+	}
+
+	/* The monster currently acting is rescheduled when it finishes */
+	if (c->sched->in_pass && mon->midx == c->sched->cursor) return;
+	sched_place(c->sched, mon);
+}
+
+/**
+ * Something may have disturbed a monster; if it is dormant, wake it
+ */
+void mon_sched_wake(struct chunk *c, struct monster *mon)
+{
+	if (!sched_owns(c, mon) || !mon->race) return;
+	if (sched_is_dormant(c->sched, mon->midx)) {
+		sched_wake(c, mon);
+	}
+}
+
+/**
+ * The player has moved; look again at the dormant monsters which the player
+ * may have come close enough to disturb
+ */
+void mon_sched_player_moved(struct chunk *c)
+{
+	struct mon_sched *s = c->sched;
+	int dist, i;
+
+	if (!s || loc_eq(s->player_grid, player->grid)) return;
+	dist = MAX(ABS(player->grid.y - s->player_grid.y),
+		ABS(player->grid.x - s->player_grid.x));
+	s->player_grid = player->grid;
+	s->odometer += dist;
+	if (!s->num_dormant) return;
+
+	/* Every slot the odometer has passed may hold monsters to look at */
+	for (i = MIN(dist, SCHED_WHEEL_SIZE) - 1; i >= 0; i--) {
+		int slot = SCHED_WHEEL_SIZE + ((s->odometer - i) & (SCHED_WHEEL_SIZE - 1));
+		int idx = sched_take_slot(s, slot);
+
+		while (idx) {
+			int next = s->next[idx];
+			struct monster *mon = cave_monster(c, idx);
+			int range = sched_notice_range(mon);
+			int mdist = sched_player_dist(mon);
+
+			s->next[idx] = 0;
+			s->prev[idx] = 0;
+			if (s->due[idx] > s->odometer) {
+				/* Parked further ahead than the wheel reaches */
+				sched_file_dormant(s, idx);
+			} else if (mdist > range) {
+				/* Still out of range */
+				s->due[idx] = s->odometer + (mdist - range);
+				sched_file_dormant(s, idx);
+			} else {
+				sched_wake(c, mon);
+			}
+			idx = next;
+		}
+	}
+}
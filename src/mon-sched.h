@@ -0,0 +1,39 @@
+/**
+ * \file mon-sched.h
+ * \brief Energy-ordered scheduling of monster turns
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+#ifndef MON_SCHED_H
+#define MON_SCHED_H
+
+#include "cave.h"
+#include "monster.h"
+
+void mon_sched_build(struct chunk *c);
+void mon_sched_flush(struct chunk *c);
+void mon_sched_free(struct chunk *c);
+void mon_sched_new_turn(struct chunk *c);
+void mon_sched_begin_pass(struct chunk *c, int minimum_energy, bool regen);
+int mon_sched_next(struct chunk *c, int from);
+void mon_sched_done(struct chunk *c, struct monster *mon);
+void mon_sched_end_pass(struct chunk *c, int stop);
+void mon_sched_add(struct chunk *c, struct monster *mon);
+void mon_sched_remove(struct chunk *c, struct monster *mon);
+void mon_sched_sync(struct chunk *c, struct monster *mon);
+void mon_sched_update(struct chunk *c, struct monster *mon);
+void mon_sched_wake(struct chunk *c, struct monster *mon);
+void mon_sched_player_moved(struct chunk *c);
+
+#endif /* !MON_SCHED_H */
@@ -21,6 +21,7 @@
 #include "mon-lore.h"
 #include "mon-msg.h"
 #include "mon-predicate.h"
+#include "mon-sched.h"
 #include "mon-spell.h"
 #include "mon-timed.h"
 #include "mon-util.h"
@@ -158,7 +159,12 @@ static bool mon_set_timed(struct monster *mon,
 	/* No change */
 	if (old_timer == timer) {
 		return false;
-	} else if (timer == 0) {
+	}
+
+	/* Any change brings a dormant monster back into play */
+	mon_sched_wake(cave, mon);
+
+	if (timer == 0) {
 		/* Turning off, usually mention */
 		m_note = effect->message_end;
 		flag |= MON_TMD_FLG_NOTIFY;
@@ -188,7 +194,12 @@ static bool mon_set_timed(struct monster *mon,
 		resisted = true;
 		m_note = MON_MSG_UNAFFECTED;
 	} else {
+		bool speed = effect_type == MON_TMD_FAST ||
+			effect_type == MON_TMD_SLOW;
+
+		if (speed) mon_sched_sync(cave, mon);
 		mon->m_timed[effect_type] = timer;
+		if (speed) mon_sched_update(cave, mon);
 		update = true;
 	}
 
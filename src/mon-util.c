@@ -22,11 +22,13 @@
 #include "game-world.h"
 #include "init.h"
 #include "mon-desc.h"
+#include "mon-index.h"
 #include "mon-list.h"
 #include "mon-lore.h"
 #include "mon-make.h"
 #include "mon-msg.h"
 #include "mon-predicate.h"
+#include "mon-sched.h"
 #include "mon-spell.h"
 #include "mon-summon.h"
 #include "mon-timed.h"
@@ -46,6 +48,10 @@
 #include "player-util.h"
 #include "project.h"
 #include "trap.h"
+#include "z-index.h"
+#include "z-profile.h"
+
+PROFILE_COUNTER(update_monsters, "monsters");
 
 /**
  * ------------------------------------------------------------------------
@@ -111,37 +117,70 @@ void create_mon_flag_mask(bitflag *f, ...)
  * ------------------------------------------------------------------------
  * Lookup utilities
  * ------------------------------------------------------------------------ */
+/**
+ * Indexes of monster races by name, exactly and ignoring case; the names
+ * don't change once r_info is parsed
+ */
+static struct name_index *race_by_name;
+static struct name_index *race_by_folded_name;
+static int races_indexed;
+
+static void race_index_update(void)
+{
+	int i;
+
+	race_index_free();
+	race_by_name = name_index_new(false);
+	race_by_folded_name = name_index_new(true);
+	for (i = 0; i < z_info->r_max; i++) {
+		if (!r_info[i].name) continue;
+		name_index_add(race_by_name, 0, r_info[i].name, i);
+	}
+
+	/* Of races whose names differ only in case, the last is wanted */
+	for (i = z_info->r_max - 1; i >= 0; i--) {
+		if (!r_info[i].name) continue;
+		name_index_add(race_by_folded_name, 0, r_info[i].name, i);
+	}
+	races_indexed = z_info->r_max;
+}
+
+/**
+ * Throw away the monster race indexes, when r_info is freed
+ */
+void race_index_free(void)
+{
+	name_index_free(race_by_name);
+	name_index_free(race_by_folded_name);
+	race_by_name = NULL;
+	race_by_folded_name = NULL;
+	races_indexed = 0;
+}
+
 /**
  * Returns the monster with the given name. If no monster has the exact name
- * given, returns the first monster with the given name as a (case-insensitive)
+ * given, returns the last monster with the name ignoring case, or failing
+ * that the first monster with the given name as a (case-insensitive)
  * substring.
  */
 struct monster_race *lookup_monster(const char *name)
 {
 	int i;
-	struct monster_race *closest = NULL;
 
 	/* Look for it */
+	if (races_indexed != z_info->r_max) race_index_update();
+	i = name_index_find(race_by_name, 0, name);
+	if (i < 0) i = name_index_find(race_by_folded_name, 0, name);
+	if (i >= 0) return &r_info[i];
+
+	/* Test for close matches */
 	for (i = 0; i < z_info->r_max; i++) {
 		struct monster_race *race = &r_info[i];
-		if (!race->name)
-			continue;
 
-		/* Test for equality */
-		if (streq(name, race->name))
-			return race;
-
-		/* Test for near equality */
-		if (my_stricmp(name, race->name) == 0)
-			closest = race;
-
-		/* Test for close matches */
-		if (!closest && my_stristr(race->name, name))
-			closest = race;
+		if (race->name && my_stristr(race->name, name)) return race;
 	}
 
-	/* Return our best match */
-	return closest;
+	return NULL;
 }
 
 /**
@@ -247,6 +286,36 @@ static void path_analyse(struct chunk *c, struct loc grid)
 	}
 }
 
+/**
+ * Update a monster's distance from its target, and any heatmaps it carries
+ */
+static void update_mon_distance(struct monster *mon, struct chunk *c)
+{
+	/* Target */
+	struct loc target = monster_target_loc(mon);
+
+	/* Distance components */
+	int dy = ABS(target.y - mon->grid.y);
+	int dx = ABS(target.x - mon->grid.x);
+
+	/* Approximate distance */
+	int d = (dy > dx) ? (dy + (dx >>  1)) : (dx + (dy >> 1));
+
+	/* Restrict distance */
+	if (d > 255) d = 255;
+
+	/* Save the distance */
+	mon->cdis = d;
+
+	/* Heatmaps */
+	if (mon->noise.grids) {
+		make_noise(c, NULL, mon);
+	}
+	if (mon->scent.grids) {
+		update_scent(c, NULL, mon);
+	}
+}
+
 /**
  * This function updates the monster record of the given monster
  *
@@ -282,10 +351,11 @@ static void path_analyse(struct chunk *c, struct loc grid)
  * function for any monster in that grid, since the "visibility" of some
  * monsters may be based on the illumination of their grid.
  *
- * Note that this function is called once per monster every time the
- * player moves.  When the player is running, this function is one
+ * Note that this function used to be called once per monster every time
+ * the player moved.  When the player is running, this function is one
  * of the primary bottlenecks, along with "update_view()" and the
- * "process_monsters()" code, so efficiency is important.
+ * "process_monsters()" code, so efficiency is important; update_monsters()
+ * now only calls it for monsters which are in range or already visible.
  *
  * Note the optimized "inline" version of the "distance()" function.
  *
@@ -335,32 +405,11 @@ void update_mon(struct monster *mon, struct chunk *c, bool full)
 	}
 
 	lore = get_lore(mon->race);
+	monster_update_count(true);
 	
 	/* Compute distance, or just use the current one; update any heatmaps */
 	if (full) {
-		/* Target */
-		struct loc target = monster_target_loc(mon);
-
-		/* Distance components */
-		dy = ABS(target.y - mon->grid.y);
-		dx = ABS(target.x - mon->grid.x);
-
-		/* Approximate distance */
-		d = (dy > dx) ? (dy + (dx >>  1)) : (dx + (dy >> 1));
-
-		/* Restrict distance */
-		if (d > 255) d = 255;
-
-		/* Save the distance */
-		mon->cdis = d;
-
-		/* Heatmaps */
-		if (mon->noise.grids) {
-			make_noise(c, NULL, mon);
-		}
-		if (mon->scent.grids) {
-			update_scent(c, NULL, mon);
-		}
+		update_mon_distance(mon, c);
 	}
 
 	/* Get the actual distance from the player (mon->cdis is now
@@ -512,23 +561,64 @@ void update_mon(struct monster *mon, struct chunk *c, bool full)
 			player->upkeep->redraw |= PR_MONLIST;
 		}
 	}
+
+	/* Keep track of what the player knows about */
+	mon_index_note_seen(c, mon);
 }
 
 /**
  * Updates all the (non-dead) monsters via update_mon().
+ *
+ * Every monster needs its distance updated if full is set, but only those
+ * within sight (or telepathy) range of the player, or which the player can
+ * currently see or has detected, can change their visibility; the rest are
+ * left alone.
  */
 void update_monsters(bool full)
 {
-	int i;
+	const int16_t *near;
+	int i, n;
+	PROFILE_START(update_monsters);
 
-	/* Update each (live) monster */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
+	/* Update the distance of each (live) monster */
+	if (full) {
+		for (i = 1; i < cave_monster_max(cave); i++) {
+			struct monster *mon = cave_monster(cave, i);
+			if (mon->race)
+				update_mon_distance(mon, cave);
+		}
+	}
+
+	/* Update the visibility of those that could have changed */
+	n = mon_index_gather(cave, player->grid, z_info->max_sight, true, &near);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, near[i]);
 
 		/* Update the monster if alive */
 		if (mon->race)
-			update_mon(mon, cave, full);
+			update_mon(mon, cave, false);
+	}
+	PROFILE_STOP(update_monsters, n);
+}
+
+/**
+ * Count calls to update_mon(), returning the number made during the last
+ * game turn (or, if counting a call, the current one)
+ */
+int monster_update_count(bool count)
+{
+	static int32_t count_turn;
+	static int this_turn, last_turn;
+
+	if (count_turn != turn) {
+		last_turn = (count_turn == turn - 1) ? this_turn : 0;
+		this_turn = 0;
+		count_turn = turn;
+	}
+	if (count) {
+		return ++this_turn;
 	}
+	return last_turn;
 }
 
 
@@ -637,6 +727,7 @@ void monster_swap(struct loc grid1, struct loc grid2)
 			}
 		}
 		mon->grid = grid2;
+		mon_sched_wake(cave, mon);
 		update_mon(mon, cave, true);
 
 		/* Affect light? */
@@ -648,6 +739,7 @@ void monster_swap(struct loc grid1, struct loc grid2)
 	} else if (m1 < 0) {
 		/* Player */
 		player->grid = grid2;
+		mon_sched_player_moved(cave);
 		player_leaving(pgrid, player->grid);
 
 		/* Update the trap detection status */
@@ -684,6 +776,7 @@ void monster_swap(struct loc grid1, struct loc grid2)
 			}
 		}
 		mon->grid = grid1;
+		mon_sched_wake(cave, mon);
 		update_mon(mon, cave, true);
 
 		/* Affect light? */
@@ -695,6 +788,7 @@ void monster_swap(struct loc grid1, struct loc grid2)
 	} else if (m2 < 0) {
 		/* Player */
 		player->grid = grid1;
+		mon_sched_player_moved(cave);
 		player_leaving(pgrid, player->grid);
 
 		/* Update the trap detection status */
@@ -1629,6 +1723,7 @@ void steal_monster_item(struct monster *mon, int midx)
 			(void)monster_carry(cave, thief, obj);
 
 			/* Become hostile */
+			mon_sched_wake(cave, mon);
 			mon->target.midx = thief->midx;
 		}
 	}
@@ -1752,7 +1847,9 @@ bool monster_change_shape(struct monster *mon)
 		} else {
 			mon->player_race = NULL;
 		}
+		mon_sched_sync(cave, mon);
 		mon->mspeed += mon->race->speed - mon->original_race->speed;
+		mon_sched_update(cave, mon);
 	}
 
 	/* Emergency teleport if needed */
@@ -1781,7 +1878,9 @@ bool monster_revert_shape(struct monster *mon)
 			player->upkeep->redraw |= (PR_MONLIST);
 			square_light_spot(cave, mon->grid);
 		}
+		mon_sched_sync(cave, mon);
 		mon->mspeed += mon->original_race->speed - mon->race->speed;
+		mon_sched_update(cave, mon);
 		mon->race = mon->original_race;
 		mon->original_race = NULL;
 		mon->player_race = mon->original_player_race;
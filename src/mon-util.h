@@ -24,12 +24,14 @@
 
 const char *describe_race_flag(int flag);
 void create_mon_flag_mask(bitflag *f, ...);
+void race_index_free(void);
 struct monster_race *lookup_monster(const char *name);
 struct monster_base *lookup_monster_base(const char *name);
 struct blow_effect *lookup_monster_blow_effect(const char *eff_name);
 bool match_monster_bases(const struct monster_base *base, ...);
 void update_mon(struct monster *mon, struct chunk *c, bool full);
 void update_monsters(bool full);
+int monster_update_count(bool count);
 bool monster_carry(struct chunk *c, struct monster *mon, struct object *obj);
 void monster_swap(struct loc grid1, struct loc grid2);
 void monster_wake(struct monster *mon, bool notify, int aware_chance);
@@ -25,6 +25,65 @@
 #include "obj-tval.h"
 #include "obj-util.h"
 
+/**
+ * Descriptions made recently.  Menus of the pack, equipment, stores and the
+ * home describe the same objects over and over while nothing changes, so
+ * descriptions are kept until the game turn passes, a command is carried
+ * out, or anything that goes into them (knowledge, ignoring, options, the
+ * objects themselves) may have changed; that bumps the generation, and
+ * descriptions from earlier generations aren't used.  The number, charges,
+ * timeout and inscription are checked as well, since they change most.
+ */
+#define DESC_CACHE_SIZE		256
+#define DESC_CACHE_LEN		96
+
+struct desc_cache_entry {
+	const struct object *obj;
+	const struct object_kind *kind;
+	const struct player *p;
+	uint32_t generation;
+	uint32_t mode;
+	size_t max;
+	int number;
+	int pval;
+	int timeout;
+	quark_t note;
+	size_t len;
+	char text[DESC_CACHE_LEN];
+};
+
+static struct desc_cache_entry desc_cache[DESC_CACHE_SIZE];
+
+/* Start at 1, so the empty entries never match */
+static uint32_t desc_generation = 1;
+
+/**
+ * Stop using the descriptions made so far
+ */
+void object_desc_forget(void)
+{
+	desc_generation++;
+}
+
+static struct desc_cache_entry *desc_cache_entry(const struct object *obj,
+		uint32_t mode, size_t max)
+{
+	uintptr_t hash = ((uintptr_t) obj >> 4) ^ (mode * 31) ^ max;
+
+	return &desc_cache[(hash ^ (hash >> 8)) % DESC_CACHE_SIZE];
+}
+
+static bool desc_cache_match(const struct desc_cache_entry *e,
+		const struct object *obj, uint32_t mode, size_t max,
+		const struct player *p)
+{
+	return e->generation == desc_generation && e->obj == obj
+		&& e->mode == mode && e->max == max && e->p == p
+		&& e->kind == obj->kind && e->number == obj->number
+		&& e->pval == obj->pval && e->timeout == obj->timeout
+		&& e->note == obj->note;
+}
+
 /**
  * Puts the object base kind's name into buf.
  */
@@ -622,6 +681,7 @@ size_t object_desc(char *buf, size_t max, const struct object *obj,
 	bool prefix = mode & ODESC_PREFIX ? true : false;
 	bool spoil = mode & ODESC_SPOIL ? true : false;
 	bool terse = mode & ODESC_TERSE ? true : false;
+	struct desc_cache_entry *cached;
 
 	size_t end = 0;
 
@@ -648,6 +708,13 @@ size_t object_desc(char *buf, size_t max, const struct object *obj,
 	if (object_flavor_is_aware(obj) && !spoil)
 		obj->kind->everseen = true;
 
+	/* Use the description made last time, if nothing has changed */
+	cached = desc_cache_entry(obj, mode, max);
+	if (desc_cache_match(cached, obj, mode, max, p)) {
+		memcpy(buf, cached->text, cached->len + 1);
+		return cached->len;
+	}
+
 	/** Construct the name **/
 
 	/* Copy the base name to the buffer */
@@ -675,5 +742,21 @@ size_t object_desc(char *buf, size_t max, const struct object *obj,
 			end = obj_desc_inscrip(obj, buf, max, end, p);
 	}
 
+	/* Keep the description if it fits */
+	if (end < DESC_CACHE_LEN && end < max) {
+		cached->obj = obj;
+		cached->kind = obj->kind;
+		cached->p = p;
+		cached->generation = desc_generation;
+		cached->mode = mode;
+		cached->max = max;
+		cached->number = obj->number;
+		cached->pval = obj->pval;
+		cached->timeout = obj->timeout;
+		cached->note = obj->note;
+		cached->len = end;
+		memcpy(cached->text, buf, end + 1);
+	}
+
 	return end;
 }
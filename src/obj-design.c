@@ -4037,20 +4037,63 @@ static void write_randart_file_entry(ang_file *fff, const struct artifact *art)
 	file_putf(fff, "\n");
 }
 
+/**
+ * Derive the seed for designing one artifact from the randart seed
+ */
+static uint32_t randart_design_seed(uint32_t randart_seed, int index)
+{
+	uint32_t seed = randart_seed ^ (0x9e3779b9U * (uint32_t) (index + 1));
+
+	seed ^= seed >> 16;
+	seed *= 0x85ebca6bU;
+	seed ^= seed >> 13;
+	seed *= 0xc2b2ae35U;
+	seed ^= seed >> 16;
+	return seed;
+}
+
 /**
  * Initialize all the random artifacts in the artifact array.  This function 
- * is only called when a player is born.
+ * is only called when a player is born, or when the randart file for a
+ * savefile has gone missing.
+ *
+ * With RANDART_SEED_SEPARATE set in the seed, each artifact is designed from
+ * a seed of its own, so depends on nothing but the randart seed and its
+ * place in the list.  Older seeds drive the simple RNG through all the
+ * artifacts in turn, as they always have, so their artifacts don't change.
+ * Either way, the randart file is only written once every artifact has been
+ * designed.
  */
 void initialize_random_artifacts(uint32_t randart_seed)
 {
 	char fname[1024];
 	ang_file *randart_file = NULL;
+	int first = z_info->a_max;
 	int i;
 
 	/* Prepare to use the Angband "simple" RNG. */
 	Rand_value = randart_seed;
 	Rand_quick = true;
 
+	/* Design the artifacts, storing information as we go along */
+	a_info = mem_realloc(a_info, (first + ART_NUM_RANDOM) * sizeof(*a_info));
+	aup_info = mem_realloc(aup_info,
+		(first + ART_NUM_RANDOM) * sizeof(*aup_info));
+	for (i = 0; i < ART_NUM_RANDOM; i++) {
+		struct artifact *art = &a_info[first + i];
+
+		memset(art, 0, sizeof(*art));
+		memset(&aup_info[first + i], 0, sizeof(*aup_info));
+		aup_info[first + i].aidx = first + i;
+
+		if (randart_seed & RANDART_SEED_SEPARATE) {
+			Rand_value = randart_design_seed(randart_seed, i);
+		}
+		design_random_artifact(art);
+		art->aidx = first + i;
+	}
+	z_info->a_max = first + ART_NUM_RANDOM;
+
 	/* Open the file, write a header */
 	path_build(fname, sizeof(fname), ANGBAND_DIR_USER, "randart.txt");
 	randart_file = file_open(fname, MODE_WRITE, FTYPE_TEXT);
@@ -4061,27 +4104,9 @@ void initialize_random_artifacts(uint32_t randart_seed)
 			  "# Artifact file for random artifacts with seed %08lx\n\n\n",
 			  (unsigned long)randart_seed);
 
-	/* Initialize, name and write artifacts to the file */
-	a_info = mem_realloc(a_info,
-		(z_info->a_max + ART_NUM_RANDOM) * sizeof(*a_info));
-	aup_info = mem_realloc(aup_info,
-		(z_info->a_max + ART_NUM_RANDOM) * sizeof(*aup_info));
-	for (i = 0; i < ART_NUM_RANDOM; i++) {
-		/* Extend the artifact array with a zero entry */
-		struct artifact *art;
-		art = &a_info[z_info->a_max];
-		memset(art, 0, sizeof(*art));
-		memset(&aup_info[z_info->a_max], 0, sizeof(*aup_info));
-		aup_info[z_info->a_max].aidx = z_info->a_max;
-
-		/* Design the artifact, storing information as we go along. */
-		design_random_artifact(art);
-		art->aidx = z_info->a_max;
-
-		/* Write the entry to the randart file */
-		write_randart_file_entry(randart_file, art);
-
-		z_info->a_max += 1;
+	/* Write the artifacts to the file, in order */
+	for (i = first; i < z_info->a_max; i++) {
+		write_randart_file_entry(randart_file, &a_info[i]);
 	}
 
 	/* Close the file */
@@ -49,6 +49,14 @@
  */
 #define ART_NUM_RANDOM      40
 
+/**
+ * Marks a randart seed under which each artifact is designed from its own
+ * seed, derived from the randart seed and the artifact's place in the list;
+ * seeds without it are from characters whose artifacts were all designed
+ * one after another from the randart seed itself
+ */
+#define RANDART_SEED_SEPARATE 0x80000000UL
+
 /**
  * Constants used by the artifact naming code.
  */
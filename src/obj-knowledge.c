@@ -64,6 +64,14 @@
  * ------------------------------------------------------------------------ */
 static size_t rune_max;
 static struct rune *rune_list;
+
+/**
+ * Runes learned since objects were last brought up to date, and how deeply
+ * nested the current batch of learning is (see player_learn_rune())
+ */
+static int *rune_pending;
+static int rune_pending_num;
+static int rune_batch;
 static const char *c_rune[] = {
 	"enchantment to armor",
 	"enchantment to hit",
@@ -135,6 +143,8 @@ static void init_rune(void)
 	/* Now allocate and fill the rune list */
 	rune_max = count;
 	rune_list = mem_zalloc(rune_max * sizeof(struct rune));
+	rune_pending = mem_zalloc(rune_max * sizeof(int));
+	rune_pending_num = 0;
 	count = 0;
 	for (i = 0; i < COMBAT_RUNE_MAX; i++) {
 		rune_list[count++] = (struct rune) { RUNE_VAR_COMBAT, i, 0, c_rune[i] };
@@ -216,6 +226,7 @@ static int rune_index(size_t variety, int index)
  */
 static void cleanup_rune(void)
 {
+	mem_free(rune_pending);
 	mem_free(rune_list);
 }
 
@@ -1095,6 +1106,11 @@ void player_know_object(struct player *p, struct object *obj)
 	if (!obj->known) return;
 	if (obj->kind != obj->known->kind) return;
 
+	/* What the gear adds to the player, and how objects are described,
+	 * may change */
+	forget_equip_bonuses();
+	object_desc_forget();
+
 	/* Distant objects just get base properties */
 	if (obj->kind && !(obj->known->notice & OBJ_NOTICE_ASSESSED)) {
 		object_set_base_known(p, obj);
@@ -1277,23 +1293,59 @@ void player_know_object(struct player *p, struct object *obj)
 }
 
 /**
- * Propagate player knowledge of objects to all objects
+ * Check whether learning the pending runes could change what the player
+ * knows about an object.  This is so if the object carries one of them, and
+ * also if its ego or effect is still unknown, as learning a rune the object
+ * doesn't have can complete the player's knowledge of an ego, or make them
+ * aware of a flavour.
+ *
+ * \param obj is the object
+ */
+static bool object_has_pending_rune(const struct object *obj)
+{
+	int i;
+
+	if (!obj || !obj->known) return false;
+	if (obj->kind && !(obj->known->notice & OBJ_NOTICE_ASSESSED)) return true;
+	if (obj->ego && (obj->known->ego != obj->ego)) return true;
+	if (!object_effect_is_known(obj)) return true;
+
+	for (i = 0; i < rune_pending_num; i++) {
+		if (object_has_rune(obj, rune_pending[i])) return true;
+	}
+
+	return false;
+}
+
+/**
+ * Propagate player knowledge to objects, either all of them or just those
+ * affected by the pending runes.  The ground and the pack are only
+ * autoinscribed, and the pack only redrawn, if any of their objects were
+ * revisited.
  *
  * \param p is the player
+ * \param all is whether to update all objects
  */
-void update_player_object_knowledge(struct player *p)
+static void player_know_objects(struct player *p, bool all)
 {
 	int i;
 	struct object *obj;
+	bool ground = all, pack = all;
 
 	/* Level objects */
 	if (cave)
 		for (i = 0; i < cave->obj_max; i++)
-			player_know_object(p, cave->objects[i]);
+			if (all || object_has_pending_rune(cave->objects[i])) {
+				player_know_object(p, cave->objects[i]);
+				ground = true;
+			}
 
 	/* Player objects */
 	for (obj = p->gear; obj; obj = obj->next)
-		player_know_object(p, obj);
+		if (all || object_has_pending_rune(obj)) {
+			player_know_object(p, obj);
+			pack = true;
+		}
 
 	/* Store objects */
 	for (i = 0; i < world->num_towns; i++) {
@@ -1301,7 +1353,8 @@ void update_player_object_knowledge(struct player *p)
 		struct store *s = town->stores;
 		while (s) {
 			for (obj = s->stock; obj; obj = obj->next) {
-				player_know_object(p, obj);
+				if (all || object_has_pending_rune(obj))
+					player_know_object(p, obj);
 			}
 			s = s->next;
 		}
@@ -1309,15 +1362,31 @@ void update_player_object_knowledge(struct player *p)
 
 	/* Curse objects */
 	for (i = 1; i < z_info->curse_max; i++) {
-		player_know_object(p, curses[i].obj);
+		if (all || object_has_pending_rune(curses[i].obj))
+			player_know_object(p, curses[i].obj);
 	}
 
+	/* Everything is up to date */
+	rune_pending_num = 0;
+
 	/* Update */
-	if (cave)
+	if (cave && ground)
 		autoinscribe_ground(p);
-	autoinscribe_pack(p);
-	event_signal(EVENT_INVENTORY);
-	event_signal(EVENT_EQUIPMENT);
+	if (pack) {
+		autoinscribe_pack(p);
+		event_signal(EVENT_INVENTORY);
+		event_signal(EVENT_EQUIPMENT);
+	}
+}
+
+/**
+ * Propagate player knowledge of objects to all objects
+ *
+ * \param p is the player
+ */
+void update_player_object_knowledge(struct player *p)
+{
+	player_know_objects(p, true);
 }
 
 /**
@@ -1445,13 +1514,18 @@ static void player_learn_rune(struct player *p, size_t i, bool message)
 
 	/* Nothing learned */
 	if (!learned) return;
+	forget_equip_bonuses();
+	object_desc_forget();
 
 	/* Give a message */
 	if (message)
 		msgt(MSG_RUNE, "You have learned the rune of %s.", rune_name(i));
 
-	/* Update knowledge */
-	update_player_object_knowledge(p);
+	/* Update knowledge of the objects with the rune, unless batching */
+	rune_pending[rune_pending_num++] = i;
+	if (!rune_batch) {
+		player_know_objects(p, false);
+	}
 }
 
 /**
@@ -1460,7 +1534,6 @@ static void player_learn_rune(struct player *p, size_t i, bool message)
 void player_learn_flag(struct player *p, int flag)
 {
 	player_learn_rune(p, rune_index(RUNE_VAR_FLAG, flag), true);
-	update_player_object_knowledge(p);
 }
 
 /**
@@ -1482,7 +1555,6 @@ void player_learn_slay(struct player *p, int index)
 
 		/* Learn the rune */
 		player_learn_rune(p, rune_index(RUNE_VAR_SLAY, i), true);
-		update_player_object_knowledge(p);
 	}
 }
 
@@ -1505,7 +1577,6 @@ void player_learn_brand(struct player *p, int index)
 
 		/* Learn the rune */
 		player_learn_rune(p, rune_index(RUNE_VAR_BRAND, i), true);
-		update_player_object_knowledge(p);
 	}
 }
 
@@ -1518,8 +1589,9 @@ void player_learn_curse(struct player *p, struct curse *curse)
 	int index = rune_index(RUNE_VAR_CURSE, lookup_curse(curse->name));
 	if (index >= 0) {
 		player_learn_rune(p, index, true);
+	} else {
+		update_player_object_knowledge(p);
 	}
-	update_player_object_knowledge(p);
 }
 
 /**
@@ -1531,6 +1603,9 @@ void player_learn_innate(struct player *p)
 {
 	int element, flag;
 
+	/* Objects are all updated at the end */
+	rune_batch++;
+
 	/* Elements */
 	for (element = 0; element < ELEM_MAX; element++) {
 		if (p->race->el_info[element].res_level != RES_LEVEL_BASE) {
@@ -1544,6 +1619,7 @@ void player_learn_innate(struct player *p)
 		player_learn_rune(p, rune_index(RUNE_VAR_FLAG, flag), false);
 	}
 
+	rune_batch--;
 	update_player_object_knowledge(p);
 }
 
@@ -1556,8 +1632,14 @@ void player_learn_all_runes(struct player *p)
 {
 	size_t i;
 
+	rune_batch++;
 	for (i = 0; i < rune_max; i++)
 		player_learn_rune(p, i, false);
+	rune_batch--;
+
+	if (rune_pending_num) {
+		player_know_objects(p, false);
+	}
 }
 
 /**
@@ -2366,6 +2448,8 @@ void object_flavor_aware(struct player *p, struct object *obj)
 	if (obj->kind->aware) return;
 	obj->kind->aware = true;
 	obj->known->effect = obj->effect;
+	forget_equip_bonuses();
+	object_desc_forget();
 
 	/* Fix ignore/autoinscribe */
 	if (kind_is_ignored_unaware(obj->kind))
@@ -2425,4 +2509,5 @@ void object_flavor_tried(struct object *obj)
 		return;
 	}
 	obj->kind->tried = true;
+	object_desc_forget();
 }
@@ -296,6 +296,7 @@ struct object *object_new(void)
  */
 void object_free(struct object *obj)
 {
+	object_desc_forget();
 	mem_free(obj->slays);
 	mem_free(obj->brands);
 	mem_free(obj->curses);
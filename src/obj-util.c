@@ -41,6 +41,7 @@
 #include "player-spell.h"
 #include "player-util.h"
 #include "randname.h"
+#include "z-index.h"
 #include "z-queue.h"
 
 struct object_base *kb_info;
@@ -444,6 +445,53 @@ unsigned check_for_inscrip_with_int(const struct object *obj, const char *inscri
 
 /*** Object kind lookup functions ***/
 
+/**
+ * Indexes of object kinds by tval and sval, and by tval and the name as it
+ * is written in data files; kinds are only ever added to the end of k_info
+ * (for books and artifacts) after it is parsed, so these cover the first
+ * kinds_indexed kinds and are brought up to date when more appear
+ */
+static struct pair_index *kind_by_sval;
+static struct name_index *kind_by_name;
+static int kinds_indexed;
+
+static void kind_index_update(void)
+{
+	int k;
+
+	if (kinds_indexed > z_info->k_max) kind_index_free();
+	if (!kind_by_sval) {
+		kind_by_sval = pair_index_new();
+		kind_by_name = name_index_new(true);
+	}
+	for (k = kinds_indexed; k < z_info->k_max; k++) {
+		struct object_kind *kind = &k_info[k];
+
+		if (kind->tval < 0 || kind->sval < 0) continue;
+		pair_index_add(kind_by_sval, kind->tval, kind->sval, k);
+		if (kind->name) {
+			char name[1024];
+
+			obj_desc_name_format(name, sizeof name, 0, kind->name, 0,
+				false);
+			name_index_add(kind_by_name, kind->tval, name, k);
+		}
+	}
+	kinds_indexed = z_info->k_max;
+}
+
+/**
+ * Throw away the object kind indexes, when k_info is freed
+ */
+void kind_index_free(void)
+{
+	pair_index_free(kind_by_sval);
+	name_index_free(kind_by_name);
+	kind_by_sval = NULL;
+	kind_by_name = NULL;
+	kinds_indexed = 0;
+}
+
 /**
  * Return the object kind with the given `tval` and `sval`, or NULL.
  */
@@ -452,11 +500,9 @@ struct object_kind *lookup_kind(int tval, int sval)
 	int k;
 
 	/* Look for it */
-	for (k = 0; k < z_info->k_max; k++) {
-		struct object_kind *kind = &k_info[k];
-		if (kind->tval == tval && kind->sval == sval)
-			return kind;
-	}
+	if (kinds_indexed != z_info->k_max) kind_index_update();
+	k = pair_index_find(kind_by_sval, tval, sval);
+	if (k >= 0) return &k_info[k];
 
 	/* Failure */
 	msg("No object: %d:%d (%s)", tval, sval, tval_find_name(tval));
@@ -499,36 +545,57 @@ const struct artifact *lookup_artifact_name(const char *name)
 }
 
 /**
- * \param name ego type name
- * \param tval object tval
- * \param sval object sval
- * \return eidx of the ego item type
+ * Index of ego item types by name and the kinds they can be, so that the
+ * name is only found with each kind in the ego's poss_items list
  */
-struct ego_item *lookup_ego_item(const char *name, int tval, int sval)
+static struct name_index *ego_by_name;
+static int egos_indexed;
+
+static void ego_index_update(void)
 {
-	struct object_kind *kind = lookup_kind(tval, sval);
 	int i;
 
-	/* Look for it */
-	if (!kind) return NULL;
+	ego_index_free();
+	ego_by_name = name_index_new(false);
 	for (i = 0; i < z_info->e_max; i++) {
 		struct ego_item *ego = &e_info[i];
-		struct poss_item *poss_item = ego->poss_items;
+		struct poss_item *poss_item;
 
-		/* Reject nameless and wrong names */
 		if (!ego->name) continue;
-		if (!streq(name, ego->name)) continue;
-
-		/* Check tval and sval */
-		while (poss_item) {
-			if (kind->kidx == poss_item->kidx) {
-				return ego;
-			}
-			poss_item = poss_item->next;
+		for (poss_item = ego->poss_items; poss_item;
+				poss_item = poss_item->next) {
+			name_index_add(ego_by_name, poss_item->kidx, ego->name, i);
 		}
 	}
+	egos_indexed = z_info->e_max;
+}
 
-	return NULL;
+/**
+ * Throw away the ego item index, when e_info is freed
+ */
+void ego_index_free(void)
+{
+	name_index_free(ego_by_name);
+	ego_by_name = NULL;
+	egos_indexed = 0;
+}
+
+/**
+ * \param name ego type name
+ * \param tval object tval
+ * \param sval object sval
+ * \return eidx of the ego item type
+ */
+struct ego_item *lookup_ego_item(const char *name, int tval, int sval)
+{
+	struct object_kind *kind = lookup_kind(tval, sval);
+	int e;
+
+	/* Look for it */
+	if (!kind) return NULL;
+	if (egos_indexed != z_info->e_max) ego_index_update();
+	e = name_index_find(ego_by_name, kind->kidx, name);
+	return (e >= 0) ? &e_info[e] : NULL;
 }
 
 /**
@@ -546,20 +613,9 @@ int lookup_sval(int tval, const char *name)
 	}
 
 	/* Look for it */
-	for (k = 0; k < z_info->k_max; k++) {
-		struct object_kind *kind = &k_info[k];
-		char cmp_name[1024];
-
-		if (!kind || !kind->name || kind->tval != tval) continue;
-
-		obj_desc_name_format(cmp_name, sizeof cmp_name, 0, kind->name, 0,
-							 false);
-
-		/* Found a match */
-		if (!my_stricmp(cmp_name, name)) return kind->sval;
-	}
-
-	return -1;
+	if (kinds_indexed != z_info->k_max) kind_index_update();
+	k = name_index_find(kind_by_name, tval, name);
+	return (k >= 0) ? k_info[k].sval : -1;
 }
 
 void object_short_name(char *buf, size_t max, const char *name)
@@ -40,9 +40,11 @@ bool item_test(item_tester tester, int item);
 bool is_unknown(const struct object *obj);
 unsigned check_for_inscrip(const struct object *obj, const char *inscrip);
 unsigned check_for_inscrip_with_int(const struct object *obj, const char *insrip, int *ival);
+void kind_index_free(void);
 struct object_kind *lookup_kind(int tval, int sval);
 struct object_kind *objkind_byid(int kidx);
 const struct artifact *lookup_artifact_name(const char *name);
+void ego_index_free(void);
 struct ego_item *lookup_ego_item(const char *name, int tval, int sval);
 int lookup_sval(int tval, const char *name);
 void object_short_name(char *buf, size_t max, const char *name);
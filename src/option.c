@@ -17,6 +17,7 @@
  */
 #include "angband.h"
 #include "init.h"
+#include "obj-desc.h"
 #include "option.h"
 #include "parser.h"
 #include "z-util.h"
@@ -165,6 +166,7 @@ bool option_set(const char *name, int val)
 		player->opts.opt[opt] = val ? true : false;
 		if (val && option_is_cheat(opt))
 			player->opts.opt[opt + 1] = true;
+		object_desc_forget();
 
 		return true;
 	}
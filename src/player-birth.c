@@ -1463,7 +1463,7 @@ void do_cmd_accept_character(struct command *cmd)
 	player_learn_innate(player);
 
 	/* Generate random artifacts */
-	seed_randart = randint0(0x10000000);
+	seed_randart = randint0(0x10000000) | RANDART_SEED_SEPARATE;
 	initialize_random_artifacts(seed_randart);
 	deactivate_randart_file();
 
@@ -27,6 +27,7 @@
 #include "mon-msg.h"
 #include "mon-util.h"
 #include "obj-curse.h"
+#include "obj-desc.h"
 #include "obj-gear.h"
 #include "obj-ignore.h"
 #include "obj-knowledge.h"
@@ -2092,82 +2093,111 @@ static void calc_shapechange(struct player_state *state,
 }
 
 /**
- * Calculate the players current "state", taking into account
- * not only race/class intrinsics, but also objects being worn
- * and temporary spell effects.
- *
- * See also calc_mana() and calc_hitpoints().
- *
- * Take note of the new "speed code", in particular, a very strong
- * player will start slowing down as soon as he reaches 150 pounds,
- * but not until he reaches 450 pounds will he be half as fast as
- * a normal kobold.  This both hurts and helps the player, hurts
- * because in the old days a player could just avoid 300 pounds,
- * and helps because now carrying 300 pounds is not very painful.
- *
- * The "weapon" and "bow" do *not* add to the bonuses to hit or to
- * damage, since that would affect non-combat things.  These values
- * are actually added in later, at the appropriate place.
- *
- * If known_only is true, calc_bonuses() will only use the known
- * information of objects; thus it returns what the player _knows_
- * the character state to be.
+ * ------------------------------------------------------------------------
+ * The equipment's part of the player's state
+ * ------------------------------------------------------------------------ */
+/**
+ * What the equipment adds to the player's state.  The real state is worked
+ * out over and over as timed effects come and go, but the equipment behind
+ * it changes much less often, so its part is kept here, once for the full
+ * state and once for the known state, until the gear or the player's
+ * knowledge of it changes.
  */
-void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
-				  bool update)
-{
-	int i, j, hold;
-	int extra_blows = 0;
-	int extra_shots = 0;
-	int extra_might = 0;
-	int extra_moves = 0;
-	int armor_weight = 0;
-	int topography = world ? world->levels[p->place].topography : 0;
-	struct object *launcher = equipped_item_by_slot_name(p, "shooting");
-	struct object *weapon = equipped_item_by_slot_name(p, "weapon");
-	bitflag f[OF_SIZE];
-	bitflag collect_f[OF_SIZE];
+struct equip_bonus {
+	bool valid;
+	const struct player *p;
+	struct object **slots;		/* What was in each slot */
+	int count;
+	bitflag flags[OF_SIZE];
+	int stat_add[STAT_MAX];
+	int skills[SKILL_MAX];
+	int see_infra;
+	int speed;
+	int dam_red;
+	int blows, shots, might, moves;
+	int ac;
+	int body_ac;				/* Extra for armour mastery */
+	int shield_ac;				/* Extra for shield mastery */
+	int to_a, to_h, to_d;
+	int armor_weight;
+	int16_t (*res)[ELEM_MAX];	/* Resists of each object, in order */
+	int num_res;
+	int max_res;
+};
 
-	/* Hack to allow calculating hypothetical blows for extra STR, DEX - NRM */
-	int str_ind = state->stat_ind[STAT_STR];
-	int dex_ind = state->stat_ind[STAT_DEX];
+static struct equip_bonus equip_bonuses[2];
 
-	bool enhance;
+static void equip_bonus_free(struct equip_bonus *eb)
+{
+	mem_free(eb->slots);
+	mem_free(eb->res);
+	memset(eb, 0, sizeof(*eb));
+}
 
-	/* Reset */
-	memset(state, 0, sizeof *state);
+/**
+ * Forget what the equipment adds, so it is worked out again next time
+ */
+void forget_equip_bonuses(void)
+{
+	equip_bonuses[0].valid = false;
+	equip_bonuses[1].valid = false;
+}
 
-	/* Set various defaults */
-	state->speed = 110;
-	state->num_blows = 100;
+/**
+ * Free the remembered equipment bonuses
+ */
+void cleanup_equip_bonuses(void)
+{
+	equip_bonus_free(&equip_bonuses[0]);
+	equip_bonus_free(&equip_bonuses[1]);
+}
 
-	/* Extract race/class info */
-	state->see_infra = p->race->infra;
-	for (i = 0; i < SKILL_MAX; i++) {
-		state->skills[i] = p->race->r_skills[i]	+ p->class->c_skills[i];
-	}
-	for (i = 0; i < ELEM_MAX; i++) {
-		state->el_info[i].res_level = p->race->el_info[i].res_level;
-	}
+/**
+ * Check the remembered bonuses are for the gear the player is wearing
+ */
+static bool equip_bonus_current(struct player *p,
+		const struct equip_bonus *eb)
+{
+	int i;
 
-	/* Base pflags */
-	pf_wipe(state->pflags);
-	pf_copy(state->pflags, p->race->pflags);
-	pf_union(state->pflags, p->class->pflags);
-	pf_union(state->pflags, p->specialties);
+	if (!eb->valid || eb->p != p || eb->count != p->body.count) return false;
+	for (i = 0; i < p->body.count; i++) {
+		if (eb->slots[i] != slot_object(p, i)) return false;
+	}
+	return true;
+}
 
-	/* Specialty ability Enhance Magic */
-	enhance = pf_has(state->pflags, PF_ENHANCE_MAGIC);
+/**
+ * Work out what the equipment adds to the player's state
+ */
+static void calc_equip_bonus(struct player *p, struct equip_bonus *eb,
+		bool known_only)
+{
+	int i, j;
+	bitflag f[OF_SIZE];
 
-	/* Extract the player flags */
-	player_flags(p, collect_f);
+	eb->valid = true;
+	eb->p = p;
+	if (eb->count != p->body.count) {
+		eb->count = p->body.count;
+		eb->slots = mem_realloc(eb->slots, eb->count * sizeof(*eb->slots));
+	}
+	of_wipe(eb->flags);
+	memset(eb->stat_add, 0, sizeof(eb->stat_add));
+	memset(eb->skills, 0, sizeof(eb->skills));
+	eb->see_infra = eb->speed = eb->dam_red = 0;
+	eb->blows = eb->shots = eb->might = eb->moves = 0;
+	eb->ac = eb->body_ac = eb->shield_ac = 0;
+	eb->to_a = eb->to_h = eb->to_d = 0;
+	eb->armor_weight = 0;
+	eb->num_res = 0;
 
-	/* Analyze equipment */
 	for (i = 0; i < p->body.count; i++) {
 		int index = 0;
 		struct object *obj = slot_object(p, i);
 		struct curse_data *curse = obj ? obj->curses : NULL;
 
+		eb->slots[i] = obj;
 		while (obj) {
 			int dig = 0;
 
@@ -2177,28 +2207,28 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 			} else {
 				object_flags(obj, f);
 			}
-			of_union(collect_f, f);
+			of_union(eb->flags, f);
 
 			/* Apply modifiers */
-			state->stat_add[STAT_STR] += obj->modifiers[OBJ_MOD_STR]
+			eb->stat_add[STAT_STR] += obj->modifiers[OBJ_MOD_STR]
 				* p->obj_k->modifiers[OBJ_MOD_STR];
-			state->stat_add[STAT_INT] += obj->modifiers[OBJ_MOD_INT]
+			eb->stat_add[STAT_INT] += obj->modifiers[OBJ_MOD_INT]
 				* p->obj_k->modifiers[OBJ_MOD_INT];
-			state->stat_add[STAT_WIS] += obj->modifiers[OBJ_MOD_WIS]
+			eb->stat_add[STAT_WIS] += obj->modifiers[OBJ_MOD_WIS]
 				* p->obj_k->modifiers[OBJ_MOD_WIS];
-			state->stat_add[STAT_DEX] += obj->modifiers[OBJ_MOD_DEX]
+			eb->stat_add[STAT_DEX] += obj->modifiers[OBJ_MOD_DEX]
 				* p->obj_k->modifiers[OBJ_MOD_DEX];
-			state->stat_add[STAT_CON] += obj->modifiers[OBJ_MOD_CON]
+			eb->stat_add[STAT_CON] += obj->modifiers[OBJ_MOD_CON]
 				* p->obj_k->modifiers[OBJ_MOD_CON];
-			state->skills[SKILL_STEALTH] += obj->modifiers[OBJ_MOD_STEALTH]
+			eb->skills[SKILL_STEALTH] += obj->modifiers[OBJ_MOD_STEALTH]
 				* p->obj_k->modifiers[OBJ_MOD_STEALTH];
-			state->skills[SKILL_SEARCH] += (obj->modifiers[OBJ_MOD_SEARCH] * 5)
+			eb->skills[SKILL_SEARCH] += (obj->modifiers[OBJ_MOD_SEARCH] * 5)
 				* p->obj_k->modifiers[OBJ_MOD_SEARCH];
-			state->skills[SKILL_DEVICE] +=
+			eb->skills[SKILL_DEVICE] +=
 				(obj->modifiers[OBJ_MOD_MAGIC_MASTERY] * 5) *
 				p->obj_k->modifiers[OBJ_MOD_SEARCH];
 
-			state->see_infra += obj->modifiers[OBJ_MOD_INFRA]
+			eb->see_infra += obj->modifiers[OBJ_MOD_INFRA]
 				* p->obj_k->modifiers[OBJ_MOD_INFRA];
 			if (tval_is_digger(obj)) {
 				if (of_has(obj->flags, OF_DIG_1))
@@ -2210,57 +2240,61 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 			}
 			dig += obj->modifiers[OBJ_MOD_TUNNEL]
 				* p->obj_k->modifiers[OBJ_MOD_TUNNEL];
-			state->skills[SKILL_DIGGING] += (dig * 20);
-			state->speed += obj->modifiers[OBJ_MOD_SPEED]
+			eb->skills[SKILL_DIGGING] += (dig * 20);
+			eb->speed += obj->modifiers[OBJ_MOD_SPEED]
 				* p->obj_k->modifiers[OBJ_MOD_SPEED];
-			state->dam_red += obj->modifiers[OBJ_MOD_DAM_RED]
+			eb->dam_red += obj->modifiers[OBJ_MOD_DAM_RED]
 				* p->obj_k->modifiers[OBJ_MOD_DAM_RED];
-			extra_blows += obj->modifiers[OBJ_MOD_BLOWS]
+			eb->blows += obj->modifiers[OBJ_MOD_BLOWS]
 				* p->obj_k->modifiers[OBJ_MOD_BLOWS];
-			extra_shots += obj->modifiers[OBJ_MOD_SHOTS]
+			eb->shots += obj->modifiers[OBJ_MOD_SHOTS]
 				* p->obj_k->modifiers[OBJ_MOD_SHOTS];
-			extra_might += obj->modifiers[OBJ_MOD_MIGHT]
+			eb->might += obj->modifiers[OBJ_MOD_MIGHT]
 				* p->obj_k->modifiers[OBJ_MOD_MIGHT];
-			extra_moves += obj->modifiers[OBJ_MOD_MOVES]
+			eb->moves += obj->modifiers[OBJ_MOD_MOVES]
 				* p->obj_k->modifiers[OBJ_MOD_MOVES];
 
-			/* Apply element info, noting vulnerabilites for later processing */
+			/* Note element info; resists don't simply add up, so each
+			 * object's are kept to be applied in turn */
+			if (eb->num_res == eb->max_res) {
+				eb->max_res = eb->max_res ? eb->max_res * 2 : 16;
+				eb->res = mem_realloc(eb->res,
+					eb->max_res * sizeof(*eb->res));
+			}
 			for (j = 0; j < ELEM_MAX; j++) {
 				if (known_only) {
-					apply_resist(&state->el_info[j].res_level,
-								 obj->known->el_info[j].res_level);
+					eb->res[eb->num_res][j] =
+						obj->known->el_info[j].res_level;
 				} else {
-					apply_resist(&state->el_info[j].res_level,
-								 obj->el_info[j].res_level);
+					eb->res[eb->num_res][j] = obj->el_info[j].res_level;
 				}
 			}
+			eb->num_res++;
 
 			/* Apply combat bonuses */
-			state->ac += obj->ac;
-			if (slot_type_is(p, i, EQUIP_BODY_ARMOR) &&
-				pf_has(state->pflags, PF_ARMOR_MAST)) {
-				state->ac += (obj->ac * 2) / 3;
+			eb->ac += obj->ac;
+			if (slot_type_is(p, i, EQUIP_BODY_ARMOR)) {
+				eb->body_ac += (obj->ac * 2) / 3;
 			}
-			if (slot_type_is(p, i, EQUIP_SHIELD) &&
-				pf_has(state->pflags, PF_SHIELD_MAST)) {
-				state->ac += obj->ac;
+			if (slot_type_is(p, i, EQUIP_SHIELD)) {
+				eb->shield_ac += obj->ac;
 			}
 			if (!known_only || obj->known->to_a) {
-				state->to_a += obj->to_a;
+				eb->to_a += obj->to_a;
 			}
 			if (!slot_type_is(p, i, EQUIP_WEAPON)
 					&& !slot_type_is(p, i, EQUIP_BOW)) {
 				if (!known_only || obj->known->to_h) {
-					state->to_h += obj->to_h;
+					eb->to_h += obj->to_h;
 				}
 				if (!known_only || obj->known->to_d) {
-					state->to_d += obj->to_d;
+					eb->to_d += obj->to_d;
 				}
 			}
 
 			/* Calculate armor weight */
 			if (tval_is_armor(obj)) {
-				armor_weight += obj->weight;
+				eb->armor_weight += obj->weight;
 			}
 
 			/* Move to any unprocessed curse object */
@@ -2280,6 +2314,138 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 			}
 		}
 	}
+}
+
+/**
+ * Add what the equipment adds to a state that so far has just the race,
+ * class and specialties
+ */
+static void apply_equip_bonus(const struct equip_bonus *eb,
+		struct player_state *state, bitflag *collect_f, int *blows,
+		int *shots, int *might, int *moves, int *armor_weight)
+{
+	int i, j;
+
+	of_union(collect_f, eb->flags);
+	for (i = 0; i < STAT_MAX; i++) {
+		state->stat_add[i] += eb->stat_add[i];
+	}
+	for (i = 0; i < SKILL_MAX; i++) {
+		state->skills[i] += eb->skills[i];
+	}
+	state->see_infra += eb->see_infra;
+	state->speed += eb->speed;
+	state->dam_red += eb->dam_red;
+	*blows += eb->blows;
+	*shots += eb->shots;
+	*might += eb->might;
+	*moves += eb->moves;
+	for (i = 0; i < eb->num_res; i++) {
+		for (j = 0; j < ELEM_MAX; j++) {
+			apply_resist(&state->el_info[j].res_level, eb->res[i][j]);
+		}
+	}
+	state->ac += eb->ac;
+	if (pf_has(state->pflags, PF_ARMOR_MAST)) {
+		state->ac += eb->body_ac;
+	}
+	if (pf_has(state->pflags, PF_SHIELD_MAST)) {
+		state->ac += eb->shield_ac;
+	}
+	state->to_a += eb->to_a;
+	state->to_h += eb->to_h;
+	state->to_d += eb->to_d;
+	*armor_weight += eb->armor_weight;
+}
+
+/**
+ * Calculate the players current "state", taking into account
+ * not only race/class intrinsics, but also objects being worn
+ * and temporary spell effects.
+ *
+ * See also calc_mana() and calc_hitpoints().
+ *
+ * Take note of the new "speed code", in particular, a very strong
+ * player will start slowing down as soon as he reaches 150 pounds,
+ * but not until he reaches 450 pounds will he be half as fast as
+ * a normal kobold.  This both hurts and helps the player, hurts
+ * because in the old days a player could just avoid 300 pounds,
+ * and helps because now carrying 300 pounds is not very painful.
+ *
+ * The "weapon" and "bow" do *not* add to the bonuses to hit or to
+ * damage, since that would affect non-combat things.  These values
+ * are actually added in later, at the appropriate place.
+ *
+ * If known_only is true, calc_bonuses() will only use the known
+ * information of objects; thus it returns what the player _knows_
+ * the character state to be.
+ */
+void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
+				  bool update)
+{
+	int i, j, hold;
+	int extra_blows = 0;
+	int extra_shots = 0;
+	int extra_might = 0;
+	int extra_moves = 0;
+	int armor_weight = 0;
+	int topography = world ? world->levels[p->place].topography : 0;
+	struct object *launcher = equipped_item_by_slot_name(p, "shooting");
+	struct object *weapon = equipped_item_by_slot_name(p, "weapon");
+	bitflag collect_f[OF_SIZE];
+
+	/* Hack to allow calculating hypothetical blows for extra STR, DEX - NRM */
+	int str_ind = state->stat_ind[STAT_STR];
+	int dex_ind = state->stat_ind[STAT_DEX];
+
+	bool enhance;
+
+	/* Reset */
+	memset(state, 0, sizeof *state);
+
+	/* Set various defaults */
+	state->speed = 110;
+	state->num_blows = 100;
+
+	/* Extract race/class info */
+	state->see_infra = p->race->infra;
+	for (i = 0; i < SKILL_MAX; i++) {
+		state->skills[i] = p->race->r_skills[i]	+ p->class->c_skills[i];
+	}
+	for (i = 0; i < ELEM_MAX; i++) {
+		state->el_info[i].res_level = p->race->el_info[i].res_level;
+	}
+
+	/* Base pflags */
+	pf_wipe(state->pflags);
+	pf_copy(state->pflags, p->race->pflags);
+	pf_union(state->pflags, p->class->pflags);
+	pf_union(state->pflags, p->specialties);
+
+	/* Specialty ability Enhance Magic */
+	enhance = pf_has(state->pflags, PF_ENHANCE_MAGIC);
+
+	/* Extract the player flags */
+	player_flags(p, collect_f);
+
+	/* Add the equipment, remembering it if this is the player's real state */
+	if (update) {
+		struct equip_bonus *eb = &equip_bonuses[known_only ? 1 : 0];
+
+		if (!equip_bonus_current(p, eb)) {
+			calc_equip_bonus(p, eb, known_only);
+		}
+		apply_equip_bonus(eb, state, collect_f, &extra_blows, &extra_shots,
+			&extra_might, &extra_moves, &armor_weight);
+	} else {
+		struct equip_bonus eb;
+
+		memset(&eb, 0, sizeof(eb));
+		calc_equip_bonus(p, &eb, known_only);
+		apply_equip_bonus(&eb, state, collect_f, &extra_blows, &extra_shots,
+			&extra_might, &extra_moves, &armor_weight);
+		equip_bonus_free(&eb);
+	}
 
 	/* Apply the collected flags */
 	of_union(state->flags, collect_f);
@@ -2949,6 +3115,7 @@ void notice_stuff(struct player *p)
 {
 	/* Notice stuff */
 	if (!p->upkeep->notice) return;
+	object_desc_forget();
 
 	/* Deal with ignore stuff */
 	if (p->upkeep->notice & PN_IGNORE) {
@@ -2978,6 +3145,7 @@ void update_stuff(struct player *p)
 {
 	/* Update stuff */
 	if (!p->upkeep->update) return;
+	object_desc_forget();
 
 
 	if (p->upkeep->update & (PU_INVEN)) {
@@ -2986,7 +3154,11 @@ void update_stuff(struct player *p)
 	}
 
 	if (p->upkeep->update & (PU_BONUS)) {
-		p->upkeep->update &= ~(PU_BONUS);
+		forget_equip_bonuses();
+	}
+
+	if (p->upkeep->update & (PU_BONUS | PU_BONUS_QUICK)) {
+		p->upkeep->update &= ~(PU_BONUS | PU_BONUS_QUICK);
 		update_bonuses(p);
 	}
 
@@ -44,6 +44,7 @@
 #define PU_DISTANCE		0x00000100L	/* Update distances */
 #define PU_PANEL		0x00000200L	/* Update panel */
 #define PU_INVEN		0x00000400L	/* Update inventory */
+#define PU_BONUS_QUICK	0x00000800L	/* Calculate bonuses, gear unchanged */
 
 
 /**
@@ -107,6 +108,8 @@ extern const int adj_str_hold[STAT_RANGE];
 bool earlier_object(struct object *orig, struct object *new, bool store);
 int equipped_item_slot(struct player_body body, struct object *obj);
 void calc_inventory(struct player *p);
+void forget_equip_bonuses(void);
+void cleanup_equip_bonuses(void);
 void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 				  bool update);
 void calc_digging_chances(struct player_state *state, int chances[DIGGING_MAX]);
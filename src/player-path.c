@@ -19,6 +19,7 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "cave-frontier.h"
 #include "cmds.h"
 #include "game-world.h"
 #include "generate.h"
@@ -39,6 +40,13 @@
  * Pathfinding code
  * ------------------------------------------------------------------------ */
 
+/**
+ * Penalties to distance for stepping into terrain that is hard to traverse
+ */
+struct pf_penalties {
+	int unlocked, locked, rubble, prubble, tree;
+};
+
 /**
  * This is an opaque type for communicating the distances, in expected
  * movement turns, from a player's grid to other grids in the cave.
@@ -55,18 +63,36 @@ struct pfdistances {
 	 * view of the cave.
 	 */
 	int height, width;
+	/**
+	 * These are the rest of what the distances were computed from:  the
+	 * stamp of the player's memory of the cave, the options passed to
+	 * prepare_pfdistances(), and the relevant parts of the player's state.
+	 */
+	uint32_t memory_stamp;
+	bool only_known, forbid_traps, trapsafe;
+	struct pf_penalties pen;
+	/**
+	 * This is the number of callers which have not yet released the
+	 * distances.
+	 */
+	int users;
+	/** This is true if the distances are held in the cache for reuse. */
+	bool cached;
 };
 
 /**
  * This is a patched version (non-overlapping squares of patch_size by
  * patch_size; patch size is a power of 2) of pfdistances for use in
- * find_path().
+ * find_path().  Patches no longer in use are kept in spare so they can be
+ * used again without allocating more memory.
  */
 struct pfdistances_patched {
 	int ***patches;
 	int patch_size, patch_shift, patch_mask;
 	int npatchy, npatchx;
 	int height, width;
+	int **spare;
+	int num_spare, max_spare;
 };
 
 /**
@@ -75,6 +101,29 @@ struct pfdistances_patched {
  */
 #define PF_SCL 16
 
+/**
+ * Number of distance arrays from prepare_pfdistances() kept for reuse
+ */
+#define PF_CACHE_SIZE 4
+
+/**
+ * Storage kept from one pathfinding call to the next.  The distance arrays
+ * most recently computed by prepare_pfdistances() are kept, so asking again
+ * from the same place with nothing changed (as the targeting interface does
+ * while the cursor moves) is answered without searching again; the queues
+ * and distances used by the searches are kept so they don't have to be
+ * allocated afresh each time.
+ */
+static struct pf_context {
+	/** The cached distance arrays, most recently used first */
+	struct pfdistances *cache[PF_CACHE_SIZE];
+	/** The queue of grids to consider for prepare_pfdistances() */
+	struct queue *pending;
+	/** The distances and the queue of paths to consider for find_path() */
+	struct pfdistances_patched patched;
+	struct priority_queue *paths;
+} pf_ctx;
+
 /**
  * Determine whether a grid is OK for the pathfinder to check
  */
@@ -320,6 +369,146 @@ static int compute_passable_rubble_penalty(struct player *p)
 	return convert_turn_penalty(PF_SCL, p);
 }
 
+/**
+ * Help prepare_pfdistances() and path_nearest_unknown():  compute all the
+ * penalties for terrain that is hard to traverse.
+ */
+static void compute_penalties(struct player *p, struct pf_penalties *pen)
+{
+	pen->unlocked = compute_unlocked_penalty(p);
+	pen->locked = compute_locked_penalty(p);
+	pen->rubble = compute_rubble_penalty(p);
+	pen->prubble = compute_passable_rubble_penalty(p);
+	pen->tree = compute_tree_penalty(p);
+}
+
+/**
+ * Help prepare_pfdistances() and path_nearest_unknown():  return the penalty
+ * to distance for stepping into a grid, or -1 if the grid can not be
+ * traversed at all.  Grids that are not known are treated as passable.
+ */
+static int step_penalty(struct player *p, struct loc grid,
+		const struct pf_penalties *pen)
+{
+	if (!square_isknown(p->cave, grid) || square_ispassable(p->cave, grid)) {
+		return 0;
+	}
+	if (square_iscloseddoor(p->cave, grid)) {
+		return (square_islockeddoor(p->cave, grid)) ?
+			pen->locked : pen->unlocked;
+	}
+	if (square_isrubble(p->cave, grid)) {
+		return (square_ispassable(p->cave, grid)) ?
+			pen->prubble : pen->rubble;
+	}
+	if (square_istree(p->cave, grid)) {
+		return pen->tree;
+	}
+	/* Should not happen, treat it as completely impassable. */
+	return -1;
+}
+
+/**
+ * Help prepare_pfdistances():  allocate a distance array of the given size.
+ */
+static struct pfdistances *new_pfdistances(int height, int width)
+{
+	struct pfdistances *a = mem_zalloc(sizeof(*a));
+	int y;
+
+	a->buffer = mem_alloc(height * width * sizeof(*a->buffer));
+	a->rows = mem_alloc(height * sizeof(*a->rows));
+	a->height = height;
+	a->width = width;
+	for (y = 0; y < height; ++y) {
+		a->rows[y] = a->buffer + y * width;
+	}
+	return a;
+}
+
+static void free_pfdistances(struct pfdistances *a)
+{
+	mem_free(a->buffer);
+	mem_free(a->rows);
+	mem_free(a);
+}
+
+/**
+ * Help prepare_pfdistances():  make the ith cached distance array the most
+ * recently used.
+ */
+static void promote_cached_pfdistances(int i)
+{
+	struct pfdistances *a = pf_ctx.cache[i];
+
+	for (; i > 0; --i) {
+		pf_ctx.cache[i] = pf_ctx.cache[i - 1];
+	}
+	pf_ctx.cache[0] = a;
+}
+
+/**
+ * Help prepare_pfdistances():  look for cached distances from the same
+ * starting point, computed with the same options from the player's memory
+ * and state as they are now.  Since every change to the player's memory of
+ * any cave gets a new stamp, matching stamps mean the same cave remembered
+ * the same way.
+ */
+static struct pfdistances *find_cached_pfdistances(struct player *p,
+		struct loc start, bool only_known, bool forbid_traps,
+		bool trapsafe, const struct pf_penalties *pen)
+{
+	int i;
+
+	for (i = 0; i < PF_CACHE_SIZE && pf_ctx.cache[i]; ++i) {
+		struct pfdistances *a = pf_ctx.cache[i];
+
+		if (a->memory_stamp == p->cave->memory_stamp
+				&& loc_eq(a->start, start)
+				&& a->only_known == only_known
+				&& a->forbid_traps == forbid_traps
+				&& a->trapsafe == trapsafe
+				&& !memcmp(&a->pen, pen, sizeof(*pen))) {
+			promote_cached_pfdistances(i);
+			return a;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Help prepare_pfdistances():  get a distance array of the given size that
+ * no caller is using.  That will be an empty slot in the cache or the least
+ * recently used array in the cache that is not in use; if every cached array
+ * is in use, the new one is kept outside of the cache.
+ */
+static struct pfdistances *claim_pfdistances(int height, int width)
+{
+	struct pfdistances *a;
+	int i;
+
+	for (i = PF_CACHE_SIZE - 1; i >= 0; --i) {
+		if (!pf_ctx.cache[i] || !pf_ctx.cache[i]->users) {
+			break;
+		}
+	}
+	if (i < 0) {
+		return new_pfdistances(height, width);
+	}
+	a = pf_ctx.cache[i];
+	if (a && (a->height != height || a->width != width)) {
+		free_pfdistances(a);
+		a = NULL;
+	}
+	if (!a) {
+		a = new_pfdistances(height, width);
+		a->cached = true;
+		pf_ctx.cache[i] = a;
+	}
+	promote_cached_pfdistances(i);
+	return a;
+}
+
 /**
  * Compute the distances, in movement turns, from a given location to all
  * locations in the cave.
@@ -338,6 +527,10 @@ static int compute_passable_rubble_penalty(struct player *p)
  * The computed distances use the player's memory of the cave.  When
  * only_known is false, grids that the player does not remember and are
  * not on the boundary of the cave are treated as if they were easily passable.
+ *
+ * If the same distances have been asked for recently, and neither the
+ * player's memory of the cave nor anything about the player that affects the
+ * distances has changed since, the earlier result is returned again.
  */
 struct pfdistances *prepare_pfdistances(struct player *p, struct loc start,
 		bool only_known, bool forbid_traps)
@@ -345,26 +538,35 @@ struct pfdistances *prepare_pfdistances(struct player *p, struct loc start,
 	struct pfdistances *result;
 	struct loc grid;
 	struct queue *pending;
-	int unlocked_penalty, locked_penalty, rubble_penalty, prubble_penalty,
-		tree_penalty;
+	struct pf_penalties pen;
+	bool trapsafe;
 
 	if (!p->cave || !square_in_bounds_fully(p->cave, start)) {
 		return NULL;
 	}
 
-	result = mem_alloc(sizeof(*result));
-	result->buffer = mem_alloc(p->cave->height * p->cave->width
-		* sizeof(*result->buffer));
-	result->rows = mem_alloc(p->cave->height * sizeof(*result->rows));
-	result->start = start;
-	result->height = p->cave->height;
-	result->width = p->cave->width;
-
-	/* Set up the row pointers. */
-	for (grid.y = 0; grid.y < result->height; ++grid.y) {
-		result->rows[grid.y] = result->buffer + grid.y * result->width;
+	/* Precompute quantities to penalize traversing some terrain;
+	 * we ignore slowing in water and speedups in trees for now. */
+	compute_penalties(p, &pen);
+	trapsafe = player_is_trapsafe(p);
+
+	/* Reuse the distances if nothing they depend on has changed. */
+	result = find_cached_pfdistances(p, start, only_known, forbid_traps,
+		trapsafe, &pen);
+	if (result) {
+		++result->users;
+		return result;
 	}
 
+	result = claim_pfdistances(p->cave->height, p->cave->width);
+	result->start = start;
+	result->memory_stamp = p->cave->memory_stamp;
+	result->only_known = only_known;
+	result->forbid_traps = forbid_traps;
+	result->trapsafe = trapsafe;
+	result->pen = pen;
+	result->users = 1;
+
 	/*
 	 * Mark the outer edge as unreachable (negative distance).  Keeps
 	 * things in bounds without extra checks later.  Inner grids may
@@ -390,21 +592,17 @@ struct pfdistances *prepare_pfdistances(struct player *p, struct loc start,
 	/* The distance to the starting point is zero. */
 	result->rows[result->start.y][result->start.x] = 0;
 
-	/* Precompute quantities to penalize traversing some terrain;
-	 * we ignore slowing in water and speedups in trees for now. */
-	unlocked_penalty = compute_unlocked_penalty(p);
-	locked_penalty = compute_locked_penalty(p);
-	rubble_penalty = compute_rubble_penalty(p);
-	prubble_penalty = compute_passable_rubble_penalty(p);
-	tree_penalty = compute_tree_penalty(p);
-
 	/*
 	 * Set up a queue with the feasible points that remain to be
 	 * considered.  The length of the perimeter of the cave is a guess
 	 * at how many feasible points may be present at once.  Will try to
-	 * resize if that turns out to be inadequate.
+	 * resize if that turns out to be inadequate.  The queue is empty
+	 * when done, so it is kept for the next call.
 	 */
-	pending = q_new(2 * (result->width + result->height - 2));
+	if (!pf_ctx.pending) {
+		pf_ctx.pending = q_new(2 * (result->width + result->height - 2));
+	}
+	pending = pf_ctx.pending;
 	/* The starting point is the point to consider. */
 	q_push_int(pending, grid_to_i(result->start, result->width));
 
@@ -430,6 +628,7 @@ struct pfdistances *prepare_pfdistances(struct player *p, struct loc start,
 		/* Try the neighbors. */
 		for (i = 0; i < 8; ++i) {
 			struct loc next = loc_sum(grid, ddgrid_ddd[i]);
+			int penalty;
 
 			/*
 			 * Skip points that are unreachable or which have
@@ -443,52 +642,27 @@ struct pfdistances *prepare_pfdistances(struct player *p, struct loc start,
 			 * Add next as a feasible point; penalize some terrain
 			 * if it is known and hard to traverse.
 			 */
-			if (!square_isknown(p->cave, next)
-					|| square_ispassable(p->cave, next)) {
-				result->rows[next.y][next.x] = cur_distance;
-			} else {
-				int penalty, penalized_distance;
-
-				if (square_iscloseddoor(p->cave, next)) {
-					penalty = (square_islockeddoor(p->cave,
-						next)) ? locked_penalty :
-						unlocked_penalty;
-				} else if (square_isrubble(p->cave, next)) {
-					if (square_ispassable(p->cave, next)) {
-						penalty = prubble_penalty;
-					} else {
-						penalty = rubble_penalty;
-					}
-				} else if (square_istree(p->cave, next)) {
-					penalty = tree_penalty;
-				} else {
-					/*
-					 * Should not happen, treat it as
-					 * completely impassable.
-					 */
-					continue;
-				}
-
-				if (cur_distance >= INT_MAX - penalty) {
-					/*
-					 * Will exceed the maximum allowed
-					 * distance so next is not feasible.
-					 */
-					continue;
-				}
-				penalized_distance = cur_distance + penalty;
-				if (result->rows[next.y][next.x]
-						<= penalized_distance) {
-					/*
-					 * Already have a path there that is
-					 * shorter or the same length.  Do not
-					 * need to consider this one.
-					 */
-					continue;
-				}
-				result->rows[next.y][next.x] =
-					penalized_distance;
+			penalty = step_penalty(p, next, &pen);
+			if (penalty < 0) {
+				continue;
 			}
+			if (cur_distance >= INT_MAX - penalty) {
+				/*
+				 * Will exceed the maximum allowed distance so
+				 * next is not feasible.
+				 */
+				continue;
+			}
+			if (result->rows[next.y][next.x]
+					<= cur_distance + penalty) {
+				/*
+				 * Already have a path there that is shorter
+				 * or the same length.  Do not need to consider
+				 * this one.
+				 */
+				continue;
+			}
+			result->rows[next.y][next.x] = cur_distance + penalty;
 
 			assert(q_len(pending) <= q_size(pending)
 				&& q_size(pending) > 0);
@@ -507,8 +681,6 @@ struct pfdistances *prepare_pfdistances(struct player *p, struct loc start,
 		}
 	} while (q_len(pending) > 0);
 
-	q_free(pending);
-
 	return result;
 }
 
@@ -635,14 +807,19 @@ int pfdistances_to_path(const struct pfdistances *a, struct loc grid,
 }
 
 /**
- * Release a path distance array computed by pfdistances_prepare().
+ * Release a path distance array computed by prepare_pfdistances().  The
+ * most recently computed arrays are kept for reuse by later calls.
  */
 void release_pfdistances(struct pfdistances *a)
 {
-	if (a) {
-		mem_free(a->buffer);
-		mem_free(a->rows);
-		mem_free(a);
+	if (!a) {
+		return;
+	}
+	if (a->cached) {
+		assert(a->users > 0);
+		--a->users;
+	} else {
+		free_pfdistances(a);
 	}
 }
 
@@ -671,6 +848,9 @@ static void initialize_patched_distances(struct pfdistances_patched *distances,
 		distances->patches[i] = mem_zalloc(distances->npatchx
 			* sizeof(**distances->patches));
 	}
+	distances->spare = NULL;
+	distances->num_spare = 0;
+	distances->max_spare = 0;
 }
 
 static void release_patched_distances(struct pfdistances_patched *distances)
@@ -689,6 +869,14 @@ static void release_patched_distances(struct pfdistances_patched *distances)
 		mem_free(distances->patches[i]);
 	}
 	mem_free(distances->patches);
+	distances->patches = NULL;
+	for (i = 0; i < distances->num_spare; ++i) {
+		mem_free(distances->spare[i]);
+	}
+	mem_free(distances->spare);
+	distances->spare = NULL;
+	distances->num_spare = 0;
+	distances->max_spare = 0;
 }
 
 static void clear_patched_distances(struct pfdistances_patched *distances)
@@ -702,7 +890,20 @@ static void clear_patched_distances(struct pfdistances_patched *distances)
 
 		assert(distances->patches[i]);
 		for (j = 0; j < distances->npatchx; ++j) {
-			mem_free(distances->patches[i][j]);
+			if (!distances->patches[i][j]) {
+				continue;
+			}
+			/* Keep the patch to be used again. */
+			if (distances->num_spare == distances->max_spare) {
+				distances->max_spare = (distances->max_spare) ?
+					2 * distances->max_spare : 16;
+				distances->spare = mem_realloc(distances->spare,
+					distances->max_spare
+					* sizeof(*distances->spare));
+			}
+			distances->spare[distances->num_spare] =
+				distances->patches[i][j];
+			++distances->num_spare;
 			distances->patches[i][j] = NULL;
 		}
 	}
@@ -723,8 +924,13 @@ static void initialize_patch(struct pfdistances_patched *distances,
 	patchx = grid.x >> distances->patch_shift;
 	assert(patchx >= 0 && patchx < distances->npatchx);
 	assert(!distances->patches[patchy][patchx]);
-	block = mem_alloc(distances->patch_size * distances->patch_size
-		* sizeof(*block));
+	if (distances->num_spare > 0) {
+		--distances->num_spare;
+		block = distances->spare[distances->num_spare];
+	} else {
+		block = mem_alloc(distances->patch_size
+			* distances->patch_size * sizeof(*block));
+	}
 	distances->patches[patchy][patchx] = block;
 
 	corner.y = patchy << distances->patch_shift;
@@ -953,6 +1159,253 @@ int path_nearest_known(struct player *p, struct loc start,
 	}
 }
 
+/**
+ * Storage kept from one call of path_nearest_unknown() to the next, so that
+ * each step of an explore command doesn't have to set up a distance array
+ * for the whole level.  Between searches, the distances are INT_MAX for
+ * every grid except those on the edge, which are -1 as they are for
+ * prepare_pfdistances(); a search records the grids it changes in touched
+ * and puts them back when it is done.
+ */
+static struct explore_workspace {
+	struct pfdistances dist;
+	bool *settled;
+	int *order;
+	int *touched, num_touched;
+	int *targets, num_targets, max_targets;
+	struct priority_queue *pending;
+} *explore;
+
+/**
+ * Release the explore workspace.
+ */
+static void explore_free(void)
+{
+	if (!explore) return;
+	mem_free(explore->dist.buffer);
+	mem_free(explore->dist.rows);
+	mem_free(explore->settled);
+	mem_free(explore->order);
+	mem_free(explore->touched);
+	mem_free(explore->targets);
+	qp_free(explore->pending, NULL);
+	mem_free(explore);
+	explore = NULL;
+}
+
+/**
+ * Get the explore workspace, set up for the dimensions of the player's
+ * map of the cave.
+ */
+static struct explore_workspace *explore_get(struct player *p)
+{
+	int height = p->cave->height, width = p->cave->width;
+	struct loc grid;
+
+	if (explore && explore->dist.height == height
+			&& explore->dist.width == width) {
+		return explore;
+	}
+	explore_free();
+	explore = mem_zalloc(sizeof(*explore));
+	explore->dist.buffer = mem_alloc(height * width
+		* sizeof(*explore->dist.buffer));
+	explore->dist.rows = mem_alloc(height * sizeof(*explore->dist.rows));
+	explore->dist.height = height;
+	explore->dist.width = width;
+	explore->settled = mem_zalloc(height * width
+		* sizeof(*explore->settled));
+	explore->order = mem_alloc(height * width * sizeof(*explore->order));
+	explore->touched = mem_alloc(height * width
+		* sizeof(*explore->touched));
+	explore->max_targets = 2 * (height + width);
+	explore->targets = mem_alloc(explore->max_targets
+		* sizeof(*explore->targets));
+	explore->pending = qp_new(2 * (height + width));
+	for (grid.y = 0; grid.y < height; ++grid.y) {
+		explore->dist.rows[grid.y] = explore->dist.buffer + grid.y * width;
+		for (grid.x = 0; grid.x < width; ++grid.x) {
+			explore->dist.rows[grid.y][grid.x] =
+				(square_in_bounds_fully(p->cave, grid)) ?
+				INT_MAX : -1;
+			explore->order[grid_to_i(grid, width)] = INT_MAX;
+		}
+	}
+	return explore;
+}
+
+/**
+ * Mark a grid as a possible destination for path_nearest_unknown().  Where
+ * more than one destination is equally close, the one with the smallest
+ * order wins.
+ */
+static void explore_add_target(struct explore_workspace *ws, struct loc grid,
+		int order)
+{
+	int i = grid_to_i(grid, ws->dist.width);
+
+	if (ws->order[i] == INT_MAX) {
+		if (ws->num_targets == ws->max_targets) {
+			ws->max_targets *= 2;
+			ws->targets = mem_realloc(ws->targets,
+				ws->max_targets * sizeof(*ws->targets));
+		}
+		ws->targets[ws->num_targets++] = i;
+	}
+	ws->order[i] = MIN(ws->order[i], order);
+}
+
+/**
+ * Set the distance to a grid in the explore workspace.
+ */
+static void explore_set_distance(struct explore_workspace *ws, int i,
+		int distance)
+{
+	if (ws->dist.buffer[i] == INT_MAX) {
+		ws->touched[ws->num_touched++] = i;
+	}
+	ws->dist.buffer[i] = distance;
+}
+
+/**
+ * Put the explore workspace back the way it was before the last search.
+ */
+static void explore_reset(struct explore_workspace *ws)
+{
+	int i;
+
+	for (i = 0; i < ws->num_touched; ++i) {
+		ws->dist.buffer[ws->touched[i]] = INT_MAX;
+		ws->settled[ws->touched[i]] = false;
+	}
+	ws->num_touched = 0;
+	for (i = 0; i < ws->num_targets; ++i) {
+		ws->order[ws->targets[i]] = INT_MAX;
+	}
+	ws->num_targets = 0;
+	qp_flush(ws->pending, NULL);
+}
+
+/**
+ * Help path_nearest_unknown():  search outwards from the starting point,
+ * nearest grids first, for the closest of the targets marked in the
+ * workspace.  Equally close means the same number of turns as
+ * pfdistances_to_turncount() would report, so the search can stop once
+ * every grid that close has been reached.  The distances to every grid that
+ * close are then exactly what prepare_pfdistances() would have computed,
+ * which is all pfdistances_to_path() needs to find the path back.
+ *
+ * \return the chosen target or loc(-1, -1) if none can be reached.
+ */
+static struct loc explore_search(struct explore_workspace *ws,
+		struct player *p, struct loc start, bool only_known,
+		bool forbid_traps)
+{
+	struct pf_penalties pen;
+	struct loc best = loc(-1, -1);
+	int width = ws->dist.width, limit = INT_MAX, best_order = INT_MAX;
+
+	compute_penalties(p, &pen);
+	ws->dist.start = start;
+	explore_set_distance(ws, grid_to_i(start, width), 0);
+	qp_push_int(ws->pending, 0, grid_to_i(start, width));
+	while (qp_len(ws->pending) > 0) {
+		int i = qp_pop_int(ws->pending), cur_distance, k;
+		struct loc grid;
+
+		/* Skip grids already reached by a shorter path */
+		if (ws->settled[i]) {
+			continue;
+		}
+		cur_distance = ws->dist.buffer[i];
+		if (cur_distance > limit) {
+			break;
+		}
+		ws->settled[i] = true;
+		i_to_grid(i, width, &grid);
+
+		if (ws->order[i] < best_order) {
+			if (limit == INT_MAX) {
+				/*
+				 * The largest distance that rounds to the
+				 * same number of turns as this one
+				 */
+				int turns = pfdistances_to_turncount(&ws->dist,
+					grid);
+
+				limit = turns * PF_SCL + (PF_SCL + 1) / 2 - 1;
+			}
+			best_order = ws->order[i];
+			best = grid;
+		}
+
+		if (cur_distance >= INT_MAX - PF_SCL) {
+			continue;
+		}
+		cur_distance += PF_SCL;
+		for (k = 0; k < 8; ++k) {
+			struct loc next = loc_sum(grid, ddgrid_ddd[k]);
+			int j = grid_to_i(next, width), penalty;
+
+			if (ws->dist.buffer[j] <= cur_distance) {
+				continue;
+			}
+			if (ws->dist.buffer[j] == INT_MAX && !is_valid_pf(p,
+					next, only_known, forbid_traps)) {
+				explore_set_distance(ws, j, -1);
+				continue;
+			}
+			penalty = step_penalty(p, next, &pen);
+			if (penalty < 0 || cur_distance >= INT_MAX - penalty
+					|| ws->dist.buffer[j]
+					<= cur_distance + penalty) {
+				continue;
+			}
+			if (qp_len(ws->pending) == qp_size(ws->pending)
+					&& qp_resize(ws->pending,
+					2 * qp_size(ws->pending), NULL)) {
+				/* Can not hold the new grid so skip it. */
+				continue;
+			}
+			explore_set_distance(ws, j, cur_distance + penalty);
+			qp_push_int(ws->pending, cur_distance + penalty, j);
+		}
+	}
+	return best;
+}
+
+/**
+ * Release everything kept from one pathfinding call to the next.
+ */
+static void pf_context_free(void)
+{
+	int i;
+
+	for (i = 0; i < PF_CACHE_SIZE; ++i) {
+		if (pf_ctx.cache[i]) {
+			free_pfdistances(pf_ctx.cache[i]);
+			pf_ctx.cache[i] = NULL;
+		}
+	}
+	if (pf_ctx.pending) {
+		q_free(pf_ctx.pending);
+		pf_ctx.pending = NULL;
+	}
+	if (pf_ctx.patched.patches) {
+		release_patched_distances(&pf_ctx.patched);
+	}
+	if (pf_ctx.paths) {
+		qp_free(pf_ctx.paths, NULL);
+		pf_ctx.paths = NULL;
+	}
+	explore_free();
+}
+
+struct init_module path_module = {
+	.name = "path",
+	.cleanup = pf_context_free
+};
+
 /**
  * Compute the path to either the nearest (to the starting point) known
  * passable grid that is not the staring point and has an unknown neighbor or,
@@ -980,80 +1433,63 @@ int path_nearest_unknown(struct player *p, struct loc start,
 	bool only_known = true, forbid_traps = true, passable = true;
 
 	while (1) {
-		struct pfdistances *distances = NULL;
+		struct explore_workspace *ws = explore_get(p);
 		struct loc min_grid = loc(-1, -1);
-		int min_turns = INT_MAX;
-		struct loc grid;
+		const struct loc *frontier;
+		int i, n = frontier_grids(p->cave, &frontier);
 
-		for (grid.y = 0; grid.y < p->cave->height; ++grid.y) {
-			for (grid.x = 0; grid.x < p->cave->width; ++grid.x) {
-				struct loc test_grid;
-				int turns;
+		/*
+		 * The candidates are all on the frontier; order them as a
+		 * scan of the whole map would have found them.
+		 */
+		for (i = 0; i < n; ++i) {
+			struct loc grid = frontier[i], test_grid;
 
-				if (loc_eq(grid, start)
-						|| !square_isknown(p->cave,
-						grid)) {
+			if (loc_eq(grid, start)) {
+				continue;
+			}
+			if (passable) {
+				if (!square_ispassable(p->cave, grid)) {
 					continue;
 				}
-				if (passable) {
-					if (!square_ispassable(p->cave, grid)
-							|| count_neighbors(NULL,
-							p->cave, grid,
-							square_isknown, false)
-							== 8) {
-						continue;
-					}
-					test_grid = grid;
-				} else {
-					if ((!square_iscloseddoor(p->cave, grid)
-							&& !square_isrubble(
-							p->cave, grid))
-							|| count_neighbors(NULL,
-							p->cave, grid,
-							square_isknown,
-							false) == 8) {
-						continue;
-					}
-					if (count_neighbors(&test_grid,
-							p->cave, grid,
-							square_isknownpassable,
-							false) == 0 ||
-							loc_eq(test_grid,
-							start)) {
-						continue;
-					}
-				}
-
-				if (!distances) {
-					distances = prepare_pfdistances(
-						p, start, only_known,
-						forbid_traps);
+				test_grid = grid;
+			} else {
+				if (!square_iscloseddoor(p->cave, grid)
+						&& !square_isrubble(p->cave,
+						grid)) {
+					continue;
 				}
-				turns = pfdistances_to_turncount(distances,
-					test_grid);
-				if (turns > 0 && min_turns > turns) {
-					min_turns = turns;
-					min_grid = test_grid;
+				if (count_neighbors(&test_grid, p->cave, grid,
+						square_isknownpassable,
+						false) == 0 ||
+						loc_eq(test_grid, start)) {
+					continue;
 				}
 			}
+			explore_add_target(ws, test_grid,
+				grid_to_i(grid, p->cave->width));
 		}
 
-		if (min_turns < INT_MAX) {
+		if (ws->num_targets > 0
+				&& square_in_bounds_fully(p->cave, start)) {
+			min_grid = explore_search(ws, p, start, only_known,
+				forbid_traps);
+		}
+
+		if (square_in_bounds(p->cave, min_grid)) {
 			int path_length;
 
-			assert(distances
-				&& square_in_bounds(p->cave, min_grid));
 			if (dest_grid) {
 				*dest_grid = min_grid;
 			}
-			path_length = pfdistances_to_path(distances,
+			path_length = pfdistances_to_path(&ws->dist,
 				min_grid, step_dirs);
-			release_pfdistances(distances);
+			explore_reset(ws);
 			assert(path_length > 0);
 			return path_length;
 		}
 
-		release_pfdistances(distances);
+		explore_reset(ws);
 		/*
 		 * No destination was found.  Try looser constraints on the
 		 * grids that can be in the path.
@@ -1088,6 +1524,613 @@ int path_nearest_unknown(struct player *p, struct loc start,
 	}
 }
 
+/**
+ * ------------------------------------------------------------------------
+ * Pathfinding over regions
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Long paths over the player's memory of a large level (a big wilderness
+ * or valley level, say) would have find_path() visit a very large number of
+ * grids.  Instead, the map is divided into square regions, and the places
+ * where a path can cross from one region into the next (portals) are joined
+ * in a graph whose edges carry the distance between portals of the same
+ * region and the distance across the border.  A long path is found by
+ * searching that graph, and then filling in the path between successive
+ * portals with find_path(), which only has short distances to cover.
+ *
+ * The graph hangs off the player's copy of the chunk, and is built lazily:
+ * path_regions_note() marks the regions around a grid whose memory has
+ * changed, and those are worked out again the next time the graph is used.
+ *
+ * The result need not be the shortest path, though it is never far off;
+ * only paths over remembered grids without known traps are found this way,
+ * anything else is left to find_path()'s search of the grids.
+ */
+
+/**
+ * Regions are this many grids (as a power of two) on a side
+ */
+#define PF_REGION_SHIFT 4
+#define PF_REGION_SIZE (1 << PF_REGION_SHIFT)
+
+/**
+ * The most portals a region can have; each side has at most half its length
+ * in separate openings
+ */
+#define PF_REGION_PORTALS (2 * PF_REGION_SIZE)
+
+/**
+ * Paths to destinations at least this far (in grids) away use the regions
+ */
+#define PF_REGION_FAR (2 * PF_REGION_SIZE)
+
+struct pf_portal {
+	/** This is the portal's grid, in the region. */
+	struct loc grid;
+	/** This is the grid next to it in the neighbouring region. */
+	struct loc across;
+	/** This is the distance for the step from grid to across. */
+	int across_cost;
+	/** This is the node number of the portal at across, or -1. */
+	int link;
+};
+
+struct pf_region {
+	/** This is true if the region has to be worked out again. */
+	bool dirty;
+	struct pf_portal portals[PF_REGION_PORTALS];
+	int num_portals;
+	/**
+	 * These are the distances between the portals, staying within the
+	 * region; -1 if there is no such path.
+	 */
+	int costs[PF_REGION_PORTALS][PF_REGION_PORTALS];
+};
+
+struct pf_regions {
+	int rows, cols;
+	struct pf_region *regions;
+	/** These are what the graph was worked out for. */
+	bool trapsafe;
+	struct pf_penalties pen;
+	/** This is storage for searches within a region. */
+	int local[PF_REGION_SIZE * PF_REGION_SIZE];
+	bool local_done[PF_REGION_SIZE * PF_REGION_SIZE];
+	/** This is storage for searches of the graph. */
+	int *node_dist, *node_prev;
+	bool *node_done;
+	struct priority_queue *pending;
+};
+
+/**
+ * Nodes of the graph are numbered by region and then portal; the start and
+ * destination of the path come after all of those.
+ */
+static int region_node(int r, int i)
+{
+	return r * PF_REGION_PORTALS + i;
+}
+
+static int region_at(const struct pf_regions *pr, struct loc grid)
+{
+	return (grid.y >> PF_REGION_SHIFT) * pr->cols
+		+ (grid.x >> PF_REGION_SHIFT);
+}
+
+static void region_bounds(const struct pf_regions *pr, struct chunk *c,
+		int r, struct loc *top_left, struct loc *bottom_right)
+{
+	top_left->y = (r / pr->cols) << PF_REGION_SHIFT;
+	top_left->x = (r % pr->cols) << PF_REGION_SHIFT;
+	bottom_right->y = MIN(top_left->y + PF_REGION_SIZE, c->height) - 1;
+	bottom_right->x = MIN(top_left->x + PF_REGION_SIZE, c->width) - 1;
+}
+
+/**
+ * Whether paths over regions may step into a grid
+ */
+static bool region_grid_ok(struct player *p, struct loc grid)
+{
+	return square_in_bounds_fully(p->cave, grid)
+		&& square_isknown(p->cave, grid)
+		&& is_valid_pf(p, grid, true, true);
+}
+
+/**
+ * Add a portal in the middle of an opening, or at both ends of a wide one.
+ * The two regions either side of the opening see it the same way, so they
+ * agree on where the portals are.
+ */
+static void region_add_opening(struct player *p, struct pf_region *region,
+		struct loc first, struct loc step, struct loc offset, int length,
+		const struct pf_penalties *pen)
+{
+	int at[2], n = 0, i;
+
+	if (length >= PF_REGION_SIZE / 2) {
+		at[n++] = 0;
+		at[n++] = length - 1;
+	} else {
+		at[n++] = length / 2;
+	}
+	for (i = 0; i < n; ++i) {
+		struct pf_portal *portal = &region->portals[region->num_portals];
+
+		assert(region->num_portals < PF_REGION_PORTALS);
+		portal->grid = loc(first.x + at[i] * step.x,
+			first.y + at[i] * step.y);
+		portal->across = loc_sum(portal->grid, offset);
+		portal->across_cost = PF_SCL
+			+ step_penalty(p, portal->across, pen);
+		portal->link = -1;
+		++region->num_portals;
+	}
+}
+
+/**
+ * Find the portals on the sides of a region
+ */
+static void region_find_portals(struct pf_regions *pr, struct player *p,
+		int r)
+{
+	struct pf_region *region = &pr->regions[r];
+	struct loc tl, br;
+	int side;
+
+	region_bounds(pr, p->cave, r, &tl, &br);
+	region->num_portals = 0;
+	for (side = 0; side < 4; ++side) {
+		/* Sides go north, east, south, west */
+		static const struct loc offsets[4] = {
+			{ 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 }
+		};
+		struct loc offset = offsets[side], step, grid, first;
+		int length, run = 0, i;
+
+		if (offset.x) {
+			grid = loc((offset.x > 0) ? br.x : tl.x, tl.y);
+			step = loc(0, 1);
+			length = br.y - tl.y + 1;
+		} else {
+			grid = loc(tl.x, (offset.y > 0) ? br.y : tl.y);
+			step = loc(1, 0);
+			length = br.x - tl.x + 1;
+		}
+		first = grid;
+		for (i = 0; i <= length; ++i) {
+			bool open = i < length && region_grid_ok(p, grid)
+				&& region_grid_ok(p, loc_sum(grid, offset));
+
+			if (open) {
+				if (!run) first = grid;
+				++run;
+			} else if (run) {
+				region_add_opening(p, region, first, step,
+					offset, run, &pr->pen);
+				run = 0;
+			}
+			grid = loc_sum(grid, step);
+		}
+	}
+}
+
+/**
+ * Index of a grid in pr->local, given the top left corner of its region
+ */
+static int local_index(struct loc tl, struct loc grid)
+{
+	return (grid.y - tl.y) * PF_REGION_SIZE + grid.x - tl.x;
+}
+
+/**
+ * Find the distances from (or, if reverse is true, to) a grid to (or from)
+ * every grid of a region, without leaving the region.  The distances are
+ * left in pr->local.
+ */
+static void region_search(struct pf_regions *pr, struct player *p, int r,
+		struct loc from, bool reverse)
+{
+	struct loc tl, br;
+	int i;
+
+	region_bounds(pr, p->cave, r, &tl, &br);
+	for (i = 0; i < PF_REGION_SIZE * PF_REGION_SIZE; ++i) {
+		pr->local[i] = INT_MAX;
+		pr->local_done[i] = false;
+	}
+	qp_flush(pr->pending, NULL);
+	pr->local[local_index(tl, from)] = 0;
+	qp_push_int(pr->pending, 0, local_index(tl, from));
+	while (qp_len(pr->pending) > 0) {
+		int li = qp_pop_int(pr->pending), dist, k, leave;
+		struct loc grid = loc(tl.x + li % PF_REGION_SIZE,
+			tl.y + li / PF_REGION_SIZE);
+
+		/* Skip grids already reached by a shorter path */
+		if (pr->local_done[li]) {
+			continue;
+		}
+		pr->local_done[li] = true;
+		dist = pr->local[li];
+		/* Going backwards, the step out of grid is the one into it */
+		leave = (reverse) ? PF_SCL + step_penalty(p, grid, &pr->pen)
+			: 0;
+		for (k = 0; k < 8; ++k) {
+			struct loc next = loc_sum(grid, ddgrid_ddd[k]);
+			int cost, nli;
+
+			if (next.y < tl.y || next.y > br.y || next.x < tl.x
+					|| next.x > br.x
+					|| !region_grid_ok(p, next)) {
+				continue;
+			}
+			cost = (reverse) ? leave
+				: PF_SCL + step_penalty(p, next, &pr->pen);
+			nli = local_index(tl, next);
+			if (pr->local[nli] <= dist + cost) {
+				continue;
+			}
+			pr->local[nli] = dist + cost;
+			if (qp_len(pr->pending) == qp_size(pr->pending)
+					&& qp_resize(pr->pending,
+					2 * qp_size(pr->pending), NULL)) {
+				continue;
+			}
+			qp_push_int(pr->pending, dist + cost, nli);
+		}
+	}
+}
+
+static int region_local_distance(struct pf_regions *pr, struct player *p,
+		int r, struct loc grid)
+{
+	struct loc tl, br;
+
+	region_bounds(pr, p->cave, r, &tl, &br);
+	return pr->local[local_index(tl, grid)];
+}
+
+/**
+ * Work out the distances between the portals of a region
+ */
+static void region_find_costs(struct pf_regions *pr, struct player *p, int r)
+{
+	struct pf_region *region = &pr->regions[r];
+	int i, j;
+
+	for (i = 0; i < region->num_portals; ++i) {
+		region_search(pr, p, r, region->portals[i].grid, false);
+		for (j = 0; j < region->num_portals; ++j) {
+			int dist = region_local_distance(pr, p, r,
+				region->portals[j].grid);
+
+			region->costs[i][j] = (dist == INT_MAX) ? -1 : dist;
+		}
+	}
+}
+
+/**
+ * Join a region's portals to those of its neighbours
+ */
+static void region_link(struct pf_regions *pr, struct player *p, int r)
+{
+	struct pf_region *region = &pr->regions[r];
+	int i;
+
+	for (i = 0; i < region->num_portals; ++i) {
+		struct pf_portal *portal = &region->portals[i];
+		int nr = region_at(pr, portal->across), j;
+
+		portal->link = -1;
+		for (j = 0; j < pr->regions[nr].num_portals; ++j) {
+			if (loc_eq(pr->regions[nr].portals[j].grid,
+					portal->across)) {
+				portal->link = region_node(nr, j);
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * Get the graph of regions for the player's memory of the cave, with
+ * anything that has changed worked out again
+ */
+static struct pf_regions *path_regions_get(struct player *p)
+{
+	struct pf_regions *pr = p->cave->path_regions;
+	struct pf_penalties pen;
+	bool trapsafe = player_is_trapsafe(p), any = false;
+	int r, n;
+
+	compute_penalties(p, &pen);
+	if (!pr) {
+		pr = mem_zalloc(sizeof(*pr));
+		pr->rows = (p->cave->height + PF_REGION_SIZE - 1)
+			>> PF_REGION_SHIFT;
+		pr->cols = (p->cave->width + PF_REGION_SIZE - 1)
+			>> PF_REGION_SHIFT;
+		n = pr->rows * pr->cols;
+		pr->regions = mem_zalloc(n * sizeof(*pr->regions));
+		pr->node_dist = mem_alloc((region_node(n, 0) + 2)
+			* sizeof(*pr->node_dist));
+		pr->node_prev = mem_alloc((region_node(n, 0) + 2)
+			* sizeof(*pr->node_prev));
+		pr->node_done = mem_alloc((region_node(n, 0) + 2)
+			* sizeof(*pr->node_done));
+		pr->pending = qp_new(4 * PF_REGION_SIZE);
+		for (r = 0; r < n; ++r) {
+			pr->regions[r].dirty = true;
+		}
+		pr->trapsafe = trapsafe;
+		pr->pen = pen;
+		p->cave->path_regions = pr;
+	}
+	n = pr->rows * pr->cols;
+
+	/* A change in the player can change every distance */
+	if (pr->trapsafe != trapsafe || memcmp(&pr->pen, &pen, sizeof(pen))) {
+		pr->trapsafe = trapsafe;
+		pr->pen = pen;
+		for (r = 0; r < n; ++r) {
+			pr->regions[r].dirty = true;
+		}
+	}
+
+	for (r = 0; r < n; ++r) {
+		if (pr->regions[r].dirty) {
+			region_find_portals(pr, p, r);
+			region_find_costs(pr, p, r);
+			any = true;
+		}
+	}
+	if (!any) return pr;
+
+	/* Rejoin the changed regions and their neighbours */
+	for (r = 0; r < n; ++r) {
+		int dy, dx, row = r / pr->cols, col = r % pr->cols;
+		bool relink = false;
+
+		for (dy = -1; dy <= 1 && !relink; ++dy) {
+			for (dx = -1; dx <= 1 && !relink; ++dx) {
+				int y = row + dy, x = col + dx;
+
+				if (y >= 0 && y < pr->rows && x >= 0
+						&& x < pr->cols
+						&& pr->regions[y * pr->cols
+						+ x].dirty) {
+					relink = true;
+				}
+			}
+		}
+		if (relink) {
+			region_link(pr, p, r);
+		}
+	}
+	for (r = 0; r < n; ++r) {
+		pr->regions[r].dirty = false;
+	}
+	return pr;
+}
+
+/**
+ * Note that the player's memory of a grid has changed, so the regions
+ * around it have to be worked out again.
+ */
+void path_regions_note(struct chunk *known, struct loc grid)
+{
+	struct pf_regions *pr = known->path_regions;
+	int d;
+
+	if (!pr) return;
+	for (d = 0; d < 9; ++d) {
+		struct loc adj = loc_sum(grid, ddgrid_ddd[d]);
+
+		if (square_in_bounds(known, adj)) {
+			pr->regions[region_at(pr, adj)].dirty = true;
+		}
+	}
+}
+
+/**
+ * Throw away the graph of regions for the player's memory of a chunk.
+ */
+void path_regions_free(struct chunk *known)
+{
+	struct pf_regions *pr = known->path_regions;
+
+	if (!pr) return;
+	mem_free(pr->regions);
+	mem_free(pr->node_dist);
+	mem_free(pr->node_prev);
+	mem_free(pr->node_done);
+	qp_free(pr->pending, NULL);
+	mem_free(pr);
+	known->path_regions = NULL;
+}
+
+/**
+ * Help find_path_regions():  the grid for a node of the graph.
+ */
+static struct loc region_node_grid(const struct pf_regions *pr, int node,
+		struct loc start, struct loc dest)
+{
+	int n = region_node(pr->rows * pr->cols, 0);
+
+	if (node == n) return start;
+	if (node == n + 1) return dest;
+	return pr->regions[node / PF_REGION_PORTALS]
+		.portals[node % PF_REGION_PORTALS].grid;
+}
+
+/**
+ * Help find_path():  find a long path over remembered grids by way of the
+ * graph of regions.
+ *
+ * \return the number of steps in the path, or -1 if no path was found
+ * this way.
+ */
+static int find_path_regions(struct player *p, struct loc start,
+		struct loc dest, int16_t **step_dirs)
+{
+	struct pf_regions *pr = path_regions_get(p);
+	int start_costs[PF_REGION_PORTALS], dest_costs[PF_REGION_PORTALS];
+	int rs = region_at(pr, start), rd = region_at(pr, dest);
+	int n = region_node(pr->rows * pr->cols, 0), start_node = n,
+		dest_node = n + 1;
+	int i, node, num_way, length, total;
+	int *way;
+	int16_t **segments;
+	int *seg_lengths;
+
+	/* Distances from the start and to the destination within regions */
+	region_search(pr, p, rs, start, false);
+	for (i = 0; i < pr->regions[rs].num_portals; ++i) {
+		int dist = region_local_distance(pr, p, rs,
+			pr->regions[rs].portals[i].grid);
+		start_costs[i] = (dist == INT_MAX) ? -1 : dist;
+	}
+	region_search(pr, p, rd, dest, true);
+	for (i = 0; i < pr->regions[rd].num_portals; ++i) {
+		int dist = region_local_distance(pr, p, rd,
+			pr->regions[rd].portals[i].grid);
+		dest_costs[i] = (dist == INT_MAX) ? -1 : dist;
+	}
+
+	/*
+	 * Search the graph, nearest first with the straight line distance
+	 * to the destination added as an estimate (which, since every step
+	 * costs at least PF_SCL, never overestimates).
+	 */
+	for (i = 0; i <= dest_node; ++i) {
+		pr->node_dist[i] = INT_MAX;
+		pr->node_prev[i] = -1;
+		pr->node_done[i] = false;
+	}
+	qp_flush(pr->pending, NULL);
+	pr->node_dist[start_node] = 0;
+	qp_push_int(pr->pending, 0, start_node);
+	while (qp_len(pr->pending) > 0) {
+		int edges[PF_REGION_PORTALS + 2][2], num_edges = 0, k, r;
+		struct pf_region *region;
+
+		node = qp_pop_int(pr->pending);
+		if (pr->node_done[node]) {
+			continue;
+		}
+		pr->node_done[node] = true;
+		if (node == dest_node) break;
+
+		/* Gather the edges out of the node */
+		if (node == start_node) {
+			for (k = 0; k < pr->regions[rs].num_portals; ++k) {
+				if (start_costs[k] >= 0) {
+					edges[num_edges][0] = region_node(rs, k);
+					edges[num_edges][1] = start_costs[k];
+					++num_edges;
+				}
+			}
+		} else {
+			r = node / PF_REGION_PORTALS;
+			i = node % PF_REGION_PORTALS;
+			region = &pr->regions[r];
+			for (k = 0; k < region->num_portals; ++k) {
+				if (k != i && region->costs[i][k] >= 0) {
+					edges[num_edges][0] = region_node(r, k);
+					edges[num_edges][1] =
+						region->costs[i][k];
+					++num_edges;
+				}
+			}
+			if (region->portals[i].link >= 0) {
+				edges[num_edges][0] = region->portals[i].link;
+				edges[num_edges][1] =
+					region->portals[i].across_cost;
+				++num_edges;
+			}
+			if (r == rd && dest_costs[i] >= 0) {
+				edges[num_edges][0] = dest_node;
+				edges[num_edges][1] = dest_costs[i];
+				++num_edges;
+			}
+		}
+
+		for (k = 0; k < num_edges; ++k) {
+			int next = edges[k][0];
+			int dist = pr->node_dist[node] + edges[k][1];
+			struct loc grid = region_node_grid(pr, next, start,
+				dest);
+			int estimate = PF_SCL * MAX(ABS(dest.y - grid.y),
+				ABS(dest.x - grid.x));
+
+			if (pr->node_done[next] || pr->node_dist[next] <= dist) {
+				continue;
+			}
+			pr->node_dist[next] = dist;
+			pr->node_prev[next] = node;
+			if (qp_len(pr->pending) == qp_size(pr->pending)
+					&& qp_resize(pr->pending,
+					2 * qp_size(pr->pending), NULL)) {
+				continue;
+			}
+			qp_push_int(pr->pending, dist + estimate, next);
+		}
+	}
+	if (pr->node_dist[dest_node] == INT_MAX) {
+		return -1;
+	}
+
+	/* List the grids the path goes through, from the destination back */
+	num_way = 0;
+	for (node = dest_node; node >= 0; node = pr->node_prev[node]) {
+		++num_way;
+	}
+	way = mem_alloc(num_way * sizeof(*way));
+	i = 0;
+	for (node = dest_node; node >= 0; node = pr->node_prev[node]) {
+		way[i++] = node;
+	}
+
+	/* Fill in the path between each grid and the next */
+	segments = mem_zalloc(num_way * sizeof(*segments));
+	seg_lengths = mem_zalloc(num_way * sizeof(*seg_lengths));
+	total = 0;
+	for (i = 0; i + 1 < num_way; ++i) {
+		struct loc to = region_node_grid(pr, way[i], start, dest);
+		struct loc from = region_node_grid(pr, way[i + 1], start, dest);
+
+		length = find_path(p, from, to, &segments[i]);
+		if (length < 0) {
+			total = -1;
+			break;
+		}
+		seg_lengths[i] = length;
+		total += length;
+	}
+
+	/* Join the pieces; the steps are stored in reverse order */
+	if (total > 0 && step_dirs) {
+		int at = 0;
+
+		*step_dirs = mem_alloc(total * sizeof(**step_dirs));
+		for (i = 0; i + 1 < num_way; ++i) {
+			if (seg_lengths[i] > 0) {
+				memcpy(*step_dirs + at, segments[i],
+					seg_lengths[i] * sizeof(**step_dirs));
+				at += seg_lengths[i];
+			}
+		}
+	}
+	for (i = 0; i < num_way; ++i) {
+		mem_free(segments[i]);
+	}
+	mem_free(segments);
+	mem_free(seg_lengths);
+	mem_free(way);
+	return (total > 0) ? total : -1;
+}
+
 /**
  * Compute the path from one location to another using the given player's
  * knowledge of the cave.
@@ -1109,7 +2152,9 @@ int path_nearest_unknown(struct player *p, struct loc start,
  * pfdistances_to_path(), and release_pfdistances().  When there are paths
  * of the same distances (in expected turncounts) between start and dest, the
  * path returned by find_path() may be different than that returned by
- * pfdistances_to_path().
+ * pfdistances_to_path().  Long paths over remembered grids are found by way
+ * of the regions (see find_path_regions()) and may be a little longer than
+ * the shortest.
  */
 int find_path(struct player *p, struct loc start, struct loc dest,
 		int16_t **step_dirs)
@@ -1121,7 +2166,7 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 	 * parts of the cave that are not traversed when moving to the
 	 * destination.
 	 */
-	struct pfdistances_patched distances;
+	struct pfdistances_patched *distances = &pf_ctx.patched;
 	struct priority_queue *pending;
 	struct loc next;
 	int dist_next;
@@ -1144,6 +2189,17 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 		return 0;
 	}
 
+	/* Long paths over remembered grids go by way of the regions. */
+	if (MAX(ABS(start.y - dest.y), ABS(start.x - dest.x)) >= PF_REGION_FAR
+			&& square_isknown(p->cave, start)
+			&& region_grid_ok(p, dest)) {
+		int length = find_path_regions(p, start, dest, step_dirs);
+
+		if (length > 0) {
+			return length;
+		}
+	}
+
 	/*
 	 * If both the starting point and destination are remembered grids,
 	 * first try paths that only traverse remembered grids.  If there are
@@ -1184,15 +2240,28 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 	prubble_penalty = compute_passable_rubble_penalty(p);
 	tree_penalty = compute_tree_penalty(p);
 
-	initialize_patched_distances(&distances, p->cave->height,
-		p->cave->width);
+	/*
+	 * Reuse the distances and queue from the last call; both are left
+	 * empty at the end of each call.
+	 */
+	if (distances->patches && (distances->height != p->cave->height
+			|| distances->width != p->cave->width)) {
+		release_patched_distances(distances);
+	}
+	if (!distances->patches) {
+		initialize_patched_distances(distances, p->cave->height,
+			p->cave->width);
+	}
 
 	/* Set up the priority queue of feasible paths to consider. */
-	pending = qp_new(4 * (2 + MAX(ABS(start.y - dest.y),
-		ABS(start.x - dest.x))));
+	if (!pf_ctx.paths) {
+		pf_ctx.paths = qp_new(4 * (2 + MAX(ABS(start.y - dest.y),
+			ABS(start.x - dest.x))));
+	}
+	pending = pf_ctx.paths;
 
-	initialize_patch(&distances, start, p, only_known, forbid_traps);
-	set_patched_distance(&distances, start, 0);
+	initialize_patch(distances, start, p, only_known, forbid_traps);
+	set_patched_distance(distances, start, 0);
 	next = start;
 	dist_next = 0;
 	while (1) {
@@ -1208,19 +2277,19 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 			if (loc_eq(this_grid, dest)) {
 				/* Reached the destination. */
 				int length = patched_distances_to_path(
-					&distances, start, dest,
+					distances, start, dest,
 					step_dirs);
 
-				release_patched_distances(&distances);
-				qp_free(pending, NULL);
+				clear_patched_distances(distances);
+				qp_flush(pending, NULL);
 				return length;
 			}
 
-			if (!has_patched_distance(&distances, this_grid)) {
-				initialize_patch(&distances, this_grid,
+			if (!has_patched_distance(distances, this_grid)) {
+				initialize_patch(distances, this_grid,
 					p, only_known, forbid_traps);
 			}
-			dist_stored = get_patched_distance(&distances,
+			dist_stored = get_patched_distance(distances,
 				this_grid);
 			if (dist_stored <= dist_this) {
 				/*
@@ -1313,9 +2382,9 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 						 * Could not resize so give
 						 * up.
 						 */
-						release_patched_distances(
-							&distances);
-						qp_free(pending, NULL);
+						clear_patched_distances(
+							distances);
+						qp_flush(pending, NULL);
 						if (step_dirs) {
 							*step_dirs = NULL;
 						}
@@ -1326,7 +2395,7 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 			}
 			add_grid = grid_to_i(this_grid, p->cave->width);
 			add_priority = dist_this + penalty + dist_remaining;
-			set_patched_distance(&distances, this_grid,
+			set_patched_distance(distances, this_grid,
 				dist_this + penalty);
 		}
 
@@ -1346,10 +2415,10 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 					 * known visible traps.
 					 */
 					forbid_traps = false;
-					clear_patched_distances(&distances);
-					initialize_patch(&distances, start,
+					clear_patched_distances(distances);
+					initialize_patch(distances, start,
 						p, only_known, forbid_traps);
-					set_patched_distance(&distances,
+					set_patched_distance(distances,
 						start, 0);
 					next = start;
 					dist_next = 0;
@@ -1367,18 +2436,18 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 						forbid_traps = false;
 					}
 					hit_trap = false;
-					clear_patched_distances(&distances);
-					initialize_patch(&distances, start,
+					clear_patched_distances(distances);
+					initialize_patch(distances, start,
 						p, only_known, forbid_traps);
-					set_patched_distance(&distances,
+					set_patched_distance(distances,
 						start, 0);
 					next = start;
 					dist_next = 0;
 					continue;
 				}
 				/* Nothing to retry so give up. */
-				release_patched_distances(&distances);
-				qp_free(pending, NULL);
+				clear_patched_distances(distances);
+				qp_flush(pending, NULL);
 				if (step_dirs) {
 					*step_dirs = NULL;
 				}
@@ -1387,8 +2456,8 @@ int find_path(struct player *p, struct loc start, struct loc dest,
 			i_to_grid(qp_pop_int(pending), p->cave->width, &next);
 		}
 		/* The relevant patch should already have been initialized. */
-		assert(has_patched_distance(&distances, next));
-		dist_next = get_patched_distance(&distances, next);
+		assert(has_patched_distance(distances, next));
+		dist_next = get_patched_distance(distances, next);
 	}
 }
 
@@ -37,6 +37,8 @@ int path_nearest_unknown(struct player *p, struct loc start,
 		struct loc *dest_grid, int16_t **step_dirs);
 int find_path(struct player *p, struct loc start, struct loc dest,
 		int16_t **step_dirs);
+void path_regions_note(struct chunk *known, struct loc grid);
+void path_regions_free(struct chunk *known);
 int pathfind_direction_to(struct loc from, struct loc to);
 void run_step(int dir);
 
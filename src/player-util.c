@@ -158,6 +158,70 @@ int player_get_next_place(int place, const char *direction, int multiple)
 	return next_place;
 }
 
+/**
+ * Get the direction a path is heading
+ */
+static const char *path_direction(int feat)
+{
+	if (feat == FEAT_LESS_NORTH) return "north";
+	if (feat == FEAT_MORE_NORTH) return "north";
+	if (feat == FEAT_LESS_EAST) return "east";
+	if (feat == FEAT_MORE_EAST) return "east";
+	if (feat == FEAT_LESS_SOUTH) return "south";
+	if (feat == FEAT_MORE_SOUTH) return "south";
+	if (feat == FEAT_LESS_WEST) return "west";
+	if (feat == FEAT_MORE_WEST) return "west";
+	if (feat == FEAT_LESS) return "up";
+	if (feat == FEAT_MORE) return "down";
+	return "";
+}
+
+/**
+ * Get the return path of a path or stair (sigh)
+ */
+static int return_path(int feat)
+{
+	if (feat == FEAT_LESS_NORTH) return FEAT_MORE_SOUTH;
+	if (feat == FEAT_MORE_NORTH) return FEAT_LESS_SOUTH;
+	if (feat == FEAT_LESS_EAST) return FEAT_MORE_WEST;
+	if (feat == FEAT_MORE_EAST) return FEAT_LESS_WEST;
+	if (feat == FEAT_LESS_SOUTH) return FEAT_MORE_NORTH;
+	if (feat == FEAT_MORE_SOUTH) return FEAT_LESS_NORTH;
+	if (feat == FEAT_LESS_WEST) return FEAT_MORE_EAST;
+	if (feat == FEAT_MORE_WEST) return FEAT_LESS_EAST;
+	if (feat == FEAT_LESS) return FEAT_MORE;
+	if (feat == FEAT_MORE) return FEAT_LESS;
+	return -1;
+}
+
+/**
+ * Get the place on the world map that stairs or a path lead to from where the
+ * player is now, or -1 if they lead nowhere
+ */
+int player_stairs_place(struct player *p, int feat)
+{
+	return player_get_next_place(p->place, path_direction(feat), 1);
+}
+
+/**
+ * Set the player up to arrive on the way back from the far end of the stairs
+ * or path they are standing on
+ */
+void player_set_way_back(struct player *p, int feat)
+{
+	/* Create a way back */
+	p->upkeep->create_stair = return_path(feat);
+
+	/* Record the non-obvious exit coordinate */
+	if ((feat == FEAT_LESS_NORTH) || (feat == FEAT_MORE_NORTH) ||
+		(feat == FEAT_LESS_SOUTH) || (feat == FEAT_MORE_SOUTH)) {
+		p->upkeep->path_coord = p->grid.x;
+	} else if ((feat == FEAT_LESS_EAST) || (feat == FEAT_MORE_EAST) ||
+			   (feat == FEAT_LESS_WEST) || (feat == FEAT_MORE_WEST)) {
+		p->upkeep->path_coord = p->grid.y;
+	}
+}
+
 /**
  * Give the player the choice of persistent level to recall to.  Note that if
  * a level greater than the player's maximum depth is chosen, we silently go
@@ -245,8 +309,9 @@ void player_change_place(struct player *p, int place)
 	lev->visited = true;
 
 	/* If we're returning to town, update the store contents
-	   according to how long we've been away */
-	if (!p->depth && daycount)
+	   according to how long we've been away, or since the town's stores
+	   were last maintained */
+	if (!p->depth)
 		store_update();
 
 	/* Leaving, make new level */
@@ -1120,7 +1185,7 @@ void player_add_speed_boost(struct player *p, int value)
 	p->speed_boost = MIN(p->speed_boost + value, max_speed_boost);
 
 	/* Recalculate bonuses */
-	p->upkeep->update |= (PU_BONUS);
+	p->upkeep->update |= (PU_BONUS_QUICK);
 }
 
 /**
@@ -1891,7 +1956,7 @@ void player_handle_post_move(struct player *p, bool eval_trap,
 	}
 
 	/* Speed or stealth may change */
-	player->upkeep->update |= (PU_BONUS);
+	player->upkeep->update |= (PU_BONUS_QUICK);
 
 	/* Discover invisible traps, set off visible ones */
 	if (eval_trap && square_isplayertrap(cave, p->grid)
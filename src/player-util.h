@@ -64,6 +64,8 @@ enum
 bool underworld_possible(int place);
 bool mountain_top_possible(int place);
 int player_get_next_place(int place, const char *direction, int multiple);
+int player_stairs_place(struct player *p, int feat);
+void player_set_way_back(struct player *p, int feat);
 bool player_get_recall_point(struct player *p);
 void player_change_place(struct player *p, int place);
 int player_apply_damage_reduction(struct player *p, int dam);
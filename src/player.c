@@ -496,6 +496,7 @@ static void init_player(void) {
  * Free player struct
  */
 static void cleanup_player(void) {
+	cleanup_equip_bonuses();
 	if (!player) return;
 
 	player_cleanup_members(player);
@@ -29,6 +29,10 @@
 #include "project.h"
 #include "source.h"
 #include "trap.h"
+#include "z-index.h"
+#include "z-profile.h"
+
+PROFILE_COUNTER(project, "grids");
 
 struct projection *projections;
 
@@ -57,15 +61,24 @@ static const char *proj_name_list[] =
     NULL
 };
 
+/**
+ * Index of projection names, ignoring case, made the first time one is
+ * looked up
+ */
+static struct name_index *proj_by_name;
+
 int proj_name_to_idx(const char *name)
 {
     int i;
-    for (i = 0; proj_name_list[i]; i++) {
-        if (!my_stricmp(name, proj_name_list[i]))
-            return i;
+
+    if (!proj_by_name) {
+        proj_by_name = name_index_new(true);
+        for (i = 0; proj_name_list[i]; i++) {
+            name_index_add(proj_by_name, 0, proj_name_list[i], i);
+        }
     }
 
-    return -1;
+    return name_index_find(proj_by_name, 0, name);
 }
 
 const char *proj_idx_to_name(int type)
@@ -434,6 +447,158 @@ struct loc origin_get_loc(struct source origin)
 	return loc(-1, -1);
 }
 
+/**
+ * ------------------------------------------------------------------------
+ * Blast areas
+ * ------------------------------------------------------------------------ */
+/**
+ * Offsets of every grid within the largest radius asked for so far, in
+ * order of distance from the centre, and the number within each radius
+ */
+static struct loc *stencil_grid;
+static int *stencil_num;
+static int stencil_rad = -1;
+
+/**
+ * Make sure the stencil covers radius rad
+ */
+static void stencil_build(int rad)
+{
+	int dist, y, x, n = 0;
+	int *count;
+
+	if (rad <= stencil_rad) return;
+
+	mem_free(stencil_grid);
+	mem_free(stencil_num);
+	stencil_grid = mem_alloc((2 * rad + 1) * (2 * rad + 1) *
+		sizeof(*stencil_grid));
+	stencil_num = mem_zalloc((rad + 1) * sizeof(*stencil_num));
+	count = mem_zalloc((rad + 1) * sizeof(*count));
+
+	/* Count the grids at each distance */
+	for (y = -rad; y <= rad; y++) {
+		for (x = -rad; x <= rad; x++) {
+			dist = distance(loc(0, 0), loc(x, y));
+			if (dist <= rad) count[dist]++;
+		}
+	}
+	for (dist = 0; dist <= rad; dist++) {
+		n += count[dist];
+		stencil_num[dist] = n;
+		count[dist] = n - count[dist];
+	}
+
+	/* File them, row by row within each distance */
+	for (y = -rad; y <= rad; y++) {
+		for (x = -rad; x <= rad; x++) {
+			dist = distance(loc(0, 0), loc(x, y));
+			if (dist <= rad) stencil_grid[count[dist]++] = loc(x, y);
+		}
+	}
+
+	mem_free(count);
+	stencil_rad = rad;
+}
+
+static void cleanup_project(void)
+{
+	mem_free(stencil_grid);
+	mem_free(stencil_num);
+	stencil_grid = NULL;
+	stencil_num = NULL;
+	stencil_rad = -1;
+	name_index_free(proj_by_name);
+	proj_by_name = NULL;
+}
+
+struct init_module project_module = {
+	.name = "project",
+	.cleanup = cleanup_project
+};
+
+/**
+ * The grids affected by a projection
+ */
+struct blast_area {
+	struct loc *grid;
+	int *dist;
+	bool *seen;
+	int num;
+	int max;
+};
+
+/**
+ * Add a grid to a blast area, marking it for processing
+ */
+static void blast_add(struct blast_area *blast, struct loc grid, int dist)
+{
+	if (blast->num == blast->max) {
+		blast->max = blast->max ? 2 * blast->max : 64;
+		blast->grid = mem_realloc(blast->grid,
+			blast->max * sizeof(*blast->grid));
+		blast->dist = mem_realloc(blast->dist,
+			blast->max * sizeof(*blast->dist));
+		blast->seen = mem_realloc(blast->seen,
+			blast->max * sizeof(*blast->seen));
+	}
+	blast->grid[blast->num] = grid;
+	blast->dist[blast->num] = dist;
+	blast->num++;
+	sqinfo_on(square(cave, grid)->info, SQUARE_PROJECT);
+}
+
+static void blast_free(struct blast_area *blast)
+{
+	mem_free(blast->grid);
+	mem_free(blast->dist);
+	mem_free(blast->seen);
+}
+
+/**
+ * What is known about each grid near the centre of an explosion
+ */
+#define BLAST_LOS_KNOWN	0x01
+#define BLAST_LOS		0x02
+#define BLAST_ON_PATH	0x04
+
+struct blast_map {
+	struct loc centre;
+	int rad;
+	int side;
+	uint8_t *info;
+};
+
+static uint8_t *blast_map_info(struct blast_map *map, struct loc grid)
+{
+	int x = grid.x - map->centre.x + map->rad;
+	int y = grid.y - map->centre.y + map->rad;
+
+	if (x < 0 || y < 0 || x >= map->side || y >= map->side) return NULL;
+	return &map->info[y * map->side + x];
+}
+
+/**
+ * Check line of sight from the centre to a grid, remembering the answer
+ *
+ * The player's view is worked out the same way, with a los() check for each
+ * grid in range (see update_view_one()), so there is no cheaper pass over the
+ * whole area to borrow.  Remembering the answers means each grid is checked
+ * once, however many of its neighbours are walls asking about it, and grids
+ * the blast never asks about aren't checked at all.
+ */
+static bool blast_los(struct blast_map *map, struct loc grid)
+{
+	uint8_t *info = blast_map_info(map, grid);
+
+	if (!info) return los(cave, map->centre, grid);
+	if (!(*info & BLAST_LOS_KNOWN)) {
+		*info |= BLAST_LOS_KNOWN;
+		if (los(cave, map->centre, grid)) *info |= BLAST_LOS;
+	}
+	return (*info & BLAST_LOS) ? true : false;
+}
+
 /**
  * Generic "beam"/"bolt"/"ball" projection routine.
  *   -BEN-, some changes by -LM-
@@ -547,8 +712,9 @@ struct loc origin_get_loc(struct source origin)
  *   to a grid in LOS) within their radius.  Arcs do the same, but only within 
  *   their cone of projection.
  * Because affected grids are only scanned once, and it is really helpful to 
- *   have explosions that travel outwards from the source, they are sorted by 
- *   distance.  For each distance, an adjusted damage is calculated.
+ *   have explosions that travel outwards from the source, they are collected 
+ *   in order of distance.  For each distance, an adjusted damage is 
+ *   calculated.
  * In successive passes, the code then displays explosion graphics, erases 
  *   these graphics, marks terrain for possible later changes, affects 
  *   objects, monsters, the character, and finally changes features and 
@@ -557,10 +723,9 @@ struct loc origin_get_loc(struct source origin)
  *
  * Usage and graphics notes:
  *
- * Only 256 grids can be affected per projection, limiting the effective 
- * radius of standard ball attacks to nine units (diameter nineteen).  Arcs 
- * can have larger radii; an arc capable of going out to range 20 should not 
- * be wider than 70 degrees.
+ * Explosions are built from a precomputed stencil of the grids within each
+ * radius, already in order of distance, and may be any size.  The radius of
+ * arcs is limited to 20.
  *
  * Balls must explode BEFORE hitting walls, or they would affect monsters on 
  * both sides of a wall. 
@@ -584,7 +749,7 @@ bool project(struct source origin, int rad, struct loc finish,
 			 int degrees_of_arc, uint8_t diameter_of_source,
 			 const struct object *obj)
 {
-	int i, j, k, dist_from_centre;
+	int i;
 
 	uint32_t dam_temp;
 
@@ -607,22 +772,14 @@ bool project(struct source origin, int rad, struct loc finish,
 	int num_path_grids = 0;
 
 	/* Actual grids in the "path" */
-	struct loc path_grid[512];
-
-	/* Number of grids in the "blast area" (including the "beam" path) */
-	int num_grids = 0;
-
-	/* Coordinates of the affected grids */
-	struct loc blast_grid[256];
+	struct loc *path_grid = mem_alloc(z_info->max_range * sizeof(*path_grid));
 
-	/* Distance to each of the affected grids. */
-	int distance_to_grid[256];
-
-	/* Player visibility of each of the affected grids. */
-	bool player_sees_grid[256];
+	/* Grids in the "blast area" (including the "beam" path) */
+	struct blast_area blast = { NULL, NULL, NULL, 0, 0 };
 
 	/* Precalculated damage values for each distance. */
 	int *dam_at_dist = mem_alloc((z_info->max_range + 1) * sizeof(*dam_at_dist));
+	PROFILE_START(project);
 
 	/* Flush any pending output */
 	handle_stuff(player);
@@ -664,11 +821,8 @@ bool project(struct source origin, int rad, struct loc finish,
 	 * projection path.
 	 */
 	if (loc_eq(start, finish)) {
-		blast_grid[num_grids] =  finish;
+		blast_add(&blast, finish, 0);
 		centre = finish;
-		distance_to_grid[num_grids] = 0;
-		sqinfo_on(square(cave, finish)->info, SQUARE_PROJECT);
-		num_grids++;
 	} else {
 		/* Start from caster */
 		int y = start.y;
@@ -708,17 +862,9 @@ bool project(struct source origin, int rad, struct loc finish,
 				/* Beams collect all grids in the path, all other methods
 				 * collect only the final grid in the path. */
 				if (flg & (PROJECT_BEAM)) {
-					blast_grid[num_grids].y = y;
-					blast_grid[num_grids].x = x;
-					distance_to_grid[num_grids] = 0;
-					sqinfo_on(square(cave, loc(x, y))->info, SQUARE_PROJECT);
-					num_grids++;
+					blast_add(&blast, loc(x, y), 0);
 				} else if (i == num_path_grids - 1) {
-					blast_grid[num_grids].y = y;
-					blast_grid[num_grids].x = x;
-					distance_to_grid[num_grids] = 0;
-					sqinfo_on(square(cave, loc(x, y))->info, SQUARE_PROJECT);
-					num_grids++;
+					blast_add(&blast, loc(x, y), 0);
 				}
 
 				/* Only do visuals if requested and within range limit. */
@@ -742,7 +888,7 @@ bool project(struct source origin, int rad, struct loc finish,
 	 * will affect; all non-beam projections with positive radius explode in
 	 * some way */
 	if ((rad > 0) && (!(flg & (PROJECT_BEAM)))) {
-		int y, x;
+		struct blast_map map;
 
 		/* Pre-calculate some things for arcs. */
 		if ((flg & (PROJECT_ARC)) && (num_path_grids != 0)) {
@@ -765,101 +911,95 @@ bool project(struct source origin, int rad, struct loc finish,
 		}
 
 		/* If the explosion centre hasn't been saved already, save it now. */
-		if (num_grids == 0) {
-			blast_grid[num_grids] = centre;
-			distance_to_grid[num_grids] = 0;
-			sqinfo_on(square(cave, centre)->info, SQUARE_PROJECT);
-			num_grids++;
+		if (blast.num == 0) {
+			blast_add(&blast, centre, 0);
 		}
 
-		/* Scan every grid that might possibly be in the blast radius. */
-		for (y = centre.y - rad; y <= centre.y + rad; y++) {
-			for (x = centre.x - rad; x <= centre.x + rad; x++) {
-				struct loc grid = loc(x, y);
-				bool on_path = false;
-
-				/* Center grid has already been stored. */
-				if (loc_eq(grid, centre))
-					continue;
+		/* Map the grids in reach, including walls next to the blast, and
+		 * mark those on the projection path */
+		map.centre = centre;
+		map.rad = rad + 1;
+		map.side = 2 * map.rad + 1;
+		map.info = mem_zalloc(map.side * map.side * sizeof(*map.info));
+		for (i = 0; i < num_path_grids; i++) {
+			uint8_t *info = blast_map_info(&map, path_grid[i]);
+			if (info) *info |= BLAST_ON_PATH;
+		}
 
-				/* Precaution: Stay within area limit. */
-				if (num_grids >= 255)
-					break;
+		/* Scan every grid within the blast radius, nearest first; the
+		 * centre grid has already been stored. */
+		stencil_build(rad);
+		for (i = 1; i < stencil_num[rad]; i++) {
+			struct loc grid = loc_sum(centre, stencil_grid[i]);
+			bool on_path;
+			int dist_from_centre;
 
-				/* Ignore "illegal" locations */
-				if (!square_in_bounds(cave, grid))
-					continue;
+			/* Ignore "illegal" locations */
+			if (!square_in_bounds(cave, grid))
+				continue;
 
-				/* Most explosions are immediately stopped by walls. If
-				 * PROJECT_THRU is set, walls can be affected if adjacent to
-				 * a grid visible from the explosion centre - note that as of
-				 * Angband 3.5.0 there are no such explosions - NRM.
-				 * All explosions can affect one layer of terrain which is
-				 * passable but not projectable */
-				if ((flg & (PROJECT_THRU)) || square_ispassable(cave, grid)) {
-					/* If this is a wall grid, ... */
-					if (!square_isprojectable(cave, grid)) {
-						bool can_see_one = false;
-						/* Check neighbors */
-						for (i = 0; i < 8; i++) {
-							struct loc adj_grid = loc_sum(grid, ddgrid_ddd[i]);
-							if (los(cave, centre, adj_grid)) {
-								can_see_one = true;
-								break;
-							}
+			/* Most explosions are immediately stopped by walls. If
+			 * PROJECT_THRU is set, walls can be affected if adjacent to
+			 * a grid visible from the explosion centre - note that as of
+			 * Angband 3.5.0 there are no such explosions - NRM.
+			 * All explosions can affect one layer of terrain which is
+			 * passable but not projectable */
+			if ((flg & (PROJECT_THRU)) || square_ispassable(cave, grid)) {
+				/* If this is a wall grid, ... */
+				if (!square_isprojectable(cave, grid)) {
+					bool can_see_one = false;
+					int j;
+
+					/* Check neighbors */
+					for (j = 0; j < 8; j++) {
+						struct loc adj_grid = loc_sum(grid, ddgrid_ddd[j]);
+						if (blast_los(&map, adj_grid)) {
+							can_see_one = true;
+							break;
 						}
-
-						/* Require at least one adjacent grid in LOS. */
-						if (!can_see_one)
-							continue;
 					}
-				} else if (!square_isprojectable(cave, grid))
-					continue;
-
-				/* Must be within maximum distance. */
-				dist_from_centre  = (distance(centre, grid));
-				if (dist_from_centre > rad)
-					continue;
 
-				/* Mark grids which are on the projection path */
-				for (i = 0; i < num_path_grids; i++) {
-					if (loc_eq(grid, path_grid[i])) {
-						on_path = true;
-					}
-				}
-
-				/* Do we need to consider a restricted angle? */
-				if (flg & (PROJECT_ARC)) {
-					/* Use angle comparison to delineate an arc. */
-					int n2y, n2x, tmp, rotate, diff;
-
-					/* Reorient current grid for table access. */
-					n2y = y - start.y + 20;
-					n2x = x - start.x + 20;
-
-					/* Find the angular difference (/2) between the lines to
-					 * the end of the arc's center-line and to the current grid.
-					 */
-					rotate = 90 - get_angle_to_grid[n1y][n1x];
-					tmp = ABS(get_angle_to_grid[n2y][n2x] + rotate) % 180;
-					diff = ABS(90 - tmp);
-
-					/* If difference is greater then that allowed, skip it,
-					 * unless it's on the target path */
-					if ((diff >= (degrees_of_arc + 6) / 4) && !on_path)
+					/* Require at least one adjacent grid in LOS. */
+					if (!can_see_one)
 						continue;
 				}
+			} else if (!square_isprojectable(cave, grid))
+				continue;
 
-				/* Accept remaining grids if in LOS or on the projection path */
-				if (los(cave, centre, grid) || on_path) {
-					blast_grid[num_grids].y = y;
-					blast_grid[num_grids].x = x;
-					distance_to_grid[num_grids] = dist_from_centre;
-					sqinfo_on(square(cave, grid)->info, SQUARE_PROJECT);
-					num_grids++;
-				}
+			/* Mark grids which are on the projection path */
+			on_path = (*blast_map_info(&map, grid) & BLAST_ON_PATH) ?
+				true : false;
+			dist_from_centre = distance(centre, grid);
+
+			/* Do we need to consider a restricted angle? */
+			if (flg & (PROJECT_ARC)) {
+				/* Use angle comparison to delineate an arc. */
+				int n2y, n2x, tmp, rotate, diff;
+
+				/* Reorient current grid for table access. */
+				n2y = grid.y - start.y + 20;
+				n2x = grid.x - start.x + 20;
+
+				/* Find the angular difference (/2) between the lines to
+				 * the end of the arc's center-line and to the current grid.
+				 */
+				rotate = 90 - get_angle_to_grid[n1y][n1x];
+				tmp = ABS(get_angle_to_grid[n2y][n2x] + rotate) % 180;
+				diff = ABS(90 - tmp);
+
+				/* If difference is greater then that allowed, skip it,
+				 * unless it's on the target path */
+				if ((diff >= (degrees_of_arc + 6) / 4) && !on_path)
+					continue;
+			}
+
+			/* Accept remaining grids if in LOS or on the projection path */
+			if (on_path || blast_los(&map, grid)) {
+				blast_add(&blast, grid, dist_from_centre);
 			}
 		}
+
+		mem_free(map.info);
 	}
 
 	/* Calculate and store the actual damage at each distance. */
@@ -885,47 +1025,26 @@ bool project(struct source origin, int rad, struct loc finish,
 	}
 
 
-	/* Sort the blast grids by distance from the centre. */
-	for (i = 0, k = 0; i <= rad; i++) {
-		/* Collect all the grids of a given distance together. */
-		for (j = k; j < num_grids; j++) {
-			if (distance_to_grid[j] == i) {
-				struct loc tmp;
-				int tmp_d = distance_to_grid[k];
-				tmp = blast_grid[k];
-
-				blast_grid[k] = blast_grid[j];
-				distance_to_grid[k] = distance_to_grid[j];
-
-				blast_grid[j] = tmp;
-				distance_to_grid[j] = tmp_d;
-
-				/* Write to next slot */
-				k++;
-			}
-		}
-	}
-
 	/* Establish which grids are visible - no blast visuals with PROJECT_HIDE */
-	for (i = 0; i < num_grids; i++) {
-		if (panel_contains(blast_grid[i].y, blast_grid[i].x) &&
-			square_isview(cave, blast_grid[i]) &&
+	for (i = 0; i < blast.num; i++) {
+		if (panel_contains(blast.grid[i].y, blast.grid[i].x) &&
+			square_isview(cave, blast.grid[i]) &&
 			!blind && !(flg & (PROJECT_HIDE))) {
-			player_sees_grid[i] = true;
+			blast.seen[i] = true;
 		} else {
-			player_sees_grid[i] = false;
+			blast.seen[i] = false;
 		}
 	}
 
 	/* Tell the UI to display the blast */
-	event_signal_blast(EVENT_EXPLOSION, typ, num_grids, distance_to_grid,
-					   drawing, player_sees_grid, blast_grid, centre);
+	event_signal_blast(EVENT_EXPLOSION, typ, blast.num, blast.dist,
+					   drawing, blast.seen, blast.grid, centre);
 
 	/* Affect objects on every relevant grid */
 	if (flg & (PROJECT_ITEM)) {
-		for (i = 0; i < num_grids; i++) {
-			if (project_o(origin, distance_to_grid[i], blast_grid[i],
-						  dam_at_dist[distance_to_grid[i]], typ, obj)) {
+		for (i = 0; i < blast.num; i++) {
+			if (project_o(origin, blast.dist[i], blast.grid[i],
+						  dam_at_dist[blast.dist[i]], typ, obj)) {
 				notice = true;
 			}
 		}
@@ -939,21 +1058,21 @@ bool project(struct source origin, int rad, struct loc finish,
 		struct loc last_hit_grid = loc(0, 0);
 
 		/* Scan for monsters */
-		for (i = 0; i < num_grids; i++) {
+		for (i = 0; i < blast.num; i++) {
 			struct monster *mon = NULL;
 
 			/* Check this monster hasn't been processed already */
-			if (!square_isproject(cave, blast_grid[i]))
+			if (!square_isproject(cave, blast.grid[i]))
 				continue;
 
 			/* Check there is actually a monster here */
-			mon = square_monster(cave, blast_grid[i]);
+			mon = square_monster(cave, blast.grid[i]);
 			if (mon == NULL)
 				continue;
 
 			/* Affect the monster in the grid */
-			project_m(origin, distance_to_grid[i], blast_grid[i],
-			          dam_at_dist[distance_to_grid[i]], typ, flg,
+			project_m(origin, blast.dist[i], blast.grid[i],
+			          dam_at_dist[blast.dist[i]], typ, flg,
 			          &did_hit, &was_obvious);
 			if (was_obvious) {
 				notice = true;
@@ -999,12 +1118,15 @@ bool project(struct source origin, int rad, struct loc finish,
 			if (monster_is_powerful(mon))
 				power = MAX(power, 80);
 		}
-		for (i = 0; i < num_grids; i++) {
-			if (project_p(origin, distance_to_grid[i], blast_grid[i],
-						  dam_at_dist[distance_to_grid[i]], typ, power,
+		for (i = 0; i < blast.num; i++) {
+			if (project_p(origin, blast.dist[i], blast.grid[i],
+						  dam_at_dist[blast.dist[i]], typ, power,
 						  flg & PROJECT_SELF)) {
 				notice = true;
 				if (player->is_dead) {
+					PROFILE_STOP(project, blast.num);
+					blast_free(&blast);
+					mem_free(path_grid);
 					mem_free(dam_at_dist);
 					return notice;
 				}
@@ -1015,23 +1137,26 @@ bool project(struct source origin, int rad, struct loc finish,
 
 	/* Affect features in every relevant grid */
 	if (flg & (PROJECT_GRID)) {
-		for (i = 0; i < num_grids; i++) {
-			if (project_f(origin, distance_to_grid[i], blast_grid[i],
-						  dam_at_dist[distance_to_grid[i]], typ)) {
+		for (i = 0; i < blast.num; i++) {
+			if (project_f(origin, blast.dist[i], blast.grid[i],
+						  dam_at_dist[blast.dist[i]], typ)) {
 				notice = true;
 			}
 		}
 	}
 
 	/* Clear all the processing marks. */
-	for (i = 0; i < num_grids; i++) {
+	for (i = 0; i < blast.num; i++) {
 		/* Clear the mark */
-		sqinfo_off(square(cave, blast_grid[i])->info, SQUARE_PROJECT);
+		sqinfo_off(square(cave, blast.grid[i])->info, SQUARE_PROJECT);
 	}
 
 	/* Update stuff if needed */
 	if (player->upkeep->update) update_stuff(player);
 
+	PROFILE_STOP(project, blast.num);
+	blast_free(&blast);
+	mem_free(path_grid);
 	mem_free(dam_at_dist);
 
 	/* Return "something was noticed" */
@@ -23,6 +23,7 @@
 #include "mon-group.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-sched.h"
 #include "monster.h"
 #include "object.h"
 #include "obj-desc.h"
@@ -837,6 +838,9 @@ void wr_stores(void)
 			/* Save the stock size */
 			wr_byte(store->stock_num);
 
+			/* Save the maintenance still owed */
+			wr_u16b(store->days_owed);
+
 			/* Save the stock */
 			for (obj = store->stock; obj; obj = obj->next) {
 				wr_item(obj->known);
@@ -1005,6 +1009,9 @@ static void wr_monsters_aux(struct chunk *c)
 	if (player->is_dead)
 		return;
 
+	/* Bring the monsters' energy up to date */
+	mon_sched_flush(c);
+
 	/* Total monsters */
 	wr_u16b(cave_monster_max(c));
 
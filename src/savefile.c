@@ -18,6 +18,7 @@
 #include <errno.h>
 #include "angband.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "savefile.h"
 #include "save-charoutput.h"
@@ -118,7 +119,7 @@ static const struct {
 	{ "player hp", wr_player_hp, 1 },
 	{ "player spells", wr_player_spells, 1 },
 	{ "gear", wr_gear, 1 },
-	{ "stores", wr_stores, 1 },
+	{ "stores", wr_stores, 2 },
 	{ "dungeon", wr_dungeon, 1 },
 	{ "objects", wr_objects, 1 },
 	{ "monsters", wr_monsters, 1 },
@@ -146,6 +147,7 @@ static const struct blockinfo loaders[] = {
 	{ "player spells", rd_player_spells, 1 },
 	{ "gear", rd_gear, 1 },	
 	{ "stores", rd_stores, 1 },	
+	{ "stores", rd_stores_2, 2 },
 	{ "dungeon", rd_dungeon, 1 },
 	{ "objects", rd_objects, 1 },	
 	{ "monsters", rd_monsters, 1 },
@@ -388,6 +390,9 @@ bool savefile_save(const char *path)
 	char old_savefile[1024];
 	bool ok = false;
 
+	/* Levels made ahead of time aren't saved, so can't keep their artifacts */
+	level_guess_forget(player);
+
 	/* Generate a CharOutput.txt, mainly for angband.live, when saving. */
 	(void) save_charoutput();
 
@@ -97,6 +97,7 @@ int rd_player_hp(void);
 int rd_player_spells(void);
 int rd_gear(void);
 int rd_stores(void);
+int rd_stores_2(void);
 int rd_dungeon(void);
 int rd_chunks(void);
 int rd_objects(void);
@@ -53,6 +53,13 @@ static void store_maint(struct store *s);
  * ------------------------------------------------------------------------ */
 
 
+/**
+ * Number of maintenance passes which take a store from empty to its usual
+ * stock; after this many days away the old stock will almost all have been
+ * sold, so any more days make no difference
+ */
+#define STORE_SETTLE_DAYS 10
+
 /**
  * Array of stores
  */
@@ -496,12 +503,13 @@ void store_reset(void) {
 			object_pile_free(NULL, NULL, s->stock);
 			s->stock_k = NULL;
 			s->stock = NULL;
+			s->days_owed = 0;
 			if (store_is_home(s)) {
 				s = s->next;
 				continue;
 			}
 			store_shuffle(s);
-			for (j = 0; j < 10; j++)
+			for (j = 0; j < STORE_SETTLE_DAYS; j++)
 				store_maint(s);
 			s = s->next;
 		}
@@ -1632,28 +1640,66 @@ static void store_maint(struct store *s)
 	}
 }
 
+/**
+ * Throw away a store's whole stock, as if it had all been sold
+ */
+static void store_clear(struct store *s)
+{
+	while (s->stock) {
+		struct object *obj = s->stock;
+
+		if (obj->artifact) {
+			history_lose_artifact(player, obj->artifact);
+		}
+		store_delete(s, obj, obj->number);
+	}
+}
+
+/**
+ * Do the maintenance a store is owed.  A store owed STORE_SETTLE_DAYS or more
+ * would have sold nearly everything it had, so it is just stocked afresh.
+ */
+static void store_catch_up(struct store *s)
+{
+	int days = s->days_owed;
+
+	s->days_owed = 0;
+	if (days >= STORE_SETTLE_DAYS) {
+		store_clear(s);
+		days = STORE_SETTLE_DAYS;
+	}
+	while (days--) {
+		store_maint(s);
+	}
+}
+
 /**
  * Update the stores on the return to town.
+ *
+ * The days the player has been away are owed to every store, but only the
+ * stores of the town the player has come back to are maintained now; the
+ * others catch up when the player next visits them.  No store is owed more
+ * than STORE_SETTLE_DAYS, so however long the player has been away this never
+ * costs more than restocking each store of one town from nothing.
  */
 void store_update(void)
 {
-	if (OPT(player, cheat_xtra)) msg("Updating Shops...");
-	while (daycount--) {
-		int i;
-		struct store *s;
+	int i;
+	struct store *s;
 
-		/* Maintain each shop (except home) */
-		for (i = 0; i < world->num_towns; i++) {
-			struct town *town = &world->towns[i];
-			for (s = town->stores; s; s = s->next) {
-				/* Skip the home */
-				if (store_is_home(s)) continue;
+	if (OPT(player, cheat_xtra)) msg("Updating Shops...");
+	for (i = 0; i < world->num_towns; i++) {
+		struct town *town = &world->towns[i];
+		for (s = town->stores; s; s = s->next) {
+			/* Skip the home */
+			if (store_is_home(s)) continue;
 
-				/* Maintain */
-				store_maint(s);
-			}
+			s->days_owed = MIN(s->days_owed + daycount,
+				STORE_SETTLE_DAYS);
 		}
+	}
 
+	while (daycount--) {
 		/* Sometimes, shuffle the shop-keepers */
 		if (one_in_(z_info->store_shuffle)) {
 			/* Message */
@@ -1676,6 +1722,16 @@ void store_update(void)
 		}
 	}
 	daycount = 0;
+
+	/* Maintain the shops of this town */
+	for (i = 0; i < world->num_towns; i++) {
+		struct town *town = &world->towns[i];
+		if (town->index != player->place) continue;
+		for (s = town->stores; s; s = s->next) {
+			if (store_is_home(s)) continue;
+			store_catch_up(s);
+		}
+	}
 	if (OPT(player, cheat_xtra)) msg("Done.");
 }
 
@@ -2035,7 +2091,7 @@ void do_cmd_buy(struct command *cmd)
 				msg("The shopkeeper brings out some new stock.");
 
 			/* New inventory */
-			for (i = 0; i < 10; ++i)
+			for (i = 0; i < STORE_SETTLE_DAYS; ++i)
 				store_maint(store);
 		}
 	}
@@ -52,6 +52,7 @@ struct store {
 	int16_t stock_size;		/* Stock -- Total Size of Array */
 	struct object *stock;		/* Stock -- Actual stock items */
 	struct object *stock_k;		/* Stock -- Stock as known by the character */
+	uint16_t days_owed;		/* Days of maintenance not yet done */
 
 	/* Always stock these items */
 	size_t always_size;
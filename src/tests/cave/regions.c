@@ -0,0 +1,183 @@
+/* cave/regions
+ *
+ * Tests for labelling the connected regions of a level, and joining them up
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "generate.h"
+#include "init.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* A small generator, so the maps are the same on every run */
+static uint32_t seed;
+
+static int pick(int n)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 16) % n;
+}
+
+/* An arena with walls scattered over the given share of it */
+static struct chunk *rubbly_arena(int height, int width, int percent)
+{
+	struct chunk *c = t_build_arena(height, width);
+	struct loc grid;
+
+	for (grid.y = 1; grid.y < height - 1; grid.y++) {
+		for (grid.x = 1; grid.x < width - 1; grid.x++) {
+			if (pick(100) < percent) {
+				square_set_feat(c, grid, FEAT_GRANITE);
+			}
+		}
+	}
+	return c;
+}
+
+static bool open_grid(struct chunk *c, struct loc grid)
+{
+	return square_ispassable(c, grid) || square_isdoor(c, grid);
+}
+
+/* Flood fill from a grid, marking what it reaches with a number */
+static int flood(struct chunk *c, int *mark, struct loc start, int number,
+		bool diagonal)
+{
+	struct loc *stack = mem_alloc(c->height * c->width * sizeof(*stack));
+	int n = 0, count = 0;
+
+	stack[n++] = start;
+	mark[grid_to_i(start, c->width)] = number;
+	while (n) {
+		struct loc grid = stack[--n];
+		int d;
+
+		count++;
+		for (d = 0; d < (diagonal ? 8 : 4); d++) {
+			struct loc adj = loc_sum(grid, ddgrid_ddd[d]);
+
+			if (!square_in_bounds(c, adj) || !open_grid(c, adj)
+					|| mark[grid_to_i(adj, c->width)]) {
+				continue;
+			}
+			mark[grid_to_i(adj, c->width)] = number;
+			stack[n++] = adj;
+		}
+	}
+	mem_free(stack);
+	return count;
+}
+
+/* Labels match what flood fills from each unmarked grid in turn find */
+static int test_labels(void *state) {
+	int trial;
+
+	seed = 5;
+	for (trial = 0; trial < 20; trial++) {
+		struct chunk *c = rubbly_arena(22, 66, 30 + trial);
+		bool diagonal = trial % 2;
+		int *mark = mem_zalloc(c->height * c->width * sizeof(int));
+		struct region_labels *r = label_regions(c, open_grid, diagonal);
+		int number = 0;
+		struct loc grid;
+
+		for (grid.y = 0; grid.y < c->height; grid.y++) {
+			for (grid.x = 0; grid.x < c->width; grid.x++) {
+				int i = grid_to_i(grid, c->width);
+
+				if (!open_grid(c, grid)) {
+					eq(region_of(r, grid), 0);
+					continue;
+				}
+				if (!mark[i]) {
+					int size = flood(c, mark, grid, ++number,
+						diagonal);
+
+					eq(r->size[number], size);
+					eq(r->top_left[number].y, grid.y);
+				}
+				eq(region_of(r, grid), mark[i]);
+				require(grid.x >= r->top_left[mark[i]].x);
+				require(grid.x <= r->bottom_right[mark[i]].x);
+				require(grid.y >= r->top_left[mark[i]].y);
+				require(grid.y <= r->bottom_right[mark[i]].y);
+			}
+		}
+		eq(r->num, number);
+		eq(region_count(r), number);
+		mem_free(mark);
+		cave_free(c);
+	}
+	ok;
+}
+
+/* Merged regions answer as one */
+static int test_merge(void *state) {
+	struct chunk *c = t_build_arena(10, 20);
+	struct region_labels *r;
+	struct loc grid;
+
+	for (grid.y = 1; grid.y < 9; grid.y++) {
+		square_set_feat(c, loc(10, grid.y), FEAT_GRANITE);
+	}
+	r = label_regions(c, open_grid, true);
+	eq(r->num, 2);
+	eq(region_of(r, loc(3, 3)), 1);
+	eq(region_of(r, loc(15, 3)), 2);
+	eq(r->size[1], 72);
+	eq(region_first(r), 1);
+	eq(region_smallest(r), 2);
+
+	region_add_grid(r, loc(10, 5), 1);
+	region_merge(r, 2, 1);
+	eq(region_of(r, loc(15, 3)), 1);
+	eq(region_count(r), 1);
+	eq(region_first(r), 1);
+	eq(region_smallest(r), 1);
+	eq(r->size[1], 72 + 1 + 64);
+	eq(r->bottom_right[1].x, 18);
+
+	region_remove_grid(r, loc(15, 3));
+	eq(region_of(r, loc(15, 3)), 0);
+	eq(r->size[1], 136);
+	cave_free(c);
+	ok;
+}
+
+/* Afterwards every open grid can reach every other */
+static int test_connect(void *state) {
+	int trial;
+
+	seed = 9;
+	for (trial = 0; trial < 20; trial++) {
+		struct chunk *c = rubbly_arena(66, 198, 45);
+		struct region_labels *r;
+
+		ensure_connectedness(c, true);
+		r = label_regions(c, open_grid, true);
+		eq(region_count(r), 1);
+		cave_free(c);
+	}
+	ok;
+}
+
+const char *suite_name = "cave/regions";
+struct test tests[] = {
+	{ "labels", test_labels },
+	{ "merge", test_merge },
+	{ "connect", test_connect },
+	{ NULL, NULL }
+};
@@ -1,3 +1,4 @@
 TESTPROGS += \
 	cave/find \
+	cave/regions \
 	cave/scatter
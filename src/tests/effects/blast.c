@@ -0,0 +1,164 @@
+/*
+ * effects/blast
+ * Test the area affected by project().
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "game-event.h"
+#include "init.h"
+#include "player.h"
+#include "player-birth.h"
+#include "project.h"
+#include "source.h"
+
+struct blast_record {
+	int num_grids;
+	bool in_order;
+	bool distances_right;
+	bool all_marked;
+};
+
+static void record_blast(game_event_type type, game_event_data *data,
+		void *user)
+{
+	struct blast_record *rec = user;
+	int i;
+
+	rec->num_grids = data->explosion.num_grids;
+	rec->in_order = true;
+	rec->distances_right = true;
+	rec->all_marked = true;
+	for (i = 0; i < data->explosion.num_grids; i++) {
+		struct loc grid = data->explosion.blast_grid[i];
+		int dist = data->explosion.distance_to_grid[i];
+
+		if (i && dist < data->explosion.distance_to_grid[i - 1]) {
+			rec->in_order = false;
+		}
+		if (dist && dist != distance(data->explosion.centre, grid)) {
+			rec->distances_right = false;
+		}
+		if (!square_isproject(cave, grid)) {
+			rec->all_marked = false;
+		}
+	}
+}
+
+int setup_tests(void **state) {
+	struct blast_record *rec = mem_zalloc(sizeof(*rec));
+
+	set_file_paths();
+	if (!init_angband()) {
+		mem_free(rec);
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		mem_free(rec);
+		return 1;
+	}
+	event_add_handler(EVENT_EXPLOSION, record_blast, rec);
+	*state = rec;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	mem_free(state);
+	return 0;
+}
+
+/* Count the grids within a radius of a grid, up to max_x grids to its east */
+static int grids_within(int rad, int max_x)
+{
+	int y, x, n = 0;
+
+	for (y = -rad; y <= rad; y++) {
+		for (x = -rad; x <= MIN(rad, max_x); x++) {
+			if (distance(loc(0, 0), loc(x, y)) <= rad) n++;
+		}
+	}
+	return n;
+}
+
+/* Balls in the open cover their whole radius, however large */
+static int test_open(void *state) {
+	struct blast_record *rec = state;
+	struct chunk *c = t_build_arena(80, 80);
+	int rad;
+
+	cave = c;
+	for (rad = 1; rad <= 20; rad++) {
+		project(source_none(), rad, loc(40, 40), 0, PROJ_FIRE,
+			PROJECT_HIDE, 0, 0, NULL);
+		eq(rec->num_grids, grids_within(rad, rad));
+		require(rec->in_order);
+		require(rec->distances_right);
+		require(rec->all_marked);
+		require(!square_isproject(c, loc(40, 40)));
+	}
+
+	cave_free(c);
+	cave = NULL;
+	ok;
+}
+
+/* Walls stop explosions, and are only hit if next to a grid in view */
+static int test_walls(void *state) {
+	struct blast_record *rec = state;
+	struct chunk *c = t_build_arena(40, 40);
+	int y;
+
+	cave = c;
+	for (y = 1; y < 39; y++) {
+		square_set_feat(c, loc(23, y), FEAT_GRANITE);
+	}
+	project(source_none(), 5, loc(20, 20), 0, PROJ_FIRE,
+		PROJECT_HIDE | PROJECT_THRU, 0, 0, NULL);
+	require(rec->num_grids > 0);
+	require(rec->num_grids < grids_within(5, 5));
+	require(rec->in_order);
+
+	/* Nothing beyond the wall */
+	project(source_none(), 5, loc(20, 20), 0, PROJ_FIRE,
+		PROJECT_HIDE, 0, 0, NULL);
+	eq(rec->num_grids, grids_within(5, 2));
+
+	cave_free(c);
+	cave = NULL;
+	ok;
+}
+
+/* Balls next to the edge of the map only cover grids on it */
+static int test_edge(void *state) {
+	struct blast_record *rec = state;
+	struct chunk *c = t_build_arena(40, 40);
+	int y, x, n = 0;
+
+	cave = c;
+	project(source_none(), 5, loc(3, 3), 0, PROJ_FIRE,
+		PROJECT_HIDE, 0, 0, NULL);
+	for (y = -2; y <= 5; y++) {
+		for (x = -2; x <= 5; x++) {
+			if (distance(loc(0, 0), loc(x, y)) <= 5) n++;
+		}
+	}
+	eq(rec->num_grids, n);
+	require(rec->in_order);
+	require(rec->distances_right);
+	require(rec->all_marked);
+
+	cave_free(c);
+	cave = NULL;
+	ok;
+}
+
+const char *suite_name = "effects/blast";
+struct test tests[] = {
+	{ "open", test_open },
+	{ "walls", test_walls },
+	{ "edge", test_edge },
+	{ NULL, NULL }
+};
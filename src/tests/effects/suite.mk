@@ -1 +1 @@
-TESTPROGS += effects/chain effects/destruction effects/earthquake effects/info
+TESTPROGS += effects/blast effects/chain effects/destruction effects/earthquake effects/info
@@ -0,0 +1,190 @@
+/*
+ * game/record
+ * Test recording the player's commands and playing them back.
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "cmd-core.h"
+#include "cmd-record.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "obj-gear.h"
+#include "obj-pile.h"
+#include "player.h"
+#include "player-birth.h"
+#include "player-calcs.h"
+#include "savefile.h"
+
+#define RECORD_LOG "Test-record"
+#define RECORD_SAVE "Test-record.sav"
+
+static int step;
+
+/* What the game ended up as after recording */
+static int32_t end_turn;
+static struct loc end_grid;
+static int end_gear;
+static uint32_t end_value, end_i, end_state[RAND_DEG];
+
+static void reset_before_load(void) {
+	play_again = true;
+	wipe_mon_list(cave, player);
+	cleanup_angband();
+	chunk_list_max = 0;
+	init_angband();
+	play_again = false;
+}
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+#ifdef UNIX
+	/* Necessary for creating the randart file. */
+	create_needed_dirs();
+#endif
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	prepare_next_level(player);
+	on_new_level();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cmd_record_stop();
+	file_delete(RECORD_LOG);
+	file_delete(RECORD_SAVE);
+	wipe_mon_list(cave, player);
+	cleanup_angband();
+	return 0;
+}
+
+/* The first direction to walk in from the player's grid, or 0 */
+static int open_direction(void)
+{
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		struct loc grid = loc_sum(player->grid, ddgrid_ddd[i]);
+
+		if (square_isempty(cave, grid)) return ddd[i];
+	}
+	return 0;
+}
+
+/* The first thing carried and not worn */
+static struct object *carried(void)
+{
+	struct object *obj;
+
+	for (obj = player->gear; obj; obj = obj->next) {
+		if (!object_is_equipped(player->body, obj)) return obj;
+	}
+	return NULL;
+}
+
+/* Give the player's commands, one each time the game asks for one */
+static errr scripted_command(cmd_context c)
+{
+	struct command cmd = { .context = CTX_INIT, .code = CMD_NULL };
+
+	switch (step++) {
+		case 0:
+		case 4:
+			cmd.code = CMD_WALK;
+			cmd_set_arg_direction(&cmd, "direction", open_direction());
+			break;
+		case 1:
+			cmd.code = CMD_DROP;
+			cmd_set_arg_item(&cmd, "item", carried());
+			cmd_set_arg_number(&cmd, "quantity", 1);
+			break;
+		case 2:
+			cmd.code = CMD_PICKUP;
+			cmd_set_arg_item(&cmd, "item",
+				square_object(cave, player->grid));
+			break;
+		case 3:
+			cmd.code = CMD_REST;
+			cmd_set_arg_choice(&cmd, "choice", 30);
+			break;
+		default:
+			cmd.code = CMD_HOLD;
+			break;
+	}
+	return cmdq_push_copy(&cmd);
+}
+
+static int count_gear(void)
+{
+	struct object *obj;
+	int n = 0;
+
+	for (obj = player->gear; obj; obj = obj->next) n++;
+	return n;
+}
+
+/* Play, recording what the player does */
+static int test_record(void *state) {
+	require(open_direction() != 0);
+	require(carried() != NULL);
+	require(cmd_record_start(RECORD_LOG));
+	require(cmd_recording());
+	cmd_get_hook = scripted_command;
+	for (step = 0; step < 8; ) {
+		cmd_get_player_command(CTX_GAME);
+		run_game_loop();
+		require(!player->is_dead);
+	}
+	cmd_record_stop();
+	require(!cmd_recording());
+
+	end_turn = turn;
+	end_grid = player->grid;
+	end_gear = count_gear();
+	end_value = Rand_value;
+	end_i = state_i;
+	memcpy(end_state, STATE, sizeof(STATE));
+	require(file_exists(RECORD_SAVE));
+	ok;
+}
+
+/* Playing back from the save ends up where recording did */
+static int test_replay(void *state) {
+	struct cmd_replay *replay = cmd_replay_load(RECORD_LOG);
+
+	notnull(replay);
+	eq(cmd_replay_count(replay), 8);
+	reset_before_load();
+	eq(savefile_load(cmd_replay_savefile(replay), false), true);
+	require(character_dungeon);
+	on_new_level();
+	cmd_replay_start(replay);
+	while (cmd_replay_next(replay)) {
+		run_game_loop();
+	}
+	eq(cmd_replay_diverged(replay), 0);
+	cmd_replay_free(replay);
+
+	eq(turn, end_turn);
+	require(loc_eq(player->grid, end_grid));
+	eq(count_gear(), end_gear);
+	require(Rand_value == end_value);
+	require(state_i == end_i);
+	require(!memcmp(STATE, end_state, sizeof(STATE)));
+	ok;
+}
+
+const char *suite_name = "game/record";
+struct test tests[] = {
+	{ "record", test_record },
+	{ "replay", test_replay },
+	{ NULL, NULL }
+};
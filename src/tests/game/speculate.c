@@ -0,0 +1,235 @@
+/*
+ * game/speculate
+ * Test making the level beyond the stairs ahead of time.
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-event.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "obj-util.h"
+#include "player-calcs.h"
+#include "player.h"
+#include "player-birth.h"
+#include "player-util.h"
+#include "target.h"
+
+static int levels_started, levels_ended;
+
+static void count_start(game_event_type type, game_event_data *data,
+		void *user)
+{
+	levels_started++;
+}
+
+static void count_end(game_event_type type, game_event_data *data,
+		void *user)
+{
+	levels_ended++;
+}
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+#ifdef UNIX
+	/* Necessary for creating the randart file. */
+	create_needed_dirs();
+#endif
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	prepare_next_level(player);
+	on_new_level();
+	event_add_handler(EVENT_GEN_LEVEL_START, count_start, NULL);
+	event_add_handler(EVENT_GEN_LEVEL_END, count_end, NULL);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	wipe_mon_list(cave, player);
+	cleanup_angband();
+	return 0;
+}
+
+/* Take the stairs the player is on, and wait for the next command */
+static void take_stairs(void)
+{
+	if (square_isdownstairs(cave, player->grid)) {
+		cmdq_push(CMD_GO_DOWN);
+	} else {
+		cmdq_push(CMD_GO_UP);
+	}
+	run_game_loop();
+}
+
+/*
+ * Move the player to stairs or a path leading away from towns, so the way
+ * back from the far end doesn't lead to a town either
+ */
+static bool go_to_way_on(void)
+{
+	struct loc grid;
+
+	for (grid.y = 0; grid.y < cave->height; grid.y++) {
+		for (grid.x = 0; grid.x < cave->width; grid.x++) {
+			int feat = square(cave, grid)->feat, place;
+
+			if (!square_isstairs(cave, grid) && !square_ispath(cave, grid)) {
+				continue;
+			}
+			if (square_monster(cave, grid)) continue;
+			place = player_stairs_place(player, feat);
+			if (place < 0 || !world->levels[place].depth
+					|| world->levels[place].locality == LOC_UNDERWORLD
+					|| world->levels[place].locality == LOC_MOUNTAIN_TOP) {
+				continue;
+			}
+			player_place(cave, player, grid);
+			return true;
+		}
+	}
+	return false;
+}
+
+/* The uniques and artifacts which exist anywhere */
+static int count_existing(void)
+{
+	int i, n = 0;
+
+	for (i = 0; i < z_info->r_max; i++) {
+		n += r_info[i].cur_num;
+	}
+	for (i = 0; i < z_info->a_max; i++) {
+		if (is_artifact_created(&a_info[i])) n++;
+	}
+	return n;
+}
+
+/* Waiting on the stairs makes the next level, which is then used */
+static int test_take(void *state) {
+	require(go_to_way_on());
+	take_stairs();
+	require(go_to_way_on());
+	player->opts.opt[OPT_speculate_levels] = true;
+	take_stairs();
+	require(square_isstairs(cave, player->grid)
+		|| square_ispath(cave, player->grid));
+
+	/* The level beyond was made while waiting, so isn't made again */
+	player->opts.opt[OPT_speculate_levels] = false;
+	levels_started = 0;
+	levels_ended = 0;
+	take_stairs();
+	eq(levels_started, 0);
+	eq(levels_ended, 1);
+	require(character_dungeon);
+	require(player->depth > 0);
+	eq(square(cave, player->grid)->mon, -1);
+	ok;
+}
+
+/* Making the level disturbs nothing, and forgetting it puts all back */
+static int test_forget(void *state) {
+	uint32_t state_before[RAND_DEG];
+	uint32_t value = Rand_value, i = state_i;
+	struct loc grid = player->grid;
+	struct chunk *c = cave, *known = player->cave;
+	int place = player->place, depth = player->depth;
+	int existing = count_existing();
+	struct monster *mon = NULL;
+	struct monster_race ghost_race;
+	struct loc target_grid;
+	int m;
+
+	/* Aim at and track a monster on the current level */
+	for (m = 1; m < cave_monster_max(cave) && !mon; m++) {
+		if (cave_monster(cave, m)->race) mon = cave_monster(cave, m);
+	}
+	notnull(mon);
+	target_set_location(mon->grid.y, mon->grid.x);
+	health_track(player->upkeep, mon);
+	ghost_race = r_info[z_info->r_max - 1];
+
+	memcpy(state_before, STATE, sizeof(STATE));
+	player->opts.opt[OPT_speculate_levels] = true;
+	levels_started = 0;
+	levels_ended = 0;
+	level_speculate(player);
+	require(levels_started > 0);
+	eq(levels_ended, 0);
+	require(Rand_value == value);
+	require(state_i == i);
+	require(!memcmp(STATE, state_before, sizeof(STATE)));
+	require(loc_eq(player->grid, grid));
+	ptreq(cave, c);
+	ptreq(player->cave, known);
+	eq(player->place, place);
+	eq(player->depth, depth);
+	require(character_dungeon);
+
+	/* Waiting again makes nothing more */
+	levels_started = 0;
+	level_speculate(player);
+	eq(levels_started, 0);
+
+	level_guess_forget(player);
+	eq(count_existing(), existing);
+
+	/* The target, tracking and ghost of the current level are untouched */
+	require(target_is_set());
+	target_get(&target_grid);
+	require(loc_eq(target_grid, mon->grid));
+	ptreq(player->upkeep->health_who, mon);
+	require(!memcmp(&r_info[z_info->r_max - 1], &ghost_race,
+		sizeof(ghost_race)));
+	player->opts.opt[OPT_speculate_levels] = false;
+	ok;
+}
+
+/* Moving off the stairs throws the level away */
+static int test_elsewhere(void *state) {
+	int existing = count_existing();
+	struct loc grid;
+
+	require(go_to_way_on());
+	player->opts.opt[OPT_speculate_levels] = true;
+	levels_started = 0;
+	level_speculate(player);
+	require(levels_started > 0);
+
+	for (grid.y = 1; grid.y < cave->height - 1; grid.y++) {
+		for (grid.x = 1; grid.x < cave->width - 1; grid.x++) {
+			if (square_isempty(cave, grid)
+					&& !square_isstairs(cave, grid)
+					&& !square_ispath(cave, grid)) break;
+		}
+		if (grid.x < cave->width - 1) break;
+	}
+	require(grid.y < cave->height - 1);
+	player_place(cave, player, grid);
+	levels_started = 0;
+	level_speculate(player);
+	eq(levels_started, 0);
+	eq(count_existing(), existing);
+
+	/* Leave a level made ahead for cleaning up to throw away */
+	require(go_to_way_on());
+	level_speculate(player);
+	ok;
+}
+
+const char *suite_name = "game/speculate";
+struct test tests[] = {
+	{ "take", test_take },
+	{ "forget", test_forget },
+	{ "elsewhere", test_elsewhere },
+	{ NULL, NULL }
+};
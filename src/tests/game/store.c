@@ -0,0 +1,125 @@
+/* game/store
+ *
+ * Tests for bringing stores up to date on the return to town
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "game-world.h"
+#include "init.h"
+#include "player.h"
+#include "player-birth.h"
+#include "store.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	store_reset();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Whether every store of a town, other than the home, is owed days */
+static bool town_owed(struct town *town, int days)
+{
+	struct store *s;
+
+	for (s = town->stores; s; s = s->next) {
+		if (store_is_home(s)) continue;
+		if (s->days_owed != days) return false;
+	}
+	return true;
+}
+
+/* Whether every store of a town, other than the home, has a usual stock */
+static bool town_stocked(struct town *town)
+{
+	struct store *s;
+
+	for (s = town->stores; s; s = s->next) {
+		int max = s->normal_stock_max + (int) s->always_num;
+
+		if (store_is_home(s) || !s->turnover) continue;
+		if (s->stock_num < (int) s->always_num) return false;
+		if (s->stock_num > max) return false;
+	}
+	return true;
+}
+
+/* Only the town the player is in is maintained */
+static int test_lazy(void *state) {
+	struct town *here, *there;
+
+	require(world->num_towns > 1);
+	here = &world->towns[0];
+	there = &world->towns[1];
+	player->place = here->index;
+	daycount = 3;
+	store_update();
+	eq(daycount, 0);
+	require(town_owed(here, 0));
+	require(town_owed(there, 3));
+
+	/* Days away add up, but no further than a full turnover */
+	daycount = 2;
+	store_update();
+	require(town_owed(there, 5));
+	daycount = 5000;
+	store_update();
+	require(town_owed(there, 10));
+	require(town_stocked(here));
+
+	/* Going to the other town brings it up to date */
+	player->place = there->index;
+	store_update();
+	require(town_owed(there, 0));
+	require(town_stocked(there));
+	ok;
+}
+
+/* Homes are never restocked, however long the player is away */
+static int test_home(void *state) {
+	int homes[16], i, n = 0, trial;
+	struct store *s;
+
+	for (i = 0; i < world->num_towns; i++) {
+		for (s = world->towns[i].stores; s; s = s->next) {
+			if (store_is_home(s) && n < (int) N_ELEMENTS(homes)) {
+				homes[n++] = s->stock_num;
+			}
+		}
+	}
+	for (trial = 0; trial < 2 * world->num_towns; trial++) {
+		player->place = world->towns[trial % world->num_towns].index;
+		daycount = 1000;
+		store_update();
+	}
+	n = 0;
+	for (i = 0; i < world->num_towns; i++) {
+		for (s = world->towns[i].stores; s; s = s->next) {
+			if (store_is_home(s) && n < (int) N_ELEMENTS(homes)) {
+				eq(s->days_owed, 0);
+				eq(s->stock_num, homes[n++]);
+			}
+		}
+	}
+	require(n > 0);
+	ok;
+}
+
+const char *suite_name = "game/store";
+struct test tests[] = {
+	{ "lazy", test_lazy },
+	{ "home", test_home },
+	{ NULL, NULL }
+};
@@ -1,2 +1,5 @@
 TESTPROGS += game/basic \
-	game/mage
+	game/mage \
+	game/record \
+	game/speculate \
+	game/store
@@ -298,6 +298,47 @@ static int test_many_repeat(void *state)
 	ok;
 }
 
+static int test_long_text(void *state)
+{
+	char buf[1000];
+	const char *txt;
+	uint16_t n, j;
+	int i;
+
+	messages_free();
+	messages_init();
+
+	/*
+	 * Add long messages until there's no room for their text.  The oldest
+	 * should be forgotten, and the rest should be intact.
+	 */
+	for (i = 0; i < 1000; ++i) {
+		memset(buf, 'a' + i % 26, sizeof(buf) - 1);
+		buf[sizeof(buf) - 1] = '\0';
+		message_add(buf, MSG_GENERIC);
+		n = messages_num();
+		require(n > 0);
+		if (n < i + 1) {
+			break;
+		}
+	}
+	require(i < 1000);
+	for (; i < 1000; ++i) {
+		memset(buf, 'a' + i % 26, sizeof(buf) - 1);
+		buf[sizeof(buf) - 1] = '\0';
+		message_add(buf, MSG_GENERIC);
+		n = messages_num();
+		for (j = 0; j < n; ++j) {
+			txt = message_str(j);
+			eq(strlen(txt), sizeof(buf) - 1);
+			eq(txt[0], 'a' + (i - j) % 26);
+			eq(txt[sizeof(buf) - 2], 'a' + (i - j) % 26);
+		}
+	}
+
+	ok;
+}
+
 static int test_color(void *state) {
 	uint8_t color;
 
@@ -663,6 +704,7 @@ struct test tests[] = {
 	{ "add", test_add },
 	{ "fill", test_fill },
 	{ "many_repeat", test_many_repeat },
+	{ "long_text", test_long_text },
 	{ "color", test_color },
 	{ "format", test_msg },
 	{ "sound", test_sound },
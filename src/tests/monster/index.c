@@ -0,0 +1,134 @@
+/* monster/index
+ *
+ * Tests for mon-index.c
+ */
+
+#include "mon-index.h"
+#include "mon-make.h"
+#include "mon-util.h"
+#include "player-birth.h"
+#include "test-utils.h"
+#include "unit-test.h"
+#include "unit-test-data.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Check whether a monster is in a gathered list */
+static bool gathered(struct chunk *c, struct loc grid, int radius, bool seen,
+		const struct monster *mon) {
+	const int16_t *list;
+	int n = mon_index_gather(c, grid, radius, seen, &list);
+
+	while (n--) {
+		if (list[n] == mon->midx) return true;
+	}
+	return false;
+}
+
+/* Monsters are found near where they stand, and follow moves and deaths */
+static int test_gather(void *state) {
+	struct chunk *c = t_build_arena(40, 80);
+	struct monster *near, *far;
+	const int16_t *list;
+	int idx;
+
+	player_make_simple(NULL, NULL, "Tester");
+	cave = c;
+	near = t_add_monster(c, loc(10, 10), "wolf");
+	far = t_add_monster(c, loc(70, 30), "wolf");
+
+	eq(mon_index_gather(c, loc(12, 12), 5, false, &list), 1);
+	eq(list[0], near->midx);
+	require(!gathered(c, loc(12, 12), 5, false, far));
+	require(gathered(c, loc(60, 30), 10, false, far));
+	require(!gathered(c, loc(60, 30), 9, false, far));
+
+	/* Moving is noticed, even across buckets */
+	monster_swap(near->grid, loc(50, 20));
+	require(!gathered(c, loc(12, 12), 5, false, near));
+	require(gathered(c, loc(50, 20), 0, false, near));
+
+	/* Seen monsters are found wherever they are */
+	mflag_on(far->mflag, MFLAG_VISIBLE);
+	mon_index_note_seen(c, far);
+	require(gathered(c, loc(1, 1), 0, true, far));
+	require(!gathered(c, loc(1, 1), 0, false, far));
+	mflag_off(far->mflag, MFLAG_VISIBLE);
+	mon_index_note_seen(c, far);
+	require(!gathered(c, loc(1, 1), 0, true, far));
+
+	/* Deleted monsters are gone */
+	idx = near->midx;
+	delete_monster_idx(c, idx);
+	eq(mon_index_gather(c, loc(50, 20), 5, false, &list), 0);
+
+	wipe_mon_list(c, player);
+	null(c->mon_index);
+	cave_free(c);
+	cave = NULL;
+	ok;
+}
+
+/* Region queries find what's in the region, in order of index */
+static int test_regions(void *state) {
+	struct chunk *c = t_build_arena(40, 80);
+	struct monster *a, *b, *d;
+	int16_t *list;
+	int n;
+
+	cave = c;
+	a = t_add_monster(c, loc(40, 20), "wolf");
+	b = t_add_monster(c, loc(20, 10), "wolf");
+	d = t_add_monster(c, loc(44, 23), "wolf");
+
+	n = mon_index_in_rect(c, loc(45, 25), loc(18, 8), &list);
+	eq(n, 3);
+	eq(list[0], a->midx);
+	eq(list[1], b->midx);
+	eq(list[2], d->midx);
+	mem_free(list);
+
+	n = mon_index_in_rect(c, loc(41, 5), loc(79, 22), &list);
+	eq(n, 0);
+	mem_free(list);
+
+	/* distance((40, 20), (44, 23)) is 5 */
+	n = mon_index_in_radius(c, loc(40, 20), 5, &list);
+	eq(n, 2);
+	eq(list[0], a->midx);
+	eq(list[1], d->midx);
+	mem_free(list);
+	n = mon_index_in_radius(c, loc(40, 20), 4, &list);
+	eq(n, 1);
+	mem_free(list);
+
+	/* Only grids marked as in view count */
+	player->grid = loc(42, 21);
+	sqinfo_on(square(c, d->grid)->info, SQUARE_VIEW);
+	n = mon_index_in_view(c, player, &list);
+	eq(n, 1);
+	eq(list[0], d->midx);
+	mem_free(list);
+
+	wipe_mon_list(c, player);
+	cave_free(c);
+	cave = NULL;
+	ok;
+}
+
+const char *suite_name = "monster/index";
+struct test tests[] = {
+	{ "gather", test_gather },
+	{ "regions", test_regions },
+	{ NULL, NULL }
+};
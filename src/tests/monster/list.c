@@ -0,0 +1,162 @@
+/* monster/list
+ *
+ * Tests for collecting the monster list from the monsters the player knows
+ */
+
+#include "mon-index.h"
+#include "mon-list.h"
+#include "mon-make.h"
+#include "init.h"
+#include "mon-util.h"
+#include "player-birth.h"
+#include "test-utils.h"
+#include "unit-test.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Make a monster seen or unseen, as update_mon() would */
+static void set_seen(struct chunk *c, struct monster *mon, bool seen)
+{
+	if (seen) {
+		mflag_on(mon->mflag, MFLAG_VISIBLE);
+	} else {
+		mflag_off(mon->mflag, MFLAG_VISIBLE);
+	}
+	mon_index_note_seen(c, mon);
+}
+
+static const monster_list_entry_t *find_entry(const monster_list_t *list,
+		const char *race)
+{
+	int i;
+
+	for (i = 0; i < list->distinct_entries; i++) {
+		if (streq(list->entries[i].race->name, race)) {
+			return &list->entries[i];
+		}
+	}
+	return NULL;
+}
+
+/* Seen monsters are counted by race, in view or not */
+static int test_collect(void *state) {
+	struct chunk *c = t_build_arena(40, 80);
+	struct monster *w1, *w2, *w3, *w4, *k;
+	const monster_list_entry_t *entry;
+	monster_list_t *list;
+
+	cave = c;
+	player->grid = loc(10, 10);
+	w1 = t_add_monster(c, loc(12, 10), "wolf");
+	w2 = t_add_monster(c, loc(14, 12), "wolf");
+	w3 = t_add_monster(c, loc(60, 30), "wolf");
+	w4 = t_add_monster(c, loc(62, 30), "wolf");
+	k = t_add_monster(c, loc(70, 5), "cave spider");
+	sqinfo_on(square(c, w1->grid)->info, SQUARE_VIEW);
+	sqinfo_on(square(c, w2->grid)->info, SQUARE_VIEW);
+	set_seen(c, w1, true);
+	set_seen(c, w2, true);
+	set_seen(c, w3, true);
+	set_seen(c, k, true);
+
+	list = monster_list_new();
+	monster_list_collect(list);
+	eq(list->distinct_entries, 2);
+	eq(list->total_monsters[MONSTER_LIST_SECTION_LOS], 2);
+	eq(list->total_monsters[MONSTER_LIST_SECTION_ESP], 2);
+	entry = find_entry(list, "wolf");
+	notnull(entry);
+	ptreq(list->entries[0].race, w1->race);
+	eq(entry->count[MONSTER_LIST_SECTION_LOS], 2);
+	eq(entry->count[MONSTER_LIST_SECTION_ESP], 1);
+	eq(entry->dx[MONSTER_LIST_SECTION_ESP], 50);
+	eq(entry->dy[MONSTER_LIST_SECTION_ESP], 20);
+	entry = find_entry(list, "cave spider");
+	notnull(entry);
+	eq(entry->count[MONSTER_LIST_SECTION_ESP], 1);
+
+	/* Changes of visibility and deaths show on the next collection */
+	set_seen(c, w4, true);
+	set_seen(c, w1, false);
+	delete_monster_idx(c, k->midx);
+	monster_list_reset(list);
+	monster_list_collect(list);
+	eq(list->distinct_entries, 1);
+	entry = find_entry(list, "wolf");
+	notnull(entry);
+	eq(entry->count[MONSTER_LIST_SECTION_LOS], 1);
+	eq(entry->count[MONSTER_LIST_SECTION_ESP], 2);
+	null(find_entry(list, "cave spider"));
+
+	/* Camouflaged monsters aren't listed */
+	mflag_on(w2->mflag, MFLAG_CAMOUFLAGE);
+	monster_list_reset(list);
+	monster_list_collect(list);
+	eq(list->total_monsters[MONSTER_LIST_SECTION_LOS], 0);
+
+	monster_list_free(list);
+	wipe_mon_list(c, player);
+	cave_free(c);
+	cave = NULL;
+	ok;
+}
+
+/* On a crowded level only the few that are seen are listed */
+static int test_crowd(void *state) {
+	struct chunk *c = t_build_arena(66, 198);
+	monster_list_t *list;
+	struct loc grid;
+	int n = 0, seen = 0;
+
+	cave = c;
+	player->grid = loc(5, 5);
+	for (grid.y = 2; grid.y < 64; grid.y += 3) {
+		for (grid.x = 2; grid.x < 196; grid.x += 6) {
+			struct monster *mon = t_add_monster(c, grid,
+				(n % 3) ? "wolf" : "cave spider");
+
+			if (n++ % 40 == 0) {
+				set_seen(c, mon, true);
+				seen++;
+			}
+		}
+	}
+	list = monster_list_new();
+	monster_list_collect(list);
+	eq(list->distinct_entries, 2);
+	eq(list->total_monsters[MONSTER_LIST_SECTION_LOS], 0);
+	eq(list->total_monsters[MONSTER_LIST_SECTION_ESP], seen);
+
+	/* Collecting again finds the same */
+	monster_list_reset(list);
+	monster_list_collect(list);
+	eq(list->distinct_entries, 2);
+	eq(list->total_monsters[MONSTER_LIST_SECTION_ESP], seen);
+	monster_list_free(list);
+	wipe_mon_list(c, player);
+	cave_free(c);
+	cave = NULL;
+	ok;
+}
+
+const char *suite_name = "monster/list";
+struct test tests[] = {
+	{ "collect", test_collect },
+	{ "crowd", test_crowd },
+	{ NULL, NULL }
+};
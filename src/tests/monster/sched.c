@@ -0,0 +1,310 @@
+/* monster/sched
+ *
+ * Tests for mon-sched.c
+ */
+
+#include "game-world.h"
+#include "mon-make.h"
+#include "mon-move.h"
+#include "mon-sched.h"
+#include "mon-util.h"
+#include "player-birth.h"
+#include "test-utils.h"
+#include "unit-test.h"
+#include "unit-test-data.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+#define NUM_MON 4
+
+/*
+ * Run the scheduler over a few turns, handling monsters the way
+ * process_monsters() does, and check it against the plain full scan.
+ */
+static int test_matches_full_scan(void *state) {
+	struct chunk *c = t_build_arena(20, 20);
+	struct monster *mon[NUM_MON];
+	int energy[NUM_MON], speed[NUM_MON] = { 100, 110, 120, 130 };
+	int i, t;
+
+	player_make_simple(NULL, NULL, "Tester");
+	for (i = 0; i < NUM_MON; i++) {
+		mon[i] = t_add_monster(c, loc(2 + 3 * i, 5), "wolf");
+		mon[i]->mspeed = speed[i];
+		mon[i]->energy = 10 * i;
+		energy[i] = mon[i]->energy;
+	}
+	mon_sched_build(c);
+
+	for (t = 0; t < 50; t++) {
+		int last = cave_monster_max(c);
+
+		/* The full scan: everyone gains energy, movers use some up */
+		for (i = NUM_MON - 1; i >= 0; i--) {
+			bool moving = energy[i] >= z_info->move_energy;
+			energy[i] += turn_energy(speed[i]);
+			if (moving) energy[i] -= z_info->move_energy;
+		}
+
+		/* The scheduler only hands over movers, highest index first */
+		mon_sched_begin_pass(c, 0, false);
+		for (i = mon_sched_next(c, cave_monster_max(c) - 1); i;
+			 i = mon_sched_next(c, i - 1)) {
+			struct monster *m = cave_monster(c, i);
+
+			require(i < last);
+			last = i;
+			require(m->energy >= z_info->move_energy);
+			mflag_on(m->mflag, MFLAG_HANDLED);
+			m->energy += monster_energy_gain(m) - z_info->move_energy;
+			mon_sched_done(c, m);
+		}
+		mon_sched_end_pass(c, 0);
+		mon_sched_new_turn(c);
+
+		for (i = 0; i < NUM_MON; i++) {
+			mon_sched_sync(c, mon[i]);
+			eq(mon[i]->energy, energy[i]);
+		}
+	}
+
+	/* Flushing leaves the energy where it was */
+	mon_sched_flush(c);
+	null(c->sched);
+	for (i = 0; i < NUM_MON; i++) {
+		eq(mon[i]->energy, energy[i]);
+		require(!mflag_has(mon[i]->mflag, MFLAG_HANDLED));
+	}
+
+	wipe_mon_list(c, player);
+	cave_free(c);
+	ok;
+}
+
+/* Changing speed part way through takes effect from the current turn */
+static int test_speed_change(void *state) {
+	struct chunk *c = t_build_arena(20, 20);
+	struct monster *m;
+	int t;
+
+	player_make_simple(NULL, NULL, "Tester");
+	m = t_add_monster(c, loc(5, 5), "wolf");
+	m->mspeed = 110;
+	m->energy = 0;
+	mon_sched_build(c);
+
+	/* Three quiet turns at normal speed */
+	for (t = 0; t < 3; t++) {
+		mon_sched_begin_pass(c, 0, false);
+		eq(mon_sched_next(c, cave_monster_max(c) - 1), 0);
+		mon_sched_end_pass(c, 0);
+		mon_sched_new_turn(c);
+	}
+
+	/* Double the speed */
+	mon_sched_sync(c, m);
+	eq(m->energy, 3 * turn_energy(110));
+	m->mspeed = 120;
+	mon_sched_update(c, m);
+
+	/* Four more turns brings it to the move threshold */
+	for (t = 0; t < 4; t++) {
+		mon_sched_begin_pass(c, 0, false);
+		eq(mon_sched_next(c, cave_monster_max(c) - 1), 0);
+		mon_sched_end_pass(c, 0);
+		mon_sched_new_turn(c);
+	}
+	mon_sched_begin_pass(c, 0, false);
+	eq(mon_sched_next(c, cave_monster_max(c) - 1), m->midx);
+	eq(m->energy, 3 * turn_energy(110) + 4 * turn_energy(120));
+	mon_sched_end_pass(c, 0);
+
+	mon_sched_free(c);
+	wipe_mon_list(c, player);
+	cave_free(c);
+	ok;
+}
+
+/*
+ * Run a pass of the scheduler with a minimum energy, letting each monster
+ * handed over move
+ */
+static void run_pass(struct chunk *c, int minimum) {
+	int i;
+
+	mon_sched_begin_pass(c, minimum, false);
+	for (i = mon_sched_next(c, cave_monster_max(c) - 1); i;
+		 i = mon_sched_next(c, i - 1)) {
+		struct monster *m = cave_monster(c, i);
+
+		mflag_on(m->mflag, MFLAG_HANDLED);
+		m->energy += monster_energy_gain(m) - z_info->move_energy;
+		mon_sched_done(c, m);
+	}
+	mon_sched_end_pass(c, 0);
+}
+
+/*
+ * Changes to speed and energy between the passes of a turn, as when the
+ * player hastes, slows or drains a monster, leave the same energy as the
+ * old loop over every monster
+ */
+static int test_mid_turn(void *state) {
+	struct chunk *c = t_build_arena(20, 20);
+	struct monster *mon[NUM_MON];
+	int energy[NUM_MON], speed[NUM_MON] = { 100, 110, 120, 130 };
+	int mins[2] = { 51, 0 };
+	int i, t, p;
+
+	player_make_simple(NULL, NULL, "Tester");
+	for (i = 0; i < NUM_MON; i++) {
+		mon[i] = t_add_monster(c, loc(2 + 3 * i, 5), "wolf");
+		mon[i]->mspeed = speed[i];
+		mon[i]->energy = 30 * i;
+		energy[i] = mon[i]->energy;
+	}
+	mon_sched_build(c);
+
+	for (t = 0; t < 60; t++) {
+		bool handled[NUM_MON] = { false, false, false, false };
+		int k = t % NUM_MON;
+
+		for (p = 0; p < 2; p++) {
+			/* The old loop */
+			for (i = NUM_MON - 1; i >= 0; i--) {
+				bool moving = energy[i] >= z_info->move_energy;
+
+				if (handled[i] || energy[i] < mins[p]) continue;
+				handled[i] = true;
+				energy[i] += turn_energy(speed[i]);
+				if (moving) energy[i] -= z_info->move_energy;
+			}
+			run_pass(c, mins[p]);
+
+			/* The player's turn comes between the passes */
+			if (p) continue;
+			mon_sched_sync(c, mon[k]);
+			eq(mon[k]->energy, energy[k]);
+			if (t % 3 == 2) {
+				energy[k] /= 2;
+				mon[k]->energy = energy[k];
+			} else {
+				speed[k] += (t % 3) ? -20 : 20;
+				mon[k]->mspeed = speed[k];
+			}
+			mon_sched_update(c, mon[k]);
+		}
+		mon_sched_new_turn(c);
+
+		for (i = 0; i < NUM_MON; i++) {
+			mon_sched_sync(c, mon[i]);
+			eq(mon[i]->energy, energy[i]);
+		}
+	}
+
+	mon_sched_free(c);
+	wipe_mon_list(c, player);
+	cave_free(c);
+	ok;
+}
+
+/*
+ * Run one full pass of the scheduler, letting each monster handed over move,
+ * and return how many there were
+ */
+static int run_turn(struct chunk *c) {
+	int i, n = 0;
+
+	mon_sched_begin_pass(c, 0, false);
+	for (i = mon_sched_next(c, cave_monster_max(c) - 1); i;
+		 i = mon_sched_next(c, i - 1)) {
+		struct monster *m = cave_monster(c, i);
+
+		mflag_on(m->mflag, MFLAG_HANDLED);
+		m->energy += monster_energy_gain(m) - z_info->move_energy;
+		mon_sched_done(c, m);
+		n++;
+	}
+	mon_sched_end_pass(c, 0);
+	mon_sched_new_turn(c);
+	return n;
+}
+
+/* A sleeping monster far from the player is left alone until woken */
+static int test_dormant(void *state) {
+	struct chunk *c = t_build_arena(10, 80);
+	struct monster *m;
+	int energy, handled = 0, moves, t;
+
+	player_make_simple(NULL, NULL, "Tester");
+	cave = c;
+	player->grid = loc(1, 5);
+	m = t_add_monster(c, loc(75, 5), "wolf");
+	m->mspeed = 110;
+	m->energy = 90;
+	m->target.midx = -1;
+	m->m_timed[MON_TMD_SLEEP] = 100;
+	energy = m->energy;
+	mon_sched_build(c);
+
+	/* It moves once, then sleeps through everything */
+	for (t = 0; t < 60; t++) {
+		bool moving = energy >= z_info->move_energy;
+		energy += turn_energy(110);
+		if (moving) energy -= z_info->move_energy;
+		handled += run_turn(c);
+	}
+	eq(handled, 1);
+
+	/* Waking it works out the energy it would have had */
+	mon_sched_sync(c, m);
+	eq(m->energy, energy);
+
+	/* Let it drop off again, then walk up to it */
+	for (handled = 0; !handled; ) {
+		bool moving = energy >= z_info->move_energy;
+		energy += turn_energy(110);
+		if (moving) energy -= z_info->move_energy;
+		handled = run_turn(c);
+	}
+	player->grid = loc(60, 5);
+	mon_sched_player_moved(c);
+	for (t = 0, handled = 0, moves = 0; t < 30; t++) {
+		bool moving = energy >= z_info->move_energy;
+		energy += turn_energy(110);
+		if (moving) {
+			energy -= z_info->move_energy;
+			moves++;
+		}
+		handled += run_turn(c);
+	}
+	require(moves > 0);
+	eq(handled, moves);
+	mon_sched_sync(c, m);
+	eq(m->energy, energy);
+
+	mon_sched_free(c);
+	wipe_mon_list(c, player);
+	cave_free(c);
+	cave = NULL;
+	ok;
+}
+
+const char *suite_name = "monster/sched";
+struct test tests[] = {
+	{ "matches_full_scan", test_matches_full_scan },
+	{ "speed_change", test_speed_change },
+	{ "mid_turn", test_mid_turn },
+	{ "dormant", test_dormant },
+	{ NULL, NULL }
+};
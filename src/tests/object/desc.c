@@ -0,0 +1,122 @@
+/* object/desc */
+/* Check kept object descriptions change when the object or what is known
+ * of it does. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "init.h"
+#include "player.h"
+#include "obj-desc.h"
+#include "obj-knowledge.h"
+#include "obj-make.h"
+#include "obj-pile.h"
+#include "obj-tval.h"
+#include "obj-util.h"
+#include "player-birth.h"
+#include "z-quark.h"
+
+static struct object *potion;
+
+int setup_tests(void **state) {
+	struct object_kind *kind;
+
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+#ifdef UNIX
+	/* Necessary for creating the randart file. */
+	create_needed_dirs();
+#endif
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	kind = lookup_kind(TV_POTION, lookup_sval(TV_POTION, "Speed"));
+	if (!kind) {
+		cleanup_angband();
+		return 1;
+	}
+	potion = object_new();
+	object_prep(potion, kind, 0, RANDOMISE);
+	potion->known = object_new();
+	object_set_base_known(player, potion);
+	object_touch(player, potion);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	object_free(potion->known);
+	object_free(potion);
+	cleanup_angband();
+	return 0;
+}
+
+static int test_same(void *state) {
+	char buf1[80], buf2[80];
+	size_t len1, len2;
+
+	len1 = object_desc(buf1, sizeof(buf1), potion, ODESC_PREFIX | ODESC_FULL,
+		player);
+	len2 = object_desc(buf2, sizeof(buf2), potion, ODESC_PREFIX | ODESC_FULL,
+		player);
+	eq(len1, len2);
+	eq(len1, strlen(buf1));
+	require(streq(buf1, buf2));
+
+	/* Other modes are described separately */
+	len2 = object_desc(buf2, sizeof(buf2), potion, ODESC_BASE, player);
+	require(!streq(buf1, buf2));
+	len2 = object_desc(buf2, sizeof(buf2), potion, ODESC_PREFIX | ODESC_FULL,
+		player);
+	require(streq(buf1, buf2));
+	ok;
+}
+
+static int test_number(void *state) {
+	char buf[80];
+
+	potion->number = 1;
+	object_desc(buf, sizeof(buf), potion, ODESC_PREFIX | ODESC_FULL, player);
+	require(prefix(buf, "a ") || prefix(buf, "an "));
+	potion->number = 3;
+	object_desc(buf, sizeof(buf), potion, ODESC_PREFIX | ODESC_FULL, player);
+	require(prefix(buf, "3 "));
+	potion->number = 1;
+	ok;
+}
+
+static int test_inscription(void *state) {
+	char buf[80];
+
+	object_desc(buf, sizeof(buf), potion, ODESC_PREFIX | ODESC_FULL, player);
+	null(strstr(buf, "{hurry}"));
+	potion->note = quark_add("hurry");
+	object_desc(buf, sizeof(buf), potion, ODESC_PREFIX | ODESC_FULL, player);
+	notnull(strstr(buf, "{hurry}"));
+	potion->note = 0;
+	object_desc(buf, sizeof(buf), potion, ODESC_PREFIX | ODESC_FULL, player);
+	null(strstr(buf, "{hurry}"));
+	ok;
+}
+
+static int test_learn(void *state) {
+	char buf[80];
+
+	require(!object_flavor_is_aware(potion));
+	object_desc(buf, sizeof(buf), potion, ODESC_PREFIX | ODESC_FULL, player);
+	null(strstr(buf, "Speed"));
+	object_flavor_aware(player, potion);
+	object_desc(buf, sizeof(buf), potion, ODESC_PREFIX | ODESC_FULL, player);
+	notnull(strstr(buf, "Speed"));
+	ok;
+}
+
+const char *suite_name = "object/desc";
+struct test tests[] = {
+	{ "same", test_same },
+	{ "number", test_number },
+	{ "inscription", test_inscription },
+	{ "learn", test_learn },
+	{ NULL, NULL }
+};
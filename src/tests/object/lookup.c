@@ -0,0 +1,185 @@
+/* object/lookup
+ *
+ * Tests for finding game data by name, or by tval and sval, against the
+ * walks along the tables that these lookups used to be
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "effects.h"
+#include "init.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "obj-desc.h"
+#include "obj-util.h"
+#include "object.h"
+#include "project.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+static struct object_kind *scan_kind(int tval, int sval)
+{
+	int k;
+
+	for (k = 0; k < z_info->k_max; k++) {
+		if (k_info[k].tval == tval && k_info[k].sval == sval) {
+			return &k_info[k];
+		}
+	}
+	return NULL;
+}
+
+static int scan_sval(int tval, const char *name)
+{
+	int k;
+
+	for (k = 0; k < z_info->k_max; k++) {
+		char cmp_name[1024];
+
+		if (!k_info[k].name || k_info[k].tval != tval) continue;
+		obj_desc_name_format(cmp_name, sizeof cmp_name, 0, k_info[k].name,
+			0, false);
+		if (!my_stricmp(cmp_name, name)) return k_info[k].sval;
+	}
+	return -1;
+}
+
+static struct monster_race *scan_monster(const char *name)
+{
+	struct monster_race *closest = NULL;
+	int i;
+
+	for (i = 0; i < z_info->r_max; i++) {
+		struct monster_race *race = &r_info[i];
+
+		if (!race->name) continue;
+		if (streq(name, race->name)) return race;
+		if (my_stricmp(name, race->name) == 0) closest = race;
+		if (!closest && my_stristr(race->name, name)) closest = race;
+	}
+	return closest;
+}
+
+/* Every kind is found by tval and sval, and by its name */
+static int test_kinds(void *state) {
+	int k;
+
+	for (k = 0; k < z_info->k_max; k++) {
+		struct object_kind *kind = &k_info[k];
+		char name[1024];
+
+		if (!kind->name) continue;
+		ptreq(lookup_kind(kind->tval, kind->sval),
+			scan_kind(kind->tval, kind->sval));
+		obj_desc_name_format(name, sizeof name, 0, kind->name, 0, false);
+		eq(lookup_sval(kind->tval, name), scan_sval(kind->tval, name));
+		my_strcap(name);
+		eq(lookup_sval(kind->tval, name), scan_sval(kind->tval, name));
+	}
+	null(lookup_kind(TV_SWORD, 250));
+	eq(lookup_sval(TV_SWORD, "Nothing at all"), -1);
+	eq(lookup_sval(TV_SWORD, "12"), 12);
+	ok;
+}
+
+/* Ego items are only found with the kinds they can be */
+static int test_egos(void *state) {
+	int i;
+
+	for (i = 0; i < z_info->e_max; i++) {
+		struct ego_item *ego = &e_info[i], *want = NULL;
+		struct poss_item *poss;
+		int j;
+
+		if (!ego->name) continue;
+		for (poss = ego->poss_items; poss; poss = poss->next) {
+			struct object_kind *kind = &k_info[poss->kidx];
+
+			/* The first ego of the name which the kind can be */
+			for (j = 0; j <= i && !want; j++) {
+				struct poss_item *p;
+
+				if (!e_info[j].name || !streq(e_info[j].name, ego->name)) {
+					continue;
+				}
+				for (p = e_info[j].poss_items; p; p = p->next) {
+					if (p->kidx == kind->kidx) want = &e_info[j];
+				}
+			}
+			ptreq(lookup_ego_item(ego->name, kind->tval, kind->sval), want);
+			want = NULL;
+		}
+	}
+	null(lookup_ego_item("of Nothing at all", TV_SWORD, 1));
+	ok;
+}
+
+/* Monsters are found by name, by name in any case, and by part of a name */
+static int test_monsters(void *state) {
+	int i;
+
+	for (i = 0; i < z_info->r_max; i++) {
+		char name[256];
+
+		if (!r_info[i].name) continue;
+		my_strcpy(name, r_info[i].name, sizeof(name));
+		ptreq(lookup_monster(name), scan_monster(name));
+		my_strcap(name);
+		ptreq(lookup_monster(name), scan_monster(name));
+		name[strlen(name) / 2] = '\0';
+		ptreq(lookup_monster(name), scan_monster(name));
+	}
+	null(lookup_monster("Nothing at all"));
+	ok;
+}
+
+/* Terrain, effects and projections are found by name */
+static int test_others(void *state) {
+	int i;
+
+	for (i = 0; i < z_info->f_max; i++) {
+		if (!f_info[i].name) continue;
+		eq(f_info[lookup_feat(f_info[i].name)].name, f_info[i].name);
+	}
+	eq(effect_lookup("HEAL_HP"), EF_HEAL_HP);
+	eq(effect_lookup("heal_hp"), EF_MAX);
+	eq(effect_lookup("NOT_AN_EFFECT"), EF_MAX);
+	eq(proj_name_to_idx("FIRE"), PROJ_FIRE);
+	eq(proj_name_to_idx("fire"), PROJ_FIRE);
+	eq(proj_name_to_idx("NOT_A_PROJECTION"), -1);
+	ok;
+}
+
+/* Every tval and sval pair finds what a walk along the table finds */
+static int test_pairs(void *state) {
+	int tval, sval;
+
+	for (tval = 0; tval < TV_MAX; tval++) {
+		for (sval = 0; sval < 256; sval++) {
+			ptreq(lookup_kind(tval, sval), scan_kind(tval, sval));
+		}
+	}
+	ok;
+}
+
+const char *suite_name = "object/lookup";
+struct test tests[] = {
+	{ "kinds", test_kinds },
+	{ "egos", test_egos },
+	{ "monsters", test_monsters },
+	{ "others", test_others },
+	{ "pairs", test_pairs },
+	{ NULL, NULL }
+};
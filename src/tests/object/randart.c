@@ -0,0 +1,115 @@
+/* object/randart
+ *
+ * Tests for the design of random artifacts from their seed
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "init.h"
+#include "obj-design.h"
+#include "object.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+#ifdef UNIX
+	/* Necessary for creating the randart file. */
+	create_needed_dirs();
+#endif
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* Throw away the random artifacts, so more can be designed */
+static void forget_randarts(int first)
+{
+	int i;
+
+	for (i = first; i < z_info->a_max; i++) {
+		string_free(a_info[i].name);
+		string_free(a_info[i].text);
+		mem_free(a_info[i].brands);
+		mem_free(a_info[i].slays);
+		mem_free(a_info[i].curses);
+	}
+	z_info->a_max = first;
+}
+
+/* Whether the randart file names the artifacts in order */
+static bool file_in_order(int first)
+{
+	char path[1024], line[1024];
+	ang_file *f;
+	int i = first;
+	bool right = true;
+
+	path_build(path, sizeof(path), ANGBAND_DIR_USER, "randart.txt");
+	f = file_open(path, MODE_READ, FTYPE_TEXT);
+	if (!f) return false;
+	while (file_getl(f, line, sizeof(line))) {
+		if (strncmp(line, "name:", 5)) continue;
+		if (i >= z_info->a_max || !streq(line + 5, a_info[i].name)) {
+			right = false;
+		}
+		i++;
+	}
+	file_close(f);
+	return right && i == z_info->a_max;
+}
+
+/* Characters born before artifacts had seeds of their own keep them */
+static int test_old_seeds(void *state) {
+	int first = z_info->a_max, i;
+	long cost = 0;
+
+	initialize_random_artifacts(12345);
+	eq(z_info->a_max, first + ART_NUM_RANDOM);
+	require(streq(a_info[first].name, "Armene"));
+	require(streq(a_info[first + 1].name, "Hirdin"));
+	require(streq(a_info[first + 2].name, "Lotel"));
+	for (i = first; i < z_info->a_max; i++) {
+		cost += a_info[i].cost;
+	}
+	eq(cost, 1880000);
+	require(file_in_order(first));
+	forget_randarts(first);
+	ok;
+}
+
+/* Seeds of their own give the same artifacts every time */
+static int test_separate_seeds(void *state) {
+	int first = z_info->a_max, i;
+	char *names[ART_NUM_RANDOM];
+	int32_t costs[ART_NUM_RANDOM];
+
+	initialize_random_artifacts(12345 | RANDART_SEED_SEPARATE);
+	require(file_in_order(first));
+	for (i = 0; i < ART_NUM_RANDOM; i++) {
+		names[i] = string_make(a_info[first + i].name);
+		costs[i] = a_info[first + i].cost;
+	}
+	forget_randarts(first);
+
+	initialize_random_artifacts(12345 | RANDART_SEED_SEPARATE);
+	for (i = 0; i < ART_NUM_RANDOM; i++) {
+		require(streq(a_info[first + i].name, names[i]));
+		eq(a_info[first + i].cost, costs[i]);
+		require(a_info[first + i].aidx == (uint32_t) (first + i));
+		string_free(names[i]);
+	}
+	forget_randarts(first);
+	ok;
+}
+
+const char *suite_name = "object/randart";
+struct test tests[] = {
+	{ "old-seeds", test_old_seeds },
+	{ "separate-seeds", test_separate_seeds },
+	{ NULL, NULL }
+};
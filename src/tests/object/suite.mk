@@ -1,7 +1,10 @@
 TESTPROGS += \
 	object/alloc \
 	object/attack \
+	object/desc \
 	object/info \
+	object/lookup \
 	object/pile \
+	object/randart \
 	object/slays \
 	object/util
@@ -0,0 +1,196 @@
+/* player/calc-bonuses.c */
+/* Check the remembered equipment bonuses give the same state as working
+ * everything out afresh. */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "obj-gear.h"
+#include "obj-knowledge.h"
+#include "obj-make.h"
+#include "obj-pile.h"
+#include "obj-tval.h"
+#include "obj-util.h"
+#include "player-birth.h"
+#include "player-calcs.h"
+#include "player-timed.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+#ifdef UNIX
+	/* Necessary for creating the randart file. */
+	create_needed_dirs();
+#endif
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	prepare_next_level(player);
+	on_new_level();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	wipe_mon_list(cave, player);
+	cleanup_angband();
+	return 0;
+}
+
+static struct object *setup_object(int tval, const char *name) {
+	struct object_kind *kind = lookup_kind(tval, lookup_sval(tval, name));
+	struct object *obj = NULL;
+
+	if (kind) {
+		obj = object_new();
+		object_prep(obj, kind, 0, RANDOMISE);
+		obj->known = object_new();
+		object_set_base_known(player, obj);
+		object_touch(player, obj);
+	}
+	return obj;
+}
+
+static bool same_state(const struct player_state *a,
+		const struct player_state *b) {
+	int i;
+
+	if (a->speed != b->speed || a->ac != b->ac || a->to_a != b->to_a
+			|| a->to_h != b->to_h || a->to_d != b->to_d
+			|| a->dam_red != b->dam_red || a->see_infra != b->see_infra
+			|| a->num_blows != b->num_blows
+			|| a->num_shots != b->num_shots
+			|| a->heavy_wield != b->heavy_wield) {
+		return false;
+	}
+	for (i = 0; i < STAT_MAX; i++) {
+		if (a->stat_add[i] != b->stat_add[i]
+				|| a->stat_use[i] != b->stat_use[i]) {
+			return false;
+		}
+	}
+	for (i = 0; i < SKILL_MAX; i++) {
+		if (a->skills[i] != b->skills[i]) return false;
+	}
+	for (i = 0; i < ELEM_MAX; i++) {
+		if (a->el_info[i].res_level != b->el_info[i].res_level) {
+			return false;
+		}
+	}
+	return of_is_equal(a->flags, b->flags)
+		&& pf_is_equal(a->pflags, b->pflags);
+}
+
+/* Both the player's states match ones worked out from scratch */
+static bool states_current(void) {
+	struct player_state fresh, known;
+
+	/* Without an update, stat_ind holds extra STR and DEX to try */
+	memset(&fresh, 0, sizeof(fresh));
+	memset(&known, 0, sizeof(known));
+	calc_bonuses(player, &fresh, false, false);
+	calc_bonuses(player, &known, true, false);
+	return same_state(&player->state, &fresh)
+		&& same_state(&player->known_state, &known);
+}
+
+static int test_timed(void *state) {
+	int speed;
+
+	player->upkeep->update |= PU_BONUS;
+	update_stuff(player);
+	require(states_current());
+	speed = player->state.speed;
+
+	require(player_inc_timed(player, TMD_FAST, 10, true, false, false));
+	update_stuff(player);
+	eq(player->state.speed, speed + 10);
+	require(states_current());
+
+	require(player_clear_timed(player, TMD_FAST, true, false));
+	update_stuff(player);
+	eq(player->state.speed, speed);
+	require(states_current());
+	ok;
+}
+
+static int test_wield(void *state) {
+	struct object *obj = setup_object(TV_SOFT_ARMOR, "Soft Leather Armour");
+	int slot = slot_by_name(player, "body");
+	struct object *old;
+	int ac = player->state.ac;
+
+	notnull(obj);
+	require(slot >= 0 && slot < player->body.count);
+	old = slot_object(player, slot);
+	if (old) {
+		ac -= old->ac;
+	}
+	inven_carry(player, obj, true, false);
+	update_stuff(player);
+	inven_wield(obj, slot);
+	update_stuff(player);
+	ptreq(slot_object(player, slot), obj);
+	eq(player->state.ac, ac + obj->ac);
+	require(states_current());
+	ok;
+}
+
+/* Gear changed behind the remembered bonuses' back is still noticed */
+static int test_swap(void *state) {
+	struct object *obj = setup_object(TV_SHIELD, "Leather Shield");
+	int slot = slot_by_name(player, "arm");
+	struct object *old;
+	int ac;
+
+	notnull(obj);
+	require(slot >= 0 && slot < player->body.count);
+	player->upkeep->update |= PU_BONUS;
+	update_stuff(player);
+	ac = player->state.ac;
+	old = player->body.slots[slot].obj;
+
+	player->body.slots[slot].obj = obj;
+	player->upkeep->update |= PU_BONUS_QUICK;
+	update_stuff(player);
+	eq(player->state.ac, ac + obj->ac - (old ? old->ac : 0));
+	require(states_current());
+
+	player->body.slots[slot].obj = old;
+	player->upkeep->update |= PU_BONUS_QUICK;
+	update_stuff(player);
+	eq(player->state.ac, ac);
+	require(states_current());
+
+	if (obj->known) {
+		object_free(obj->known);
+	}
+	object_free(obj);
+	ok;
+}
+
+/* Learning about the gear shows up in the known state */
+static int test_learn(void *state) {
+	player->upkeep->update |= PU_BONUS;
+	update_stuff(player);
+	player_learn_all_runes(player);
+	player->upkeep->update |= PU_BONUS_QUICK;
+	update_stuff(player);
+	require(states_current());
+	ok;
+}
+
+const char *suite_name = "player/calc-bonuses";
+struct test tests[] = {
+	{ "timed", test_timed },
+	{ "wield", test_wield },
+	{ "swap", test_swap },
+	{ "learn", test_learn },
+	{ NULL, NULL }
+};
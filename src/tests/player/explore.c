@@ -0,0 +1,350 @@
+/*
+ * player/explore
+ * Test the exploration frontier, path_nearest_unknown(), and the reuse of
+ * pathfinding results and storage.
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "cave-frontier.h"
+#include "init.h"
+#include "player.h"
+#include "player-birth.h"
+#include "player-path.h"
+#include "player-util.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* A small generator, so the maps are the same on every run */
+static uint32_t seed;
+
+static int pick(int n)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 16) % n;
+}
+
+static struct chunk *setup_level(int height, int width)
+{
+	struct chunk *c = t_build_arena(height, width);
+
+	cave = c;
+	player->cave = cave_new(height, width);
+	return c;
+}
+
+static void free_level(struct chunk *c)
+{
+	cave_free(player->cave);
+	player->cave = NULL;
+	cave_free(c);
+	cave = NULL;
+}
+
+/* Whether the kept frontier matches one built afresh */
+static bool frontier_right(struct chunk *known)
+{
+	bool *on = mem_zalloc(known->height * known->width * sizeof(bool));
+	const struct loc *list;
+	int i, n = frontier_grids(known, &list);
+	bool right = true;
+
+	for (i = 0; i < n; i++) {
+		on[list[i].y * known->width + list[i].x] = true;
+	}
+	frontier_free(known);
+	if (frontier_grids(known, &list) != n) right = false;
+	for (i = 0; i < n; i++) {
+		if (!on[list[i].y * known->width + list[i].x]) right = false;
+	}
+	mem_free(on);
+	return right;
+}
+
+/*
+ * The way path_nearest_unknown() used to find its destination, by looking at
+ * every grid of the map
+ */
+static int scan_nearest_unknown(struct player *p, struct loc start,
+		struct loc *dest_grid, int16_t **step_dirs)
+{
+	bool only_known = true, forbid_traps = true, passable = true;
+
+	while (1) {
+		struct pfdistances *distances = NULL;
+		struct loc min_grid = loc(-1, -1);
+		int min_turns = INT_MAX;
+		struct loc grid;
+
+		for (grid.y = 0; grid.y < p->cave->height; ++grid.y) {
+			for (grid.x = 0; grid.x < p->cave->width; ++grid.x) {
+				struct loc test_grid;
+				int turns;
+
+				if (loc_eq(grid, start)
+						|| !square_isknown(p->cave, grid)) {
+					continue;
+				}
+				if (count_neighbors(NULL, p->cave, grid,
+						square_isknown, false) == 8) {
+					continue;
+				}
+				if (passable) {
+					if (!square_ispassable(p->cave, grid)) {
+						continue;
+					}
+					test_grid = grid;
+				} else {
+					if (!square_iscloseddoor(p->cave, grid)
+							&& !square_isrubble(p->cave,
+							grid)) {
+						continue;
+					}
+					if (count_neighbors(&test_grid, p->cave,
+							grid, square_isknownpassable,
+							false) == 0
+							|| loc_eq(test_grid, start)) {
+						continue;
+					}
+				}
+				if (!distances) {
+					distances = prepare_pfdistances(p, start,
+						only_known, forbid_traps);
+				}
+				turns = pfdistances_to_turncount(distances,
+					test_grid);
+				if (turns > 0 && min_turns > turns) {
+					min_turns = turns;
+					min_grid = test_grid;
+				}
+			}
+		}
+
+		if (min_turns < INT_MAX) {
+			int path_length;
+
+			*dest_grid = min_grid;
+			path_length = pfdistances_to_path(distances, min_grid,
+				step_dirs);
+			release_pfdistances(distances);
+			return path_length;
+		}
+		release_pfdistances(distances);
+		if (forbid_traps && !player_is_trapsafe(p)) {
+			forbid_traps = false;
+		} else if (only_known) {
+			only_known = false;
+			forbid_traps = true;
+		} else if (passable) {
+			passable = false;
+			only_known = true;
+			forbid_traps = true;
+		} else {
+			*dest_grid = loc(-1, -1);
+			*step_dirs = NULL;
+			return -1;
+		}
+	}
+}
+
+/* Remembering and forgetting grids moves the frontier */
+static int test_frontier(void *state) {
+	struct chunk *c = setup_level(20, 30);
+	struct loc grid;
+
+	for (grid.y = 5; grid.y <= 10; grid.y++) {
+		for (grid.x = 5; grid.x <= 10; grid.x++) {
+			square_memorize(c, grid);
+		}
+	}
+	require(frontier_has(player->cave, loc(5, 5)));
+	require(frontier_has(player->cave, loc(10, 7)));
+	require(!frontier_has(player->cave, loc(7, 7)));
+	require(!frontier_has(player->cave, loc(4, 4)));
+
+	/* Remember a row further along, then forget a grid in the middle */
+	for (grid.x = 5; grid.x <= 10; grid.x++) {
+		square_memorize(c, loc(grid.x, 11));
+	}
+	require(!frontier_has(player->cave, loc(7, 10)));
+	require(frontier_has(player->cave, loc(7, 11)));
+	square_forget(c, loc(8, 8));
+	require(!frontier_has(player->cave, loc(8, 8)));
+	require(frontier_has(player->cave, loc(7, 7)));
+	require(frontier_right(player->cave));
+
+	/* Grids on the edge of the map always have an unknown neighbour */
+	square_memorize(c, loc(0, 0));
+	require(frontier_has(player->cave, loc(0, 0)));
+	require(frontier_right(player->cave));
+
+	free_level(c);
+	ok;
+}
+
+/* With nowhere left to walk to, the way on is through a door */
+static int test_door(void *state) {
+	struct chunk *c = setup_level(20, 30);
+	struct loc grid, want, got;
+	int16_t *want_steps, *got_steps;
+	int want_len, got_len, k;
+
+	for (grid.y = 4; grid.y <= 12; grid.y++) {
+		for (grid.x = 4; grid.x <= 12; grid.x++) {
+			if (grid.y == 4 || grid.y == 12 || grid.x == 4
+					|| grid.x == 12) {
+				square_set_feat(c, grid, FEAT_GRANITE);
+			}
+			square_memorize(c, grid);
+		}
+	}
+	square_set_feat(c, loc(12, 8), FEAT_CLOSED);
+	square_memorize(c, loc(12, 8));
+
+	want_len = scan_nearest_unknown(player, loc(6, 6), &want, &want_steps);
+	got_len = path_nearest_unknown(player, loc(6, 6), &got, &got_steps);
+	require(want_len > 0);
+	eq(got_len, want_len);
+	require(loc_eq(got, want));
+	eq(got.x, 11);
+	for (k = 0; k < want_len; k++) {
+		eq(got_steps[k], want_steps[k]);
+	}
+	mem_free(want_steps);
+	mem_free(got_steps);
+
+	free_level(c);
+	ok;
+}
+
+/* The destination and path are those the scan of the whole map finds */
+static int test_nearest(void *state) {
+	int trial;
+
+	seed = 42;
+	for (trial = 0; trial < 40; trial++) {
+		struct chunk *c = setup_level(30, 60);
+		struct loc start = loc(1 + pick(58), 1 + pick(28)), grid;
+		int i;
+
+		/* Scatter some walls, doors and rubble */
+		for (i = 0; i < 300; i++) {
+			int feats[] = { FEAT_GRANITE, FEAT_GRANITE, FEAT_CLOSED,
+				FEAT_RUBBLE };
+
+			grid = loc(1 + pick(58), 1 + pick(28));
+			if (loc_eq(grid, start)) continue;
+			square_set_feat(c, grid, feats[pick(4)]);
+		}
+
+		/* Learn the map a bit at a time, going to each destination */
+		for (i = 0; i < 30; i++) {
+			struct loc want, got;
+			int16_t *want_steps, *got_steps;
+			int want_len, got_len, k;
+
+			for (k = 0; k < 60; k++) {
+				grid = loc(start.x - 8 + pick(17),
+					start.y - 8 + pick(17));
+				if (square_in_bounds(c, grid)) {
+					square_memorize(c, grid);
+				}
+			}
+			want_len = scan_nearest_unknown(player, start, &want,
+				&want_steps);
+			got_len = path_nearest_unknown(player, start, &got,
+				&got_steps);
+			eq(got_len, want_len);
+			require(loc_eq(got, want));
+			for (k = 0; k < want_len; k++) {
+				eq(got_steps[k], want_steps[k]);
+			}
+			mem_free(want_steps);
+			mem_free(got_steps);
+			if (want_len <= 0) break;
+			if (square_ispassable(c, want)) start = want;
+		}
+		require(frontier_right(player->cave));
+		free_level(c);
+	}
+	ok;
+}
+
+/* Distances are reused until the player's memory changes */
+static int test_cached_distances(void *state) {
+	struct chunk *c = setup_level(20, 30);
+	struct pfdistances *first, *again, *after;
+	int16_t *steps1, *steps2;
+	struct loc grid;
+	int len1, len2, k;
+
+	for (grid.y = 5; grid.y <= 10; grid.y++) {
+		for (grid.x = 5; grid.x <= 10; grid.x++) {
+			square_memorize(c, grid);
+		}
+	}
+	first = prepare_pfdistances(player, loc(6, 6), true, true);
+	again = prepare_pfdistances(player, loc(6, 6), true, true);
+	ptreq(again, first);
+	eq(pfdistances_to_turncount(first, loc(10, 10)), 4);
+	eq(pfdistances_to_turncount(first, loc(12, 7)), -1);
+	release_pfdistances(again);
+
+	/* A different start or different options are a different search */
+	again = prepare_pfdistances(player, loc(6, 7), true, true);
+	require(again != first);
+	release_pfdistances(again);
+	again = prepare_pfdistances(player, loc(6, 6), false, true);
+	require(again != first);
+	eq(pfdistances_to_turncount(again, loc(12, 7)), 6);
+	release_pfdistances(again);
+
+	/* Remembering more means searching again */
+	square_memorize(c, loc(11, 7));
+	square_memorize(c, loc(12, 7));
+	after = prepare_pfdistances(player, loc(6, 6), true, true);
+	require(after != first);
+	eq(pfdistances_to_turncount(after, loc(12, 7)), 6);
+	eq(pfdistances_to_turncount(first, loc(12, 7)), -1);
+	release_pfdistances(after);
+	release_pfdistances(first);
+
+	/* Paths found with reused storage are the same each time */
+	len1 = find_path(player, loc(6, 6), loc(12, 7), &steps1);
+	len2 = find_path(player, loc(6, 6), loc(12, 7), &steps2);
+	eq(len1, 6);
+	eq(len2, len1);
+	for (k = 0; k < len1; k++) {
+		eq(steps2[k], steps1[k]);
+	}
+	mem_free(steps1);
+	mem_free(steps2);
+
+	free_level(c);
+	ok;
+}
+
+const char *suite_name = "player/explore";
+struct test tests[] = {
+	{ "frontier", test_frontier },
+	{ "door", test_door },
+	{ "nearest", test_nearest },
+	{ "cached-distances", test_cached_distances },
+	{ NULL, NULL }
+};
@@ -1,7 +1,9 @@
 TESTPROGS += player/birth \
+             player/calc-bonuses \
              player/calc-inventory \
              player/combine-pack \
              player/digging \
+             player/explore \
              player/history \
              player/inven-carry-num \
              player/inven-wield \
@@ -9,4 +11,5 @@ TESTPROGS += player/birth \
              player/playerstat \
              player/pscore \
              player/timed \
+             player/travel \
              player/util
@@ -0,0 +1,215 @@
+/*
+ * player/travel
+ * Test long paths across large levels, which find_path() finds by way of
+ * regions of the map.
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "cave.h"
+#include "init.h"
+#include "player.h"
+#include "player-birth.h"
+#include "player-path.h"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	if (!init_angband()) {
+		return 1;
+	}
+	if (!player_make_simple(NULL, NULL, "Tester")) {
+		cleanup_angband();
+		return 1;
+	}
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/* A small generator, so the maps are the same on every run */
+static uint32_t seed;
+
+static int pick(int n)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 16) % n;
+}
+
+/*
+ * A wilderness-sized level, remembered in full, with walls running down it
+ * that have a few gaps and some scattered boulders
+ */
+static struct chunk *setup_level(void)
+{
+	struct chunk *c = t_build_arena(66, 198);
+	struct loc grid;
+	int x, i;
+
+	cave = c;
+	for (x = 20; x < 198 - 20; x += 25) {
+		for (grid.y = 1; grid.y < 65; grid.y++) {
+			if (pick(12)) {
+				square_set_feat(c, loc(x, grid.y), FEAT_GRANITE);
+			}
+		}
+	}
+	for (i = 0; i < 800; i++) {
+		square_set_feat(c, loc(1 + pick(196), 1 + pick(64)),
+			FEAT_GRANITE);
+	}
+	player->cave = cave_new(c->height, c->width);
+	for (grid.y = 0; grid.y < c->height; grid.y++) {
+		for (grid.x = 0; grid.x < c->width; grid.x++) {
+			square_memorize(c, grid);
+		}
+	}
+	return c;
+}
+
+static void free_level(struct chunk *c)
+{
+	cave_free(player->cave);
+	player->cave = NULL;
+	cave_free(c);
+	cave = NULL;
+}
+
+static struct loc pick_floor(struct chunk *c, int x1, int x2)
+{
+	struct loc grid;
+
+	do {
+		grid = loc(x1 + pick(x2 - x1), 1 + pick(64));
+	} while (!square_ispassable(c, grid));
+	return grid;
+}
+
+/* Whether the steps lead from start to dest over passable grids */
+static bool path_walks(struct chunk *c, struct loc start, struct loc dest,
+		const int16_t *steps, int length)
+{
+	struct loc grid = start;
+	int k;
+
+	for (k = length - 1; k >= 0; k--) {
+		grid = loc_sum(grid, ddgrid[steps[k]]);
+		if (!square_ispassable(c, grid)) return false;
+	}
+	return loc_eq(grid, dest);
+}
+
+/* Long paths go where they should, and are close to the shortest */
+static int test_long(void *state) {
+	struct chunk *c;
+	int trial;
+
+	seed = 7;
+	c = setup_level();
+	for (trial = 0; trial < 40; trial++) {
+		struct loc start = pick_floor(c, 1, 40);
+		struct loc dest = pick_floor(c, 150, 197);
+		struct pfdistances *dist = prepare_pfdistances(player, start,
+			true, true);
+		int best = pfdistances_to_turncount(dist, dest), length;
+		int16_t *steps;
+
+		release_pfdistances(dist);
+		length = find_path(player, start, dest, &steps);
+		if (best < 0) {
+			eq(length, -1);
+			continue;
+		}
+		require(length > 0);
+		require(path_walks(c, start, dest, steps, length));
+		require(length >= best);
+		require(length <= best + best / 5);
+		mem_free(steps);
+	}
+	free_level(c);
+	ok;
+}
+
+/* Changes to what the player remembers are noticed */
+static int test_changes(void *state) {
+	struct chunk *c;
+	struct loc start, dest, grid;
+	int16_t *steps;
+	int length;
+
+	seed = 11;
+	c = setup_level();
+	start = pick_floor(c, 1, 15);
+	dest = pick_floor(c, 180, 197);
+	length = find_path(player, start, dest, &steps);
+	require(length > 0);
+	mem_free(steps);
+
+	/* Close all but one gap in a wall, which the path must now use */
+	for (grid.y = 1; grid.y < 65; grid.y++) {
+		square_set_feat(c, loc(95, grid.y), FEAT_GRANITE);
+		square_memorize(c, loc(95, grid.y));
+	}
+	square_set_feat(c, loc(95, 60), FEAT_FLOOR);
+	square_memorize(c, loc(95, 60));
+	square_set_feat(c, loc(94, 60), FEAT_FLOOR);
+	square_memorize(c, loc(94, 60));
+	square_set_feat(c, loc(96, 60), FEAT_FLOOR);
+	square_memorize(c, loc(96, 60));
+	length = find_path(player, start, dest, &steps);
+	require(length > 0);
+	require(path_walks(c, start, dest, steps, length));
+	mem_free(steps);
+
+	/* Closing that too leaves no way through */
+	square_set_feat(c, loc(95, 60), FEAT_GRANITE);
+	square_memorize(c, loc(95, 60));
+	length = find_path(player, start, dest, &steps);
+	eq(length, -1);
+	null(steps);
+
+	free_level(c);
+	ok;
+}
+
+/* Short paths are the shortest there are */
+static int test_short(void *state) {
+	struct chunk *c;
+	int trial;
+
+	seed = 3;
+	c = setup_level();
+	for (trial = 0; trial < 40; trial++) {
+		struct loc start = pick_floor(c, 60, 80), dest;
+		struct pfdistances *dist = prepare_pfdistances(player, start,
+			true, true);
+		int best, length;
+		int16_t *steps;
+
+		do {
+			dest = pick_floor(c, 60, 80);
+		} while (ABS(dest.y - start.y) >= 20);
+		best = pfdistances_to_turncount(dist, dest);
+		release_pfdistances(dist);
+		length = find_path(player, start, dest, &steps);
+		if (best < 0) {
+			eq(length, -1);
+			continue;
+		}
+		eq(length, best);
+		require(path_walks(c, start, dest, steps, length));
+		mem_free(steps);
+	}
+	free_level(c);
+	ok;
+}
+
+const char *suite_name = "player/travel";
+struct test tests[] = {
+	{ "long", test_long },
+	{ "changes", test_changes },
+	{ "short", test_short },
+	{ NULL, NULL }
+};
@@ -0,0 +1,207 @@
+/* z-bitflag/bitflag.c */
+/* Exercise the flag set operations declared in z-bitflag.h. */
+
+#include "unit-test.h"
+#include "z-bitflag.h"
+#include <time.h>
+
+NOSETUP
+NOTEARDOWN
+
+/* Sizes either side of a word, and a few words with some left over */
+#define BIG_SIZE 21
+static const size_t sizes[] = { 1, 3, 7, 8, 9, 16, BIG_SIZE };
+
+/* A small generator, so the sets are the same on every run */
+static uint32_t seed;
+
+static int pick(int n)
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 16) % n;
+}
+
+/* Fill a set with roughly one flag in `sparse` turned on */
+static void fill(bitflag *flags, size_t size, int sparse)
+{
+	size_t i;
+	int f;
+
+	memset(flags, 0, size);
+	for (f = FLAG_START; f < FLAG_MAX(size); f++) {
+		if (!pick(sparse)) {
+			flags[FLAG_OFFSET(f)] |= FLAG_BINARY(f);
+		}
+	}
+
+	/* Sometimes fill a whole byte, to catch the edges of the word */
+	if (!pick(4)) {
+		i = pick((int) size);
+		flags[i] = (bitflag) -1;
+	}
+}
+
+/* The one bit at a time way of asking about a flag */
+static bool naive_has(const bitflag *flags, int f)
+{
+	return (flags[FLAG_OFFSET(f)] & FLAG_BINARY(f)) != 0;
+}
+
+/* The word operations give the same answers as looking at each flag */
+static int test_queries(void *state) {
+	bitflag a[BIG_SIZE], b[BIG_SIZE];
+	size_t k;
+	int trial;
+
+	seed = 5;
+	for (k = 0; k < N_ELEMENTS(sizes); k++) {
+		size_t size = sizes[k];
+
+		for (trial = 0; trial < 200; trial++) {
+			int count = 0, f, next = FLAG_END;
+			bool empty = true, full = true, inter = false;
+			bool subset = true;
+
+			fill(a, size, 1 + trial % 9);
+			fill(b, size, 1 + trial % 5);
+			if (trial % 7 == 0) memcpy(b, a, size);
+			for (f = FLAG_MAX(size) - 1; f >= FLAG_START; f--) {
+				bool in_a = naive_has(a, f), in_b = naive_has(b, f);
+
+				eq(flag_has(a, size, f), in_a);
+				if (in_a) {
+					count++;
+					next = f;
+				}
+				eq(flag_next(a, size, f), next);
+				if (in_a) empty = false;
+				else full = false;
+				if (in_a && in_b) inter = true;
+				if (in_b && !in_a) subset = false;
+			}
+			eq(flag_next(a, size, FLAG_END), next);
+			eq(flag_next(a, size, FLAG_MAX(size)), FLAG_END);
+			eq(flag_count(a, size), count);
+			eq(flag_is_empty(a, size), empty);
+			eq(flag_is_full(a, size), full);
+			eq(flag_is_inter(a, b, size), inter);
+			eq(flag_is_subset(a, b, size), subset);
+			eq(flag_is_equal(a, b, size), !memcmp(a, b, size));
+		}
+	}
+	ok;
+}
+
+/* The word operations change the same flags as doing each flag in turn */
+static int test_changes(void *state) {
+	bitflag a[BIG_SIZE], b[BIG_SIZE], got[BIG_SIZE], want[BIG_SIZE];
+	size_t k;
+	int trial;
+
+	seed = 9;
+	for (k = 0; k < N_ELEMENTS(sizes); k++) {
+		size_t size = sizes[k];
+
+		for (trial = 0; trial < 200; trial++) {
+			bool changed;
+			size_t i;
+
+			fill(a, size, 1 + trial % 4);
+			fill(b, size, 1 + trial % 6);
+			if (trial % 5 == 0) memcpy(b, a, size);
+
+			memcpy(got, a, size);
+			changed = flag_union(got, b, size);
+			for (i = 0; i < size; i++) want[i] = a[i] | b[i];
+			require(!memcmp(got, want, size));
+			eq(changed, memcmp(a, want, size) != 0);
+
+			memcpy(got, a, size);
+			changed = flag_inter(got, b, size);
+			for (i = 0; i < size; i++) want[i] = a[i] & b[i];
+			require(!memcmp(got, want, size));
+			eq(changed, memcmp(a, b, size) != 0);
+
+			memcpy(got, a, size);
+			changed = flag_diff(got, b, size);
+			for (i = 0; i < size; i++) want[i] = a[i] & ~b[i];
+			require(!memcmp(got, want, size));
+			eq(changed, memcmp(a, want, size) != 0);
+
+			memcpy(got, a, size);
+			flag_negate(got, size);
+			for (i = 0; i < size; i++) want[i] = ~a[i];
+			require(!memcmp(got, want, size));
+
+			memcpy(got, a, size);
+			eq(flag_on(got, size, FLAG_START), !naive_has(a, FLAG_START));
+			require(naive_has(got, FLAG_START));
+			eq(flag_off(got, size, FLAG_MAX(size) - 1),
+				naive_has(a, FLAG_MAX(size) - 1));
+			require(!naive_has(got, FLAG_MAX(size) - 1));
+		}
+	}
+	ok;
+}
+
+/* The va-args functions still see every flag */
+static int test_varargs(void *state) {
+	bitflag f[3];
+
+	flags_init(f, 3, 2, 9, 24, FLAG_END);
+	eq(flag_count(f, 3), 3);
+	require(flags_test(f, 3, 5, 24, FLAG_END));
+	require(!flags_test(f, 3, 5, 6, FLAG_END));
+	require(flags_test_all(f, 3, 2, 9, FLAG_END));
+	require(!flags_test_all(f, 3, 2, 10, FLAG_END));
+	require(flags_set(f, 3, 10, FLAG_END));
+	require(!flags_set(f, 3, 10, FLAG_END));
+	require(flags_clear(f, 3, 2, FLAG_END));
+	require(flags_mask(f, 3, 9, 24, FLAG_END));
+	eq(flag_next(f, 3, FLAG_START), 9);
+	eq(flag_next(f, 3, 10), 24);
+	eq(flag_next(f, 3, 25), FLAG_END);
+	ok;
+}
+
+/* Time the commonest operations on a set the size of the object flags */
+static int test_bench(void *state) {
+	bitflag sets[64][BIG_SIZE], acc[BIG_SIZE];
+	clock_t begin;
+	long total = 0;
+	int round, i, f;
+
+	seed = 13;
+	for (i = 0; i < 64; i++) fill(sets[i], BIG_SIZE, 6);
+	begin = clock();
+	for (round = 0; round < 20000; round++) {
+		flag_wipe(acc, BIG_SIZE);
+		for (i = 0; i < 64; i++) {
+			if (flag_is_inter(acc, sets[i], BIG_SIZE)) total++;
+			flag_union(acc, sets[i], BIG_SIZE);
+			if (flag_has(sets[i], BIG_SIZE, 1 + (round + i) % 160)) {
+				total++;
+			}
+		}
+		total += flag_count(acc, BIG_SIZE);
+		for (f = flag_next(acc, BIG_SIZE, FLAG_START); f != FLAG_END;
+				f = flag_next(acc, BIG_SIZE, f + 1)) {
+			total++;
+		}
+	}
+	if (verbose) {
+		printf("(%.2f usec per round of 64 sets) ",
+			(clock() - begin) * 1000000.0 / CLOCKS_PER_SEC / 20000);
+	}
+	require(total > 0);
+	ok;
+}
+
+const char *suite_name = "z-bitflag/bitflag";
+struct test tests[] = {
+	{ "queries", test_queries },
+	{ "changes", test_changes },
+	{ "varargs", test_varargs },
+	{ "bench", test_bench },
+	{ NULL, NULL }
+};
@@ -0,0 +1,90 @@
+/* z-index/index.c */
+/* Exercise the name and pair indexes declared in z-index.h. */
+
+#include "unit-test.h"
+#include "z-index.h"
+#include "z-form.h"
+#include "z-virt.h"
+
+NOSETUP
+NOTEARDOWN
+
+/* Names are found exactly, within their group, and the first value stays */
+static int test_names(void *state) {
+	struct name_index *ix = name_index_new(false);
+
+	name_index_add(ix, 0, "Scroll", 1);
+	name_index_add(ix, 3, "Scroll", 2);
+	name_index_add(ix, 0, "Scroll", 5);
+	eq(name_index_find(ix, 0, "Scroll"), 1);
+	eq(name_index_find(ix, 3, "Scroll"), 2);
+	eq(name_index_find(ix, 1, "Scroll"), -1);
+	eq(name_index_find(ix, 0, "scroll"), -1);
+	eq(name_index_find(ix, 0, "Scrol"), -1);
+	eq(name_index_find(ix, 0, NULL), -1);
+	eq(name_index_find(NULL, 0, "Scroll"), -1);
+	name_index_free(ix);
+	ok;
+}
+
+/* A folding index ignores case */
+static int test_fold(void *state) {
+	struct name_index *ix = name_index_new(true);
+
+	name_index_add(ix, 0, "Bolt", 4);
+	name_index_add(ix, 0, "BOLT", 7);
+	eq(name_index_find(ix, 0, "bolt"), 4);
+	eq(name_index_find(ix, 0, "bOLt"), 4);
+	eq(name_index_find(ix, 0, "bolts"), -1);
+	name_index_free(ix);
+	ok;
+}
+
+/* Lots of names make the table grow without losing any */
+static int test_grow(void *state) {
+	struct name_index *ix = name_index_new(false);
+	char name[32];
+	int i;
+
+	for (i = 0; i < 5000; i++) {
+		strnfmt(name, sizeof(name), "name %d", i);
+		name_index_add(ix, i % 7, name, i);
+	}
+	for (i = 0; i < 5000; i++) {
+		strnfmt(name, sizeof(name), "name %d", i);
+		eq(name_index_find(ix, i % 7, name), i);
+		eq(name_index_find(ix, (i + 1) % 7, name), -1);
+	}
+	name_index_free(ix);
+	ok;
+}
+
+/* Pairs are found in rows which grow as needed */
+static int test_pairs(void *state) {
+	struct pair_index *ix = pair_index_new();
+
+	eq(pair_index_find(ix, 0, 0), -1);
+	pair_index_add(ix, 5, 2, 10);
+	pair_index_add(ix, 1, 40, 11);
+	pair_index_add(ix, 5, 2, 12);
+	pair_index_add(ix, 5, 0, 0);
+	eq(pair_index_find(ix, 5, 2), 10);
+	eq(pair_index_find(ix, 1, 40), 11);
+	eq(pair_index_find(ix, 5, 0), 0);
+	eq(pair_index_find(ix, 5, 1), -1);
+	eq(pair_index_find(ix, 3, 2), -1);
+	eq(pair_index_find(ix, 6, 2), -1);
+	eq(pair_index_find(ix, 5, 41), -1);
+	eq(pair_index_find(ix, -1, 2), -1);
+	pair_index_free(ix);
+	ok;
+}
+
+const char *suite_name = "z-index/index";
+struct test tests[] = {
+	{ "names", test_names },
+	{ "fold", test_fold },
+	{ "grow", test_grow },
+	{ "pairs", test_pairs },
+	{ NULL, NULL }
+};
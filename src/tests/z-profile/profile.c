@@ -0,0 +1,91 @@
+/* z-profile/profile.c */
+/* Exercise the counters declared in z-profile.h. */
+
+#include "unit-test.h"
+#include "z-profile.h"
+#include "z-textblock.h"
+
+NOSETUP
+NOTEARDOWN
+
+static struct profile_counter walk = { .name = "walk", .unit = "grids" };
+static struct profile_counter talk = { .name = "talk", .unit = "rows" };
+
+/* Counters join the list in the order they are first used */
+static int test_count(void *state) {
+	uint64_t start = profile_now();
+
+	null(profile_counters());
+	profile_count(&walk, start, 5);
+	profile_count(&walk, start, 7);
+	profile_count(&talk, profile_now(), 1);
+	ptreq(profile_counters(), &walk);
+	ptreq(walk.next, &talk);
+	null(talk.next);
+	eq(walk.total.calls, 2);
+	eq(walk.total.work, 12);
+	eq(walk.turn.calls, 2);
+	require(walk.total.max_ns <= walk.total.ns);
+	eq(talk.total.calls, 1);
+
+	/* Counting again doesn't add to the list again */
+	profile_count(&talk, profile_now(), 1);
+	null(talk.next);
+	eq(talk.total.calls, 2);
+	ok;
+}
+
+/* Turns move on to the last turn, and the worst is kept */
+static int test_turns(void *state) {
+	uint64_t worst;
+
+	profile_new_turn();
+	eq(walk.last.calls, 2);
+	eq(walk.worst.calls, 2);
+	eq(walk.turn.calls, 0);
+	worst = walk.worst.ns + talk.worst.ns;
+
+	/* A turn with nothing counted is the last, but not the worst */
+	profile_new_turn();
+	eq(walk.last.calls, 0);
+	eq(walk.worst.calls, 2);
+	require(walk.worst.ns + talk.worst.ns == worst);
+	eq(walk.total.calls, 2);
+	ok;
+}
+
+static int test_describe(void *state) {
+	textblock *tb = textblock_new();
+	const wchar_t *text;
+
+	profile_describe(tb);
+	text = textblock_text(tb);
+	notnull(wcsstr(text, L"walk"));
+	notnull(wcsstr(text, L"talk"));
+	notnull(wcsstr(text, L"grids"));
+	textblock_free(tb);
+	ok;
+}
+
+static int test_reset(void *state) {
+	profile_reset();
+	ptreq(profile_counters(), &walk);
+	eq(walk.total.calls, 0);
+	eq(walk.worst.calls, 0);
+	eq(talk.total.ns, 0);
+
+	/* After a reset any turn with time counted is the worst */
+	profile_count(&talk, profile_now() - 10, 1);
+	profile_new_turn();
+	eq(talk.worst.calls, 1);
+	ok;
+}
+
+const char *suite_name = "z-profile/profile";
+struct test tests[] = {
+	{ "count", test_count },
+	{ "turns", test_turns },
+	{ "describe", test_describe },
+	{ "reset", test_reset },
+	{ NULL, NULL }
+};
@@ -3,6 +3,7 @@
 #include "unit-test.h"
 #include "z-color.h"
 #include "z-textblock.h"
+#include "z-virt.h"
 
 int setup_tests(void **state) {
 	ok;
@@ -102,6 +103,53 @@ static int test_append_textblock(void *state) {
 	ok;
 }
 
+static int test_reuse(void *state) {
+	textblock *tb = textblock_new();
+	int i;
+
+	for (i = 0; i < 100; i++) {
+		textblock_append_c(tb, COLOUR_L_RED, "%s", "a longer line of text ");
+	}
+	textblock_append_pict(tb, COLOUR_L_RED, 'x');
+	textblock_free(tb);
+
+	/* A block made again after one is freed starts out empty */
+	tb = textblock_new();
+	require(!wcscmp(textblock_text(tb), L""));
+	textblock_append_pict(tb, COLOUR_L_GREEN, 'y');
+	require(!wcscmp(textblock_text(tb), L"y"));
+	textblock_append(tb, "es");
+	require(!wcscmp(textblock_text(tb), L"yes"));
+	eq(textblock_attrs(tb)[2], COLOUR_WHITE);
+	textblock_free(tb);
+
+	textblock_cleanup();
+
+	ok;
+}
+
+static int test_lines(void *state) {
+	textblock *tb = textblock_new();
+	size_t *line_starts = NULL, *line_lengths = NULL;
+	size_t n_lines;
+	int i;
+
+	/* Enough lines to need more than one lot of space for them */
+	for (i = 0; i < 60; i++) {
+		textblock_append(tb, "line %d\n", i);
+	}
+	n_lines = textblock_calculate_lines(tb, &line_starts, &line_lengths,
+		80);
+	eq(n_lines, 60);
+	eq(line_starts[59], 7 * 10 + 8 * 49);
+	eq(line_lengths[59], 7);
+	mem_free(line_starts);
+	mem_free(line_lengths);
+	textblock_free(tb);
+
+	ok;
+}
+
 const char *suite_name = "z-textblock/textblock";
 struct test tests[] = {
 	{ "alloc", test_alloc },
@@ -109,5 +157,7 @@ struct test tests[] = {
 	{ "colour", test_colour },
 	{ "length", test_length },
 	{ "append_textblock", test_append_textblock },
+	{ "reuse", test_reuse },
+	{ "lines", test_lines },
 	{ NULL, NULL }
 };
@@ -27,6 +27,7 @@
 #include "mon-util.h"
 #include "obj-knowledge.h"
 #include "player-attack.h"
+#include "player-path.h"
 #include "player-quest.h"
 #include "player-timed.h"
 #include "player-util.h"
@@ -486,7 +487,9 @@ void square_memorize_traps(struct chunk *c, struct loc grid)
 {
 	struct trap *trap = square(c, grid)->trap;
 	struct trap *current = NULL;
+	bool had_traps;
 	if (c != cave) return;
+	had_traps = square(player->cave, grid)->trap != NULL;
 
 	/* Clear current knowledge */
 	square_remove_all_traps(player->cave, grid);
@@ -512,6 +515,10 @@ void square_memorize_traps(struct chunk *c, struct loc grid)
 	if (square(player->cave, grid)->trap) {
 		sqinfo_on(square(player->cave, grid)->info, SQUARE_TRAP);
 	}
+	if (had_traps || square(player->cave, grid)->trap) {
+		cave_memory_changed(player->cave);
+		path_regions_note(player->cave, grid);
+	}
 }
 
 /**
@@ -1996,6 +1996,310 @@ static void count_objects(const struct object *obj, void *closure)
 }
 
 
+/**
+ * What was worked out for one object the last time the items were gathered.
+ * Entries are kept between visits to the screen so only objects that are
+ * new, or that have changed, need their properties worked out again.
+ */
+struct equippable_index_entry {
+	const struct object *obj;
+	/** Is a fingerprint of everything the values below depend on. */
+	uint64_t stamp;
+	/** Is the gathering of the items that last used this. */
+	uint32_t visit;
+	char *short_name;
+	int nshortnm;
+	int *vals;
+	int *auxvals;
+	enum equippable_quality qual;
+	int slot;
+	wchar_t ch;
+	uint8_t at;
+	struct equippable_index_entry *next;
+};
+
+
+#define EQUIP_INDEX_SIZE 256
+
+/**
+ * Holds the entries, hashed by the object's address, and what they were
+ * worked out with.
+ */
+struct equippable_index {
+	struct equippable_index_entry *buckets[EQUIP_INDEX_SIZE];
+	/** Is the fingerprint of the player's knowledge for this gathering. */
+	uint64_t knowledge;
+	uint32_t visit;
+	int nprop;
+};
+
+
+static struct equippable_index *the_index = NULL;
+
+
+/**
+ * Add some bytes to a fingerprint (FNV-1a).
+ */
+static uint64_t stamp_bytes(uint64_t h, const void *data, size_t n)
+{
+	const unsigned char *b = data;
+	size_t i;
+
+	for (i = 0; i < n; ++i) {
+		h ^= b[i];
+		h *= UINT64_C(1099511628211);
+	}
+	return h;
+}
+
+
+/**
+ * Add what an object, or the player's knowledge of one, carries in the way
+ * of properties to a fingerprint.
+ */
+static uint64_t stamp_properties(uint64_t h, const struct object *obj)
+{
+	int i;
+
+	h = stamp_bytes(h, obj->flags, sizeof(obj->flags));
+	h = stamp_bytes(h, obj->modifiers, sizeof(obj->modifiers));
+	for (i = 0; i < ELEM_MAX; ++i) {
+		h = stamp_bytes(h, &obj->el_info[i].res_level,
+			sizeof(obj->el_info[i].res_level));
+		h = stamp_bytes(h, &obj->el_info[i].flags,
+			sizeof(obj->el_info[i].flags));
+	}
+	if (obj->curses) {
+		for (i = 0; i < z_info->curse_max; ++i) {
+			h = stamp_bytes(h, &obj->curses[i].power,
+				sizeof(obj->curses[i].power));
+		}
+	}
+	return h;
+}
+
+
+/**
+ * Add what an object's name and quality are worked out from to a
+ * fingerprint.
+ */
+static uint64_t stamp_object(uint64_t h, const struct object *obj)
+{
+	h = stamp_bytes(h, &obj->kind, sizeof(obj->kind));
+	h = stamp_bytes(h, &obj->ego, sizeof(obj->ego));
+	h = stamp_bytes(h, &obj->artifact, sizeof(obj->artifact));
+	h = stamp_bytes(h, &obj->number, sizeof(obj->number));
+	h = stamp_bytes(h, &obj->pval, sizeof(obj->pval));
+	h = stamp_bytes(h, &obj->dd, sizeof(obj->dd));
+	h = stamp_bytes(h, &obj->ds, sizeof(obj->ds));
+	h = stamp_bytes(h, &obj->ac, sizeof(obj->ac));
+	h = stamp_bytes(h, &obj->to_a, sizeof(obj->to_a));
+	h = stamp_bytes(h, &obj->to_h, sizeof(obj->to_h));
+	h = stamp_bytes(h, &obj->to_d, sizeof(obj->to_d));
+	h = stamp_bytes(h, &obj->timeout, sizeof(obj->timeout));
+	h = stamp_bytes(h, &obj->notice, sizeof(obj->notice));
+	return stamp_properties(h, obj);
+}
+
+
+/**
+ * Fingerprint what the player knows about objects in general.  An object's
+ * values have to be worked out again if this changes.
+ */
+static uint64_t stamp_knowledge(const struct player *p)
+{
+	uint64_t h = UINT64_C(14695981039346656037);
+	bool flavors = OPT(p, show_flavors);
+
+	h = stamp_bytes(h, &p, sizeof(p));
+	h = stamp_bytes(h, &flavors, sizeof(flavors));
+	return stamp_properties(h, p->obj_k);
+}
+
+
+/**
+ * Fingerprint everything an object's values in the comparison depend on.
+ */
+static uint64_t stamp_entry(const struct object *obj, uint64_t knowledge)
+{
+	uint64_t h = stamp_object(knowledge, obj);
+
+	h = stamp_bytes(h, &obj->kind->aware, sizeof(obj->kind->aware));
+	if (obj->known) {
+		h = stamp_object(h, obj->known);
+	}
+	return h;
+}
+
+
+static void free_index_entry(struct equippable_index_entry *ie)
+{
+	string_free(ie->short_name);
+	mem_free(ie->auxvals);
+	mem_free(ie->vals);
+	mem_free(ie);
+}
+
+
+static void cleanup_index(struct equippable_index *ind)
+{
+	int i;
+
+	if (ind == NULL) {
+		return;
+	}
+	for (i = 0; i < EQUIP_INDEX_SIZE; ++i) {
+		while (ind->buckets[i]) {
+			struct equippable_index_entry *ie = ind->buckets[i];
+
+			ind->buckets[i] = ie->next;
+			free_index_entry(ie);
+		}
+	}
+	mem_free(ind);
+}
+
+
+/**
+ * Get ready to gather the items for the summary:  note what the player now
+ * knows and start a new visit.
+ */
+static void start_index_visit(struct equippable_index **ind,
+	const struct player *p, const struct equippable_summary *s)
+{
+	if (*ind && (*ind)->nprop != s->nprop) {
+		cleanup_index(*ind);
+		*ind = NULL;
+	}
+	if (*ind == NULL) {
+		*ind = mem_zalloc(sizeof(**ind));
+		(*ind)->nprop = s->nprop;
+	}
+	(*ind)->knowledge = stamp_knowledge(p);
+	++(*ind)->visit;
+}
+
+
+/**
+ * Drop the entries for objects that weren't seen when the items were last
+ * gathered; they have left their source, been used up or been changed.
+ */
+static void finish_index_visit(struct equippable_index *ind)
+{
+	int i;
+
+	for (i = 0; i < EQUIP_INDEX_SIZE; ++i) {
+		struct equippable_index_entry **link = &ind->buckets[i];
+
+		while (*link) {
+			struct equippable_index_entry *ie = *link;
+
+			if (ie->visit != ind->visit) {
+				*link = ie->next;
+				free_index_entry(ie);
+			} else {
+				link = &ie->next;
+			}
+		}
+	}
+}
+
+
+/**
+ * Work out an object's values for the comparison.
+ */
+static void compute_index_entry(struct equippable_index_entry *ie,
+	const struct object *obj, const struct player *p,
+	const struct equippable_summary *s)
+{
+	struct cached_object_data *cache = NULL;
+	int i;
+
+	for (i = 0; i < (int)N_ELEMENTS(s->propcats); ++i) {
+		int j;
+
+		for (j = 0; j < s->propcats[i].n; ++j) {
+			compute_ui_entry_values_for_object(
+				s->propcats[i].entries[j], obj, p, &cache,
+				ie->vals + j + s->propcats[i].off,
+				ie->auxvals + j + s->propcats[i].off);
+		}
+	}
+	release_cached_object_data(cache);
+
+	string_free(ie->short_name);
+	ie->short_name = NULL;
+	ie->nshortnm = 0;
+
+	switch (ignore_level_of(obj)) {
+	case IGNORE_GOOD:
+		ie->qual = EQUIP_QUAL_GOOD;
+		break;
+
+	case IGNORE_AVERAGE:
+		ie->qual = EQUIP_QUAL_AVERAGE;
+		break;
+
+	case IGNORE_BAD:
+		ie->qual = EQUIP_QUAL_BAD;
+		break;
+
+	default:
+		/* Try to get some finer distinctions. */
+		if (obj->known && obj->known->artifact) {
+			ie->qual = EQUIP_QUAL_ARTIFACT;
+		} else if (obj->known && obj->known->ego) {
+			ie->qual = EQUIP_QUAL_EGO;
+		} else {
+			/* Treat unknown items as average. */
+			ie->qual = EQUIP_QUAL_AVERAGE;
+		}
+		break;
+	}
+
+	ie->slot = wield_slot(obj);
+	ie->ch = object_char(obj);
+	ie->at = object_attr(obj);
+}
+
+
+/**
+ * Find the entry for an object, working its values out again if it is new
+ * or anything they depend on has changed.
+ */
+static struct equippable_index_entry *lookup_index_entry(
+	struct equippable_index *ind, const struct object *obj,
+	const struct player *p, const struct equippable_summary *s)
+{
+	int bucket = (int)(((uintptr_t)obj / sizeof(*obj)) % EQUIP_INDEX_SIZE);
+	uint64_t stamp = stamp_entry(obj, ind->knowledge);
+	struct equippable_index_entry *ie = ind->buckets[bucket];
+
+	while (ie && ie->obj != obj) {
+		ie = ie->next;
+	}
+	if (!ie) {
+		ie = mem_zalloc(sizeof(*ie));
+		ie->obj = obj;
+		ie->vals = mem_alloc(s->nprop * sizeof(*ie->vals));
+		ie->auxvals = mem_alloc(s->nprop * sizeof(*ie->auxvals));
+		ie->next = ind->buckets[bucket];
+		ind->buckets[bucket] = ie;
+		compute_index_entry(ie, obj, p, s);
+	} else if (ie->stamp != stamp) {
+		compute_index_entry(ie, obj, p, s);
+	}
+	ie->stamp = stamp;
+	ie->visit = ind->visit;
+	if (s->nshortnm > 0 && ie->nshortnm != s->nshortnm) {
+		string_free(ie->short_name);
+		ie->short_name = set_short_name(obj, s->nshortnm, p);
+		ie->nshortnm = s->nshortnm;
+	}
+	return ie;
+}
+
+
 struct add_obj_to_summary_closure {
 	const struct player *p;
 	struct equippable_summary *summary;
@@ -2015,9 +2319,8 @@ struct add_obj_to_summary_closure {
 static void add_obj_to_summary(const struct object *obj, void *closure)
 {
 	struct add_obj_to_summary_closure *c = closure;
+	struct equippable_index_entry *ie;
 	struct equippable *e;
-	struct cached_object_data *cache;
-	int i;
 
 	assert(c->summary->nitems < c->summary->nalloc);
 	e = c->summary->items + c->summary->nitems;
@@ -2030,59 +2333,23 @@ static void add_obj_to_summary(const struct object *obj, void *closure)
 		e->auxvals = mem_alloc(c->summary->nprop *
 			sizeof(*e->auxvals));
 	}
-	cache = NULL;
-	for (i = 0; i < (int)N_ELEMENTS(c->summary->propcats); ++i) {
-		int j;
-
-		for (j = 0; j < c->summary->propcats[i].n; ++j) {
-			compute_ui_entry_values_for_object(
-				c->summary->propcats[i].entries[j], obj,
-				c->p, &cache,
-				e->vals + j + c->summary->propcats[i].off,
-				e->auxvals + j + c->summary->propcats[i].off);
-		}
-	}
-	release_cached_object_data(cache);
+	ie = lookup_index_entry(the_index, obj, c->p, c->summary);
+	memcpy(e->vals, ie->vals, c->summary->nprop * sizeof(*e->vals));
+	memcpy(e->auxvals, ie->auxvals,
+		c->summary->nprop * sizeof(*e->auxvals));
 
 	if (c->summary->nshortnm > 0) {
 		string_free(e->short_name);
-		e->short_name = set_short_name(obj, c->summary->nshortnm,
-			c->p);
+		e->short_name = string_make(ie->short_name);
 		e->nmlen = (int)strlen(e->short_name);
 	}
 
 	e->obj = obj;
 	e->src = c->src;
-
-	switch (ignore_level_of(obj)) {
-	case IGNORE_GOOD:
-		e->qual = EQUIP_QUAL_GOOD;
-		break;
-
-	case IGNORE_AVERAGE:
-		e->qual = EQUIP_QUAL_AVERAGE;
-		break;
-
-	case IGNORE_BAD:
-		e->qual = EQUIP_QUAL_BAD;
-		break;
-
-	default:
-		/* Try to get some finer distinctions. */
-		if (obj->known && obj->known->artifact) {
-			e->qual = EQUIP_QUAL_ARTIFACT;
-		} else if (obj->known && obj->known->ego) {
-			e->qual = EQUIP_QUAL_EGO;
-		} else {
-			/* Treat unknown items as average. */
-			e->qual = EQUIP_QUAL_AVERAGE;
-		}
-		break;
-	}
-
-	e->slot = wield_slot(obj);
-	e->ch = object_char(obj);
-	e->at = object_attr(obj);
+	e->qual = ie->qual;
+	e->slot = ie->slot;
+	e->ch = ie->ch;
+	e->at = ie->at;
 }
 
 
@@ -2575,6 +2842,7 @@ static int initialize_summary(struct player *p,
 		(*s)->nalloc = count;
 	}
 	(*s)->nitems = 0;
+	start_index_visit(&the_index, p, *s);
 	visitor.usefunc = add_obj_to_summary;
 	visitor.usefunc_closure = &add_obj_data;
 	add_obj_data.p = p;
@@ -2599,6 +2867,7 @@ static int initialize_summary(struct player *p,
 	if (store_home(p)) {
 		apply_visitor_to_pile(store_home(p)->stock, &visitor);
 	}
+	finish_index_visit(the_index);
 
 	compute_player_and_equipment_values(p, *s);
 
@@ -2835,6 +3104,8 @@ static void cleanup_ui_equip_cmp(void)
 {
 	cleanup_summary(the_summary);
 	the_summary = NULL;
+	cleanup_index(the_index);
+	the_index = NULL;
 }
 
 
@@ -18,6 +18,7 @@
  */
 
 #include "angband.h"
+#include "cmd-record.h"
 #include "cmds.h"
 #include "datafile.h"
 #include "game-input.h"
@@ -91,6 +92,11 @@ char savefile[1024];
  */
 char panicfile[1024];
 
+/**
+ * Buffer to hold the file to record the player's commands to, if any
+ */
+char arg_record[1024];
+
 /**
  * Set by the front end to perform necessary actions when restarting after death
  * without exiting.  May be NULL.
@@ -290,6 +296,7 @@ struct cmd_info cmd_debug_files[] =
 {
 	{ "Create spoilers", { '"' }, CMD_NULL, do_cmd_spoilers, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
 	{ "Write map", { 'M' }, CMD_WIZ_DUMP_LEVEL_MAP, NULL, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
+	{ "Write performance counters", { 'K' }, CMD_NULL, wiz_dump_profile, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
 };
 
 struct cmd_info cmd_debug_stats[] =
@@ -306,6 +313,8 @@ struct cmd_info cmd_debug_query[] =
 	{ "Square flag", { 'q' }, CMD_WIZ_QUERY_SQUARE_FLAG, NULL, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
 	{ "Noise and scent", { '_' }, CMD_WIZ_PEEK_NOISE_SCENT, NULL, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
 	{ "Keystroke log", { 'L' }, CMD_NULL, wiz_display_keylog, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
+	{ "Monster updates", { 'U' }, CMD_NULL, wiz_display_mon_updates, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
+	{ "Performance counters", { 'k' }, CMD_NULL, wiz_display_profile, player_can_debug_prereq, 0, NULL, NULL, NULL, 0 },
 };
 
 struct cmd_info cmd_debug_misc[] =
@@ -948,16 +957,22 @@ void play_game(enum game_mode_type mode)
 			break;
 		}
 
+		/* Record from here, so the log can be played back from a save */
+		if (arg_record[0] && !cmd_record_start(arg_record)) {
+			msg("Could not record commands to %s.", arg_record);
+		}
+
 		/* Get commands from the user, then process the game world
 		 * until the command queue is empty and a new player command
 		 * is needed */
 		while (!player->is_dead && player->upkeep->playing) {
 			pre_turn_refresh();
-			cmd_get_hook(CTX_GAME);
+			cmd_get_player_command(CTX_GAME);
 			run_game_loop();
 		}
 
 		/* Close game on death or quitting */
+		cmd_record_stop();
 		close_game(true);
 
 		if (!play_again) break;
@@ -57,6 +57,7 @@ struct savefile_details {
 extern bool arg_wizard;
 extern char savefile[1024];
 extern char panicfile[1024];
+extern char arg_record[1024];
 extern void (*reinit_hook)(void);
 
 void cmd_init(void);
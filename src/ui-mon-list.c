@@ -18,6 +18,7 @@
  */
 
 #include "mon-desc.h"
+#include "mon-index.h"
 #include "mon-list.h"
 #include "mon-lore.h"
 #include "mon-util.h"
@@ -374,7 +375,8 @@ void monster_list_show_subwindow(int height, int width)
 {
 	textblock *tb;
 	monster_list_t *list;
-	int i;
+	const int16_t *seen;
+	int i, n;
 
 	if (height < 1 || width < 1)
 		return;
@@ -383,8 +385,10 @@ void monster_list_show_subwindow(int height, int width)
 	list = monster_list_shared_instance();
 
 	/* Force an update if detected monsters */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		if (mflag_has(cave_monster(cave, i)->mflag, MFLAG_MARK)) {
+	n = mon_index_seen(cave, &seen);
+	for (i = 0; i < n; i++) {
+		if (seen[i] < cave_monster_max(cave) &&
+			mflag_has(cave_monster(cave, seen[i])->mflag, MFLAG_MARK)) {
 			list->creation_turn = -1;
 			break;
 		}
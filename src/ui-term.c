@@ -19,9 +19,12 @@
 #include "h-basic.h"
 #include "ui-term.h"
 #include "z-color.h"
+#include "z-profile.h"
 #include "z-util.h"
 #include "z-virt.h"
 
+PROFILE_COUNTER(Term_fresh, "rows");
+
 /**
  * This file provides a generic, efficient, terminal window package,
  * which can be used not only on standard terminal environments such
@@ -1741,6 +1744,8 @@ errr Term_fresh(void)
 	}
 
 
+	PROFILE_START(Term_fresh);
+
 	/* Paranoia -- use "fake" hooks to prevent core dumps */
 	if (!Term->curs_hook) Term->curs_hook = Term_curs_hack;
 	if (!Term->bigcurs_hook) Term->bigcurs_hook = Term->curs_hook;
@@ -1979,6 +1984,7 @@ errr Term_fresh(void)
 
 	/* Actually flush the output */
 	Term_xtra(TERM_XTRA_FRESH, 0);
+	PROFILE_STOP(Term_fresh, (y1 <= y2) ? y2 - y1 + 1 : 0);
 
 	/* Success */
 	return (0);
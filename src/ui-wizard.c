@@ -20,8 +20,10 @@
 #include "angband.h"
 #include "cmds.h"
 #include "game-input.h"
+#include "game-world.h"
 #include "grafmode.h"
 #include "init.h"
+#include "mon-util.h"
 #include "obj-desc.h"
 #include "obj-make.h"
 #include "obj-pile.h"
@@ -30,8 +32,10 @@
 #include "project.h"
 #include "ui-input.h"
 #include "ui-menu.h"
+#include "ui-output.h"
 #include "ui-prefs.h"
 #include "ui-wizard.h"
+#include "z-profile.h"
 
 
 static void proj_display(struct menu *m, int type, bool cursor,
@@ -426,6 +430,56 @@ void wiz_create_item(bool art)
 }
 
 
+/**
+ * Show how many times monster visibility was recalculated last game turn.
+ */
+void wiz_display_mon_updates(void)
+{
+	msg("Monster updates last turn: %d (%d monsters on the level).",
+		monster_update_count(false), cave_monster_count(cave));
+}
+
+
+/**
+ * Show the counts and times for the busiest parts of each game turn.
+ */
+void wiz_display_profile(void)
+{
+	textblock *tb = textblock_new();
+
+	profile_describe(tb);
+	textui_textblock_show(tb, SCREEN_REGION, "Performance counters");
+	textblock_free(tb);
+}
+
+
+/**
+ * Write the counts and times for the busiest parts of each game turn to a
+ * file.
+ */
+void wiz_dump_profile(void)
+{
+	char path[1024] = "";
+	textblock *tb;
+	ang_file *fo;
+
+	if (!get_file("profile.txt", path, sizeof(path))) return;
+	fo = file_open(path, MODE_WRITE, FTYPE_TEXT);
+	if (!fo) {
+		msg("Could not open %s.", path);
+		return;
+	}
+	tb = textblock_new();
+	file_putf(fo, "Performance counters at game turn %ld\n\n", (long) turn);
+	profile_describe(tb);
+	textblock_to_file(tb, fo, 0, 80);
+	textblock_free(tb);
+	if (file_close(fo)) {
+		msg("Performance counters written to %s.", path);
+	}
+}
+
+
 /**
  * Confirm before quitting without a save.
  */
@@ -44,6 +44,7 @@
 #include "player-quest.h"
 #include "ui-command.h"
 #include "wizard.h"
+#include "z-profile.h"
 #include <math.h>
 
 /**
@@ -3095,6 +3096,14 @@ static void add_to_grid_count_aggregate(struct grid_count_aggregate *ga,
 	}
 }
 
+/**
+ * The reasons level builds failed, and how often for each type of level
+ */
+struct cgen_failure {
+	char *reason;
+	uint32_t *counts;
+};
+
 struct cgen_stats {
 	/*
 	 * This is effectively a 2 x z_info->profile_max array where
@@ -3154,6 +3163,37 @@ struct cgen_stats {
 	 * player is disconnected from all down staircases.
 	 */
 	uint32_t *disdstair_counts;
+	/*
+	 * This is effectively a z_info->profile_max x phase_count array where
+	 * phase_times[i][j] has the results for the time, in milliseconds,
+	 * spent in the jth phase by successful levels of the ith type.
+	 */
+	struct d_sum_sum2 **phase_times;
+	/*
+	 * level_times[i] has the results for the total time, in milliseconds,
+	 * taken by successful levels of the ith type; fail_times[i] is the
+	 * total time taken by failed attempts at levels of the ith type.
+	 */
+	struct d_sum_sum2 *level_times;
+	double *fail_times;
+	/*
+	 * These time the phases of the current level by the wall clock:  it
+	 * is in phase curr_phase, which it entered at phase_clock (in
+	 * nanoseconds), and has spent curr_phase_time[j] milliseconds in
+	 * phase j so far.
+	 */
+	double *curr_phase_time;
+	int curr_phase;
+	uint64_t phase_clock;
+	/*
+	 * retries has the results for the number of failed attempts before
+	 * each successful level; curr_retries counts them for the current one.
+	 */
+	struct i_sum_sum2 retries;
+	int curr_retries;
+	/* Are the reasons for failed levels, in the order first seen. */
+	struct cgen_failure *failures;
+	int n_failures, alloc_failures;
 	/* Is the number of successfully generated levels. */
 	int nsuccess;
 	/* Is the number of failed levels. */
@@ -3167,8 +3207,28 @@ struct cgen_stats {
 	 * get_room_builder_count().
 	 */
 	int room_type_count;
+	/*
+	 * Is the number of phases of level building; caches the result of
+	 * get_level_phase_count().
+	 */
+	int phase_count;
 };
 
+/**
+ * Add the time since the current level entered its current phase to the
+ * time it has spent in that phase.
+ */
+static void cgenstat_end_phase(struct cgen_stats *gs)
+{
+	uint64_t now = profile_now();
+
+	if (gs->curr_phase >= 0) {
+		gs->curr_phase_time[gs->curr_phase] +=
+			(now - gs->phase_clock) / 1e6;
+	}
+	gs->phase_clock = now;
+}
+
 static void cgenstat_handle_new_level(game_event_type et, game_event_data *ed,
 		void *ud)
 {
@@ -3187,6 +3247,73 @@ static void cgenstat_handle_new_level(game_event_type et, game_event_data *ed,
 		gs->curr_room_counts[1][i] = 0;
 	}
 	gs->n_curr_tunn = 0;
+
+	/* Start timing, in the first phase. */
+	for (i = 0; i < gs->phase_count; ++i) {
+		gs->curr_phase_time[i] = 0.0;
+	}
+	gs->curr_phase = 0;
+	gs->phase_clock = profile_now();
+}
+
+static void cgenstat_handle_phase(game_event_type et, game_event_data *ed,
+		void *ud)
+{
+	struct cgen_stats *gs;
+
+	assert(et == EVENT_GEN_LEVEL_PHASE && ud);
+	gs = (struct cgen_stats*) ud;
+	cgenstat_end_phase(gs);
+	gs->curr_phase = (ed->string) ?
+		get_level_phase_index_from_name(ed->string) : -1;
+	assert(gs->curr_phase >= 0 && gs->curr_phase < gs->phase_count);
+}
+
+static void cgenstat_handle_level_fail(game_event_type et,
+		game_event_data *ed, void *ud)
+{
+	struct cgen_stats *gs;
+	const char *reason;
+	int i;
+
+	assert(et == EVENT_GEN_LEVEL_FAIL && ud);
+	gs = (struct cgen_stats*) ud;
+	assert(gs->level_type >= 0 && gs->level_type < z_info->profile_max);
+	reason = (ed->string) ? ed->string : "unknown";
+
+	/* Count the reason, adding it if it's new. */
+	for (i = 0; i < gs->n_failures; ++i) {
+		if (streq(gs->failures[i].reason, reason)) break;
+	}
+	if (i == gs->n_failures) {
+		if (gs->n_failures == gs->alloc_failures) {
+			gs->alloc_failures = (gs->alloc_failures) ?
+				gs->alloc_failures + gs->alloc_failures : 8;
+			gs->failures = mem_realloc(gs->failures,
+				gs->alloc_failures * sizeof(*gs->failures));
+		}
+		gs->failures[i].reason = string_make(reason);
+		gs->failures[i].counts = mem_zalloc(z_info->profile_max *
+			sizeof(*gs->failures[i].counts));
+		++gs->n_failures;
+	}
+	++gs->failures[i].counts[gs->level_type];
+}
+
+static void cgenstat_handle_level_guessed(game_event_type et,
+		game_event_data *ed, void *ud)
+{
+	struct cgen_stats *gs;
+
+	assert(et == EVENT_GEN_LEVEL_GUESSED && ud);
+	gs = (struct cgen_stats*) ud;
+
+	/*
+	 * Stop timing, but keep what was counted in case the level is used
+	 * and the end of it signalled later.
+	 */
+	cgenstat_end_phase(gs);
+	gs->curr_phase = -1;
 }
 
 static void cgenstat_handle_level_end(game_event_type et, game_event_data *ed,
@@ -3194,14 +3321,34 @@ static void cgenstat_handle_level_end(game_event_type et, game_event_data *ed,
 {
 	struct cgen_stats *gs;
 
+	double total = 0.0;
+	int j;
+
 	assert(et == EVENT_GEN_LEVEL_END && ud);
 	gs = (struct cgen_stats*) ud;
 	assert(gs->level_type >= 0 && gs->level_type < z_info->profile_max);
+
+	/* Finish timing. */
+	cgenstat_end_phase(gs);
+	gs->curr_phase = -1;
+	for (j = 0; j < gs->phase_count; ++j) {
+		total += gs->curr_phase_time[j];
+	}
+
 	if (ed->flag) {
 		int room_count = 0;
 		struct grid_counts gcounts[3];
 		int i;
 
+		/* Record the time taken and the attempts it took. */
+		for (j = 0; j < gs->phase_count; ++j) {
+			add_to_d_sum_sum2(&gs->phase_times[gs->level_type][j],
+				gs->curr_phase_time[j]);
+		}
+		add_to_d_sum_sum2(&gs->level_times[gs->level_type], total);
+		add_to_i_sum_sum2(&gs->retries, gs->curr_retries);
+		gs->curr_retries = 0;
+
 		/* Successfully created.  Transfer room counts. */
 		for (i = 0; i < gs->room_type_count; ++i) {
 			add_to_i_sum_sum2(
@@ -3232,9 +3379,11 @@ static void cgenstat_handle_level_end(game_event_type et, game_event_data *ed,
 		++gs->level_counts[0][gs->level_type];
 		++gs->nsuccess;
 	} else {
-		/* Creation failed.  Update level failure count. */
+		/* Creation failed.  Update level failure count and time. */
 		++gs->level_counts[1][gs->level_type];
 		++gs->nfail;
+		gs->fail_times[gs->level_type] += total;
+		++gs->curr_retries;
 	}
 }
 
@@ -3300,6 +3449,7 @@ static void initialize_generation_stats(struct cgen_stats *gs)
 	gs->level_type = -1;
 	gs->room_type = -1;
 	gs->room_type_count = get_room_builder_count();
+	gs->phase_count = get_level_phase_count();
 
 	gs->level_counts[0] = mem_zalloc(z_info->profile_max *
 		sizeof(*gs->level_counts[0]));
@@ -3341,6 +3491,36 @@ static void initialize_generation_stats(struct cgen_stats *gs)
 	gs->n_curr_tunn = 0;
 	gs->alloc_curr_tunn = 0;
 
+	gs->phase_times = mem_alloc(z_info->profile_max *
+		sizeof(*gs->phase_times));
+	for (i = 0; i < z_info->profile_max; ++i) {
+		int j;
+
+		gs->phase_times[i] = mem_alloc(gs->phase_count *
+			sizeof(*gs->phase_times[i]));
+		for (j = 0; j < gs->phase_count; ++j) {
+			initialize_d_sum_sum2(&gs->phase_times[i][j]);
+		}
+	}
+	gs->level_times = mem_alloc(z_info->profile_max *
+		sizeof(*gs->level_times));
+	for (i = 0; i < z_info->profile_max; ++i) {
+		initialize_d_sum_sum2(&gs->level_times[i]);
+	}
+	gs->fail_times = mem_zalloc(z_info->profile_max *
+		sizeof(*gs->fail_times));
+	gs->curr_phase_time = mem_zalloc(gs->phase_count *
+		sizeof(*gs->curr_phase_time));
+	gs->curr_phase = -1;
+	gs->phase_clock = profile_now();
+	gs->retries.sum = 0;
+	gs->retries.sum2_lo = 0;
+	gs->retries.sum2_hi = 0;
+	gs->curr_retries = 0;
+	gs->failures = NULL;
+	gs->n_failures = 0;
+	gs->alloc_failures = 0;
+
 	gs->badst_counts = mem_zalloc(z_info->profile_max *
 		sizeof(*gs->badst_counts));
 	gs->disarea_counts = mem_zalloc(z_info->profile_max *
@@ -3349,7 +3529,11 @@ static void initialize_generation_stats(struct cgen_stats *gs)
 		sizeof(*gs->disdstair_counts));
 
 	event_add_handler(EVENT_GEN_LEVEL_START, cgenstat_handle_new_level, gs);
+	event_add_handler(EVENT_GEN_LEVEL_PHASE, cgenstat_handle_phase, gs);
+	event_add_handler(EVENT_GEN_LEVEL_FAIL, cgenstat_handle_level_fail, gs);
 	event_add_handler(EVENT_GEN_LEVEL_END, cgenstat_handle_level_end, gs);
+	event_add_handler(EVENT_GEN_LEVEL_GUESSED,
+		cgenstat_handle_level_guessed, gs);
 	event_add_handler(EVENT_GEN_ROOM_START, cgenstat_handle_new_room, gs);
 	event_add_handler(EVENT_GEN_ROOM_END, cgenstat_handle_room_end, gs);
 	event_add_handler(EVENT_GEN_TUNNEL_FINISHED, cgenstat_handle_tunnel, gs);
@@ -3361,8 +3545,14 @@ static void cleanup_generation_stats(struct cgen_stats *gs)
 
 	event_remove_handler(EVENT_GEN_LEVEL_START,
 		cgenstat_handle_new_level, gs);
+	event_remove_handler(EVENT_GEN_LEVEL_PHASE,
+		cgenstat_handle_phase, gs);
+	event_remove_handler(EVENT_GEN_LEVEL_FAIL,
+		cgenstat_handle_level_fail, gs);
 	event_remove_handler(EVENT_GEN_LEVEL_END,
 		cgenstat_handle_level_end, gs);
+	event_remove_handler(EVENT_GEN_LEVEL_GUESSED,
+		cgenstat_handle_level_guessed, gs);
 	event_remove_handler(EVENT_GEN_ROOM_START,
 		cgenstat_handle_new_room, gs);
 	event_remove_handler(EVENT_GEN_ROOM_END,
@@ -3374,6 +3564,19 @@ static void cleanup_generation_stats(struct cgen_stats *gs)
 	mem_free(gs->disarea_counts);
 	mem_free(gs->badst_counts);
 
+	for (i = 0; i < gs->n_failures; ++i) {
+		string_free(gs->failures[i].reason);
+		mem_free(gs->failures[i].counts);
+	}
+	mem_free(gs->failures);
+	mem_free(gs->curr_phase_time);
+	mem_free(gs->fail_times);
+	mem_free(gs->level_times);
+	for (i = 0; i < z_info->profile_max; ++i) {
+		mem_free(gs->phase_times[i]);
+	}
+	mem_free(gs->phase_times);
+
 	mem_free(gs->curr_tunn);
 
 	mem_free(gs->curr_room_counts[1]);
@@ -3419,6 +3622,38 @@ static void dump_generation_stats(ang_file *fo, const struct cgen_stats *gs)
 	}
 	file_put(fo, "\n");
 
+	file_put(fo, "Mean and Std. Deviation of Failed Attempts Per Successful Level::\n");
+	file_putf(fo, "%.4f\t%.4f\n\n",
+		(gs->nsuccess > 0) ?
+			(double) gs->retries.sum / gs->nsuccess : 0.0,
+		stddev_i_sum_sum2(gs->retries, gs->nsuccess));
+
+	file_put(fo, "Level Builder Mean and Std. Deviation of msec Per Successful Level, and msec Lost to Failures Per Successful Level::\n");
+	for (i = 0; i < z_info->profile_max; ++i) {
+		uint32_t n = gs->level_counts[0][i];
+
+		file_putf(fo, "\"%s\"\t%.4f\t%.4f\t%.4f\n",
+			get_level_profile_name_from_index(i),
+			(n > 0) ? gs->level_times[i].sum / n : 0.0,
+			stddev_d_sum_sum2(gs->level_times[i], n),
+			(n > 0) ? gs->fail_times[i] / n : gs->fail_times[i]);
+	}
+	file_put(fo, "\n");
+
+	file_put(fo, "Level Builder Failure Reasons::\n");
+	for (i = 0; i < gs->n_failures; ++i) {
+		int j;
+
+		for (j = 0; j < z_info->profile_max; ++j) {
+			if (!gs->failures[i].counts[j]) continue;
+			file_putf(fo, "\"%s\"\t\"%s\"\t%lu\n",
+				get_level_profile_name_from_index(j),
+				gs->failures[i].reason,
+				(unsigned long) gs->failures[i].counts[j]);
+		}
+	}
+	file_put(fo, "\n");
+
 	file_put(fo, "Average and Std. Deviation of Room Counts by Level Type::\n");
 	for (i = 0; i < z_info->profile_max; ++i) {
 		file_putf(fo, "\"%s\"\t%.4f\t%.4f\n",
@@ -3440,6 +3675,17 @@ static void dump_generation_stats(ang_file *fo, const struct cgen_stats *gs)
 
 		name = get_level_profile_name_from_index(i);
 
+		file_putf(fo, "\"%s\" Mean and Std. Deviation of msec Per Phase::\n", name);
+		for (j = 0; j < gs->phase_count; ++j) {
+			file_putf(fo, "\"%s\"\t%.4f\t%.4f\n",
+				get_level_phase_name_from_index(j),
+				gs->phase_times[i][j].sum /
+					gs->level_counts[0][i],
+				stddev_d_sum_sum2(gs->phase_times[i][j],
+					gs->level_counts[0][i]));
+		}
+		file_put(fo, "\n");
+
 		file_putf(fo, "\"%s\" Mean and Std. Deviation For Room Counts::\n", name);
 		for (j = 0; j < gs->room_type_count; ++j) {
 			file_putf(fo, "\"%s\"\t%.4f\t%.4f\n",
@@ -3671,6 +3917,38 @@ static void dump_generation_stats(ang_file *fo, const struct cgen_stats *gs)
 	}
 }
 
+/**
+ * Whether a grid is one the player could get through, for
+ * disconnect_stats(): impassable terrain which isn't a door or rubble blocks
+ * progress, as does the edge of the level
+ */
+static bool square_isstatsopen(struct chunk *c, struct loc grid)
+{
+	return square_in_bounds_fully(c, grid) && (square_ispassable(c, grid)
+		|| square_isdoor(c, grid) || square_isrubble(c, grid));
+}
+
+/**
+ * Mark the regions the player can get to; if the player is somewhere they
+ * can't go, that is the regions next to them
+ */
+static void mark_reachable(struct region_labels *regions, bool *reach)
+{
+	int d;
+
+	if (square_isstatsopen(cave, player->grid)) {
+		reach[region_of(regions, player->grid)] = true;
+		return;
+	}
+	for (d = 0; d < 8; d++) {
+		struct loc adj = loc_sum(player->grid, ddgrid_ddd[d]);
+
+		if (square_isstatsopen(cave, adj)) {
+			reach[region_of(regions, adj)] = true;
+		}
+	}
+}
+
 /**
  * Gather whether the dungeon has disconnects in it and whether the player
  * is disconnected from the stairs
@@ -3679,6 +3957,8 @@ void disconnect_stats(int nsim, bool stop_on_disconnect)
 {
 	int i, y, x;
 	int **cave_dist;
+	struct region_labels *regions;
+	bool *reach;
 	long bad_starts = 0, dsc_area = 0, dsc_from_stairs = 0;
 	char path[1024];
 	ang_file *disfile;
@@ -3819,18 +4099,10 @@ void disconnect_stats(int nsim, bool stop_on_disconnect)
 		/* Make a new cave */
 		prepare_next_level(player);
 
-		/* Allocate the distance array */
-		cave_dist = mem_zalloc(cave->height * sizeof(int*));
-		for (y = 0; y < cave->height; y++)
-			cave_dist[y] = mem_zalloc(cave->width * sizeof(int));
-
-		/* Set all cave spots to inaccessible */
-		for (y = 0; y < cave->height; y++)
-			for (x = 1; x < cave->width; x++)
-				cave_dist[y][x] = -1;
-
-		/* Fill the distance array with the correct distances */
-		calc_cave_distances(cave_dist);
+		/* Find what the player can get to */
+		regions = label_regions(cave, square_isstatsopen, true);
+		reach = mem_zalloc((regions->num + 1) * sizeof(*reach));
+		mark_reachable(regions, reach);
 
 		/* Cycle through the dungeon */
 		for (y = 1; y < cave->height - 1; y++) {
@@ -3847,15 +4119,13 @@ void disconnect_stats(int nsim, bool stop_on_disconnect)
 					!square_isrubble(cave, grid)) continue;
 
 				/* Can we get there? */
-				if (cave_dist[y][x] >= 0) {
+				if (reach[region_of(regions, grid)]) {
 
 					/* Is it a stairs? */
 					if (square_isstairs(cave, grid)||square_ispath(cave, grid)){
 
 						has_dsc_from_stairs = false;
 
-						/* debug
-						msg("dist to stairs: %d",cave_dist[y][x]); */
 					}
 					continue;
 				}
@@ -3925,16 +4195,28 @@ void disconnect_stats(int nsim, bool stop_on_disconnect)
 						" All Downstairs Inaccessible",
 						sizeof(label));
 				}
+				/* Work out the distances to show */
+				cave_dist = mem_zalloc(cave->height *
+					sizeof(int*));
+				for (y = 0; y < cave->height; y++) {
+					cave_dist[y] = mem_zalloc(cave->width *
+						sizeof(int));
+					for (x = 1; x < cave->width; x++)
+						cave_dist[y][x] = -1;
+				}
+				calc_cave_distances(cave_dist);
+
 				dump_level_body(disfile, label, cave,
 					cave_dist);
+
+				for (y = 0; y < cave->height; y++)
+					mem_free(cave_dist[y]);
+				mem_free(cave_dist);
 			}
 			if (stop_on_disconnect) running = false;
 		}
 
-		/* Free arrays */
-		for (y = 0; y < cave->height; y++)
-			mem_free(cave_dist[y]);
-		mem_free(cave_dist);
+		mem_free(reach);
 
 		if (check_break(true, 0)) {
 			running = false;
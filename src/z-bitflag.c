@@ -20,358 +20,18 @@
 
 
 /**
- * Tests if a flag is "on" in a bitflag set.
- *
- * true is returned when `flag` is on in `flags`, and false otherwise.
- * The flagset size is supplied in `size`.
- */
-bool flag_has(const bitflag *flags, const size_t size, const int flag)
-{
-	const size_t flag_offset = FLAG_OFFSET(flag);
-	const int flag_binary = FLAG_BINARY(flag);
-
-	if (flag == FLAG_END) return false;
-
-	assert(flag_offset < size);
-
-	if (flags[flag_offset] & flag_binary) return true;
-
-	return false;
-}
-
-#ifndef NDEBUG
-bool flag_has_dbg(const bitflag *flags, const size_t size, const int flag,
-				  const char *fi, const char *fl)
-{
-	const size_t flag_offset = FLAG_OFFSET(flag);
-	const int flag_binary = FLAG_BINARY(flag);
-
-	if (flag == FLAG_END) return false;
-
-	if (flag_offset >= size) {
-		quit_fmt("Error in flag_has(%s, %s): FlagID[%d] Size[%u] FlagOff[%u] FlagBV[%d]\n",
-		         fi, fl, flag, (unsigned int) size, (unsigned int) flag_offset, flag_binary);
-	}
-
-	if (flags[flag_offset] & flag_binary) return true;
-
-	return false;
-}
-#endif
-
-/**
- * Iterates over the flags which are "on" in a bitflag set.
- *
- * Returns the next on flag in `flags`, starting from (and including)
- * `flag`. FLAG_END will be returned when the end of the flag set is reached.
- * Iteration will start at the beginning of the flag set when `flag` is
- * FLAG_END. The bitfield size is supplied in `size`.
- */
-int flag_next(const bitflag *flags, const size_t size, const int flag)
-{
-	const int max_flags = FLAG_MAX(size);
-	int f, flag_offset, flag_binary;
-
-	for (f = flag; f < max_flags; f++) {
-		flag_offset = FLAG_OFFSET(f);
-		flag_binary = FLAG_BINARY(f);
-
-		if (flags[flag_offset] & flag_binary) return f;
-	}
-
-	return FLAG_END;
-}
-
-
-/**
- * Counts the flags which are "on" in a bitflag set.
- *
- * The bitfield size is supplied in `size`.
+ * Stops the game when a flag is out of range for its set; the checking
+ * versions of flag_has() and flag_on() use this to say where it happened.
  */
-int flag_count(const bitflag *flags, const size_t size)
+void flag_bounds_error(const char *func, const char *fi, const char *fl,
+					   const int flag, const size_t size)
 {
-	size_t i, j;
-	int count = 0;
-
-	for (i = 0; i < size; i++) {
-		for (j = 1; j <= FLAG_WIDTH; j++) {
-			if (flags[i] & FLAG_BINARY(j)) {
-				count++;
-			}
-		}
-	}
-
-	return count;
+	quit_fmt("Error in %s(%s, %s): FlagID[%d] Size[%u] FlagOff[%u] FlagBV[%d]\n",
+	         func, fi, fl, flag, (unsigned int) size,
+	         (unsigned int) FLAG_OFFSET(flag), FLAG_BINARY(flag));
 }
 
 
-/**
- * Tests a bitfield for emptiness.
- *
- * true is returned when no flags are set in `flags`, and false otherwise.
- * The bitfield size is supplied in `size`.
- */
-bool flag_is_empty(const bitflag *flags, const size_t size)
-{
-	size_t i;
-
-	for (i = 0; i < size; i++)
-		if (flags[i] > 0) return false;
-
-	return true;
-}
-
-
-/**
- * Tests a bitfield for fullness.
- *
- * true is returned when all flags are set in `flags`, and false otherwise.
- * The bitfield size is supplied in `size`.
- */
-bool flag_is_full(const bitflag *flags, const size_t size)
-{
-	size_t i;
-
-	for (i = 0; i < size; i++)
-		if (flags[i] != (bitflag) -1) return false;
-
-	return true;
-}
-
-
-/**
- * Tests two bitfields for intersection.
- *
- * true is returned when any flag is set in both `flags1` and `flags2`, and
- * false otherwise. The size of the bitfields is supplied in `size`.
- */
-bool flag_is_inter(const bitflag *flags1, const bitflag *flags2,
-				   const size_t size)
-{
-	size_t i;
-
-	for (i = 0; i < size; i++)
-		if (flags1[i] & flags2[i]) return true;
-
-	return false;
-}
-
-
-/**
- * Test if one bitfield is a subset of another.
- *
- * true is returned when every set flag in `flags2` is also set in `flags1`,
- * and false otherwise. The size of the bitfields is supplied in `size`.
- */
-bool flag_is_subset(const bitflag *flags1, const bitflag *flags2,
-					const size_t size)
-{
-	size_t i;
-
-	for (i = 0; i < size; i++)
-		if (~flags1[i] & flags2[i]) return false;
-
-	return true;
-}
-
-
-/**
- * Tests two bitfields for equality.
- *
- * true is returned when the flags set in `flags1` and `flags2` are identical,
- * and false otherwise. the size of the bitfields is supplied in `size`.
- */
-bool flag_is_equal(const bitflag *flags1, const bitflag *flags2,
-				   const size_t size)
-{
-	return (!memcmp(flags1, flags2, size * sizeof(bitflag)));
-}
-
-
-/**
- * Sets one bitflag in a bitfield.
- *
- * The bitflag identified by `flag` is set in `flags`. The bitfield size is
- * supplied in `size`.  true is returned when changes were made, false
- * otherwise.
- */
-bool flag_on(bitflag *flags, const size_t size, const int flag)
-{
-	const size_t flag_offset = FLAG_OFFSET(flag);
-	const int flag_binary = FLAG_BINARY(flag);
-
-	assert(flag_offset < size);
-
-	if (flags[flag_offset] & flag_binary) return false;
-
-	flags[flag_offset] |= flag_binary;
-
-	return true;
-}
-
-#ifndef NDEBUG
-bool flag_on_dbg(bitflag *flags, const size_t size, const int flag,
-				 const char *fi, const char *fl)
-{
-	const size_t flag_offset = FLAG_OFFSET(flag);
-	const int flag_binary = FLAG_BINARY(flag);
-
-	if (flag_offset >= size) {
-		quit_fmt("Error in flag_on(%s, %s): FlagID[%d] Size[%u] FlagOff[%u] FlagBV[%d]\n",
-		         fi, fl, flag, (unsigned int) size, (unsigned int) flag_offset, flag_binary);
-	}
-
-	if (flags[flag_offset] & flag_binary) return false;
-
-	flags[flag_offset] |= flag_binary;
-
-	return true;
-}
-#endif
-
-/**
- * Clears one flag in a bitfield.
- *
- * The bitflag identified by `flag` is cleared in `flags`. The bitfield size
- * is supplied in `size`.  true is returned when changes were made, false
- * otherwise.
- */
-bool flag_off(bitflag *flags, const size_t size, const int flag)
-{
-	const size_t flag_offset = FLAG_OFFSET(flag);
-	const int flag_binary = FLAG_BINARY(flag);
-
-	assert(flag_offset < size);
-
-	if (!(flags[flag_offset] & flag_binary)) return false;
-
-	flags[flag_offset] &= ~flag_binary;
-
-	return true;
-}
-
-
-/**
- * Clears all flags in a bitfield.
- *
- * All flags in `flags` are cleared. The bitfield size is supplied in `size`.
- */
-void flag_wipe(bitflag *flags, const size_t size)
-{
-	memset(flags, 0, size * sizeof(bitflag));
-}
-
-
-/**
- * Sets all flags in a bitfield.
- *
- * All flags in `flags` are set. The bitfield size is supplied in `size`.
- */
-void flag_setall(bitflag *flags, const size_t size)
-{
-	memset(flags, 255, size * sizeof(bitflag));
-}
-
-
-/**
- * Negates all flags in a bitfield.
- *
- * All flags in `flags` are toggled. The bitfield size is supplied in `size`.
- */
-void flag_negate(bitflag *flags, const size_t size)
-{
-	size_t i;
-	
-	for (i = 0; i < size; i++)
-		flags[i] = ~flags[i];
-}
-
-
-/**
- * Copies one bitfield into another.
- *
- * All flags in `flags2` are copied into `flags1`. The size of the bitfields is
- * supplied in `size`.
- */
-void flag_copy(bitflag *flags1, const bitflag *flags2, const size_t size)
-{
-	memcpy(flags1, flags2, size * sizeof(bitflag));
-}
-
-
-/**
- * Computes the union of two bitfields.
- *
- * For every set flag in `flags2`, the corresponding flag is set in `flags1`.
- * The size of the bitfields is supplied in `size`. true is returned when
- * changes were made, and false otherwise.
- */
-bool flag_union(bitflag *flags1, const bitflag *flags2, const size_t size)
-{
-	size_t i;
-	bool delta = false;
-
-	for (i = 0; i < size; i++) {
-		/* !flag_is_subset() */
-		if (~flags1[i] & flags2[i]) delta = true;
-
-		flags1[i] |= flags2[i];
-	}
-
-	return delta;
-}
-
-
-/**
- * Computes the intersection of two bitfields.
- *
- * For every unset flag in `flags2`, the corresponding flag is cleared in
- * `flags1`. The size of the bitfields is supplied in `size`. true is returned
- * when changes were made, and false otherwise.
- */
-bool flag_inter(bitflag *flags1, const bitflag *flags2, const size_t size)
-{
-	size_t i;
-	bool delta = false;
-
-	for (i = 0; i < size; i++) {
-		/* !flag_is_equal() */
-		if (!(flags1[i] == flags2[i])) delta = true;
-
-		flags1[i] &= flags2[i];
-	}
-
-	return delta;
-
-}
-
-
-/**
- * Computes the difference of two bitfields.
- *
- * For every set flag in `flags2`, the corresponding flag is cleared in
- * `flags1`. The size of the bitfields is supplied in `size`. true is returned
- * when changes were made, and false otherwise.
- */
-bool flag_diff(bitflag *flags1, const bitflag *flags2, const size_t size)
-{
-	size_t i;
-	bool delta = false;
-
-	for (i = 0; i < size; i++) {
-		/* flag_is_inter() */
-		if (flags1[i] & flags2[i]) delta = true;
-
-		flags1[i] &= ~flags2[i];
-	}
-
-	return delta;
-}
-
-
-
-
-
 /**
  * Tests if any of multiple bitflags are set in a bitfield.
  *
@@ -59,26 +59,388 @@ typedef uint8_t bitflag;
 #define FLAG_BINARY(id)   (1 << ((id) - FLAG_START) % FLAG_WIDTH)
 
 
-bool flag_has       (const bitflag *flags, const size_t size, const int flag);
-int  flag_next      (const bitflag *flags, const size_t size, const int flag);
-int  flag_count     (const bitflag *flags, const size_t size);
-bool flag_is_empty  (const bitflag *flags, const size_t size);
-bool flag_is_full   (const bitflag *flags, const size_t size);
-bool flag_is_inter  (const bitflag *flags1, const bitflag *flags2,
-					 const size_t size);
-bool flag_is_subset (const bitflag *flags1, const bitflag *flags2,
-					 const size_t size);
-bool flag_is_equal  (const bitflag *flags1, const bitflag *flags2,
-					 const size_t size);
-bool flag_on        (bitflag *flags, const size_t size, const int flag);
-bool flag_off       (bitflag *flags, const size_t size, const int flag);
-void flag_wipe      (bitflag *flags, const size_t size);
-void flag_setall    (bitflag *flags, const size_t size);
-void flag_negate    (bitflag *flags, const size_t size);
-void flag_copy      (bitflag *flags1, const bitflag *flags2, const size_t size);
-bool flag_union     (bitflag *flags1, const bitflag *flags2, const size_t size);
-bool flag_inter     (bitflag *flags1, const bitflag *flags2, const size_t size);
-bool flag_diff      (bitflag *flags1, const bitflag *flags2, const size_t size);
+/**
+ * Flag sets are stored a byte at a time, which is how they are laid out in
+ * savefiles, but the operations below work on them a word at a time where
+ * they can.  They are all inline so that with the size of the set known at
+ * compile time (as it is for of_has() and the like) they reduce to a few
+ * instructions.
+ */
+typedef uint64_t flag_word;
+#define FLAG_WORD_SIZE    sizeof(flag_word)
+
+static inline flag_word flag_word_get(const bitflag *flags)
+{
+	flag_word w;
+
+	memcpy(&w, flags, sizeof(w));
+	return w;
+}
+
+static inline void flag_word_put(bitflag *flags, flag_word w)
+{
+	memcpy(flags, &w, sizeof(w));
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define flag_word_count(w)   __builtin_popcountll(w)
+#define flag_byte_first(b)   __builtin_ctz(b)
+#else
+static inline int flag_word_count(flag_word w)
+{
+	w = w - ((w >> 1) & 0x5555555555555555ULL);
+	w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+	w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (int) ((w * 0x0101010101010101ULL) >> 56);
+}
+
+static inline int flag_byte_first(unsigned int b)
+{
+	int n = 0;
+
+	while (!(b & 1)) {
+		b >>= 1;
+		n++;
+	}
+	return n;
+}
+#endif
+
+void flag_bounds_error(const char *func, const char *fi, const char *fl,
+					   const int flag, const size_t size);
+
+/**
+ * Tests if a flag is "on" in a bitflag set.
+ *
+ * true is returned when `flag` is on in `flags`, and false otherwise.
+ * The flagset size is supplied in `size`.
+ */
+static inline bool flag_has(const bitflag *flags, const size_t size,
+							const int flag)
+{
+	const size_t flag_offset = FLAG_OFFSET(flag);
+
+	if (flag == FLAG_END) return false;
+
+	assert(flag_offset < size);
+
+	return (flags[flag_offset] & FLAG_BINARY(flag)) != 0;
+}
+
+/**
+ * Iterates over the flags which are "on" in a bitflag set.
+ *
+ * Returns the next on flag in `flags`, starting from (and including)
+ * `flag`. FLAG_END will be returned when the end of the flag set is reached.
+ * Iteration will start at the beginning of the flag set when `flag` is
+ * FLAG_END. The bitfield size is supplied in `size`.
+ */
+static inline int flag_next(const bitflag *flags, const size_t size,
+							const int flag)
+{
+	int f = (flag < FLAG_START) ? FLAG_START : flag;
+	size_t i;
+	unsigned int rest;
+
+	if (f >= FLAG_MAX(size)) return FLAG_END;
+
+	/* The rest of the byte holding the first flag */
+	i = FLAG_OFFSET(f);
+	rest = flags[i] & (0xFFu << ((f - FLAG_START) % FLAG_WIDTH));
+	if (rest) return FLAG_START + (int) (i * FLAG_WIDTH) + flag_byte_first(rest);
+
+	/* Skip empty words, then find the first byte with anything in it */
+	for (i++; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (flag_word_get(flags + i)) break;
+	for (; i < size; i++)
+		if (flags[i])
+			return FLAG_START + (int) (i * FLAG_WIDTH)
+				+ flag_byte_first(flags[i]);
+
+	return FLAG_END;
+}
+
+/**
+ * Counts the flags which are "on" in a bitflag set.
+ *
+ * The bitfield size is supplied in `size`.
+ */
+static inline int flag_count(const bitflag *flags, const size_t size)
+{
+	size_t i = 0;
+	int count = 0;
+
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		count += flag_word_count(flag_word_get(flags + i));
+	for (; i < size; i++)
+		count += flag_word_count(flags[i]);
+
+	return count;
+}
+
+/**
+ * Tests a bitfield for emptiness.
+ *
+ * true is returned when no flags are set in `flags`, and false otherwise.
+ * The bitfield size is supplied in `size`.
+ */
+static inline bool flag_is_empty(const bitflag *flags, const size_t size)
+{
+	size_t i = 0;
+
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (flag_word_get(flags + i)) return false;
+	for (; i < size; i++)
+		if (flags[i]) return false;
+
+	return true;
+}
+
+/**
+ * Tests a bitfield for fullness.
+ *
+ * true is returned when all flags are set in `flags`, and false otherwise.
+ * The bitfield size is supplied in `size`.
+ */
+static inline bool flag_is_full(const bitflag *flags, const size_t size)
+{
+	size_t i = 0;
+
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (flag_word_get(flags + i) != (flag_word) -1) return false;
+	for (; i < size; i++)
+		if (flags[i] != (bitflag) -1) return false;
+
+	return true;
+}
+
+/**
+ * Tests two bitfields for intersection.
+ *
+ * true is returned when any flag is set in both `flags1` and `flags2`, and
+ * false otherwise. The size of the bitfields is supplied in `size`.
+ */
+static inline bool flag_is_inter(const bitflag *flags1, const bitflag *flags2,
+								 const size_t size)
+{
+	size_t i = 0;
+
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (flag_word_get(flags1 + i) & flag_word_get(flags2 + i))
+			return true;
+	for (; i < size; i++)
+		if (flags1[i] & flags2[i]) return true;
+
+	return false;
+}
+
+/**
+ * Test if one bitfield is a subset of another.
+ *
+ * true is returned when every set flag in `flags2` is also set in `flags1`,
+ * and false otherwise. The size of the bitfields is supplied in `size`.
+ */
+static inline bool flag_is_subset(const bitflag *flags1, const bitflag *flags2,
+								  const size_t size)
+{
+	size_t i = 0;
+
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (~flag_word_get(flags1 + i) & flag_word_get(flags2 + i))
+			return false;
+	for (; i < size; i++)
+		if (~flags1[i] & flags2[i]) return false;
+
+	return true;
+}
+
+/**
+ * Tests two bitfields for equality.
+ *
+ * true is returned when the flags set in `flags1` and `flags2` are identical,
+ * and false otherwise. the size of the bitfields is supplied in `size`.
+ */
+static inline bool flag_is_equal(const bitflag *flags1, const bitflag *flags2,
+								 const size_t size)
+{
+	return (!memcmp(flags1, flags2, size * sizeof(bitflag)));
+}
+
+/**
+ * Sets one bitflag in a bitfield.
+ *
+ * The bitflag identified by `flag` is set in `flags`. The bitfield size is
+ * supplied in `size`.  true is returned when changes were made, false
+ * otherwise.
+ */
+static inline bool flag_on(bitflag *flags, const size_t size, const int flag)
+{
+	const size_t flag_offset = FLAG_OFFSET(flag);
+	const int flag_binary = FLAG_BINARY(flag);
+
+	assert(flag_offset < size);
+
+	if (flags[flag_offset] & flag_binary) return false;
+
+	flags[flag_offset] |= flag_binary;
+
+	return true;
+}
+
+/**
+ * Clears one flag in a bitfield.
+ *
+ * The bitflag identified by `flag` is cleared in `flags`. The bitfield size
+ * is supplied in `size`.  true is returned when changes were made, false
+ * otherwise.
+ */
+static inline bool flag_off(bitflag *flags, const size_t size, const int flag)
+{
+	const size_t flag_offset = FLAG_OFFSET(flag);
+	const int flag_binary = FLAG_BINARY(flag);
+
+	assert(flag_offset < size);
+
+	if (!(flags[flag_offset] & flag_binary)) return false;
+
+	flags[flag_offset] &= ~flag_binary;
+
+	return true;
+}
+
+/**
+ * Clears all flags in a bitfield.
+ *
+ * All flags in `flags` are cleared. The bitfield size is supplied in `size`.
+ */
+static inline void flag_wipe(bitflag *flags, const size_t size)
+{
+	memset(flags, 0, size * sizeof(bitflag));
+}
+
+/**
+ * Sets all flags in a bitfield.
+ *
+ * All flags in `flags` are set. The bitfield size is supplied in `size`.
+ */
+static inline void flag_setall(bitflag *flags, const size_t size)
+{
+	memset(flags, 255, size * sizeof(bitflag));
+}
+
+/**
+ * Negates all flags in a bitfield.
+ *
+ * All flags in `flags` are toggled. The bitfield size is supplied in `size`.
+ */
+static inline void flag_negate(bitflag *flags, const size_t size)
+{
+	size_t i = 0;
+
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		flag_word_put(flags + i, ~flag_word_get(flags + i));
+	for (; i < size; i++)
+		flags[i] = ~flags[i];
+}
+
+/**
+ * Copies one bitfield into another.
+ *
+ * All flags in `flags2` are copied into `flags1`. The size of the bitfields is
+ * supplied in `size`.
+ */
+static inline void flag_copy(bitflag *flags1, const bitflag *flags2,
+							 const size_t size)
+{
+	memcpy(flags1, flags2, size * sizeof(bitflag));
+}
+
+/**
+ * Computes the union of two bitfields.
+ *
+ * For every set flag in `flags2`, the corresponding flag is set in `flags1`.
+ * The size of the bitfields is supplied in `size`. true is returned when
+ * changes were made, and false otherwise.
+ */
+static inline bool flag_union(bitflag *flags1, const bitflag *flags2,
+							  const size_t size)
+{
+	size_t i = 0;
+	flag_word delta = 0;
+
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE) {
+		flag_word w1 = flag_word_get(flags1 + i);
+		flag_word w2 = flag_word_get(flags2 + i);
+
+		/* !flag_is_subset() */
+		delta |= ~w1 & w2;
+		flag_word_put(flags1 + i, w1 | w2);
+	}
+	for (; i < size; i++) {
+		delta |= (bitflag) ~flags1[i] & flags2[i];
+		flags1[i] |= flags2[i];
+	}
+
+	return delta != 0;
+}
+
+/**
+ * Computes the intersection of two bitfields.
+ *
+ * For every unset flag in `flags2`, the corresponding flag is cleared in
+ * `flags1`. The size of the bitfields is supplied in `size`. true is returned
+ * when changes were made, and false otherwise.
+ */
+static inline bool flag_inter(bitflag *flags1, const bitflag *flags2,
+							  const size_t size)
+{
+	size_t i = 0;
+	flag_word delta = 0;
+
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE) {
+		flag_word w1 = flag_word_get(flags1 + i);
+		flag_word w2 = flag_word_get(flags2 + i);
+
+		/* !flag_is_equal() */
+		delta |= w1 ^ w2;
+		flag_word_put(flags1 + i, w1 & w2);
+	}
+	for (; i < size; i++) {
+		delta |= flags1[i] ^ flags2[i];
+		flags1[i] &= flags2[i];
+	}
+
+	return delta != 0;
+}
+
+/**
+ * Computes the difference of two bitfields.
+ *
+ * For every set flag in `flags2`, the corresponding flag is cleared in
+ * `flags1`. The size of the bitfields is supplied in `size`. true is returned
+ * when changes were made, and false otherwise.
+ */
+static inline bool flag_diff(bitflag *flags1, const bitflag *flags2,
+							 const size_t size)
+{
+	size_t i = 0;
+	flag_word delta = 0;
+
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE) {
+		flag_word w1 = flag_word_get(flags1 + i);
+		flag_word w2 = flag_word_get(flags2 + i);
+
+		/* flag_is_inter() */
+		delta |= w1 & w2;
+		flag_word_put(flags1 + i, w1 & ~w2);
+	}
+	for (; i < size; i++) {
+		delta |= flags1[i] & flags2[i];
+		flags1[i] &= ~flags2[i];
+	}
+
+	return delta != 0;
+}
 
 bool flags_test     (const bitflag *flags, const size_t size, ...);
 bool flags_test_all (const bitflag *flags, const size_t size, ...);
@@ -91,10 +453,30 @@ bool flags_mask     (bitflag *flags, const size_t size, ...);
 #define flag_has_dbg(flags, size, flag, fi, fl) flag_has(flags, size, flag)
 #define flag_on_dbg(flags, size, flag, fi, fl) flag_on(flags, size, flag)
 #else
-bool flag_has_dbg   (const bitflag *flags, const size_t size, const int flag,
-					 const char *fi, const char *fl);
-bool flag_on_dbg    (bitflag *flags, const size_t size, const int flag,
-					 const char *fi, const char *fl);
+static inline bool flag_has_dbg(const bitflag *flags, const size_t size,
+								const int flag, const char *fi,
+								const char *fl)
+{
+	if (flag == FLAG_END) return false;
+
+	if (FLAG_OFFSET(flag) >= size)
+		flag_bounds_error("flag_has", fi, fl, flag, size);
+
+	return (flags[FLAG_OFFSET(flag)] & FLAG_BINARY(flag)) != 0;
+}
+
+static inline bool flag_on_dbg(bitflag *flags, const size_t size,
+							   const int flag, const char *fi, const char *fl)
+{
+	if (FLAG_OFFSET(flag) >= size)
+		flag_bounds_error("flag_on", fi, fl, flag, size);
+
+	if (flags[FLAG_OFFSET(flag)] & FLAG_BINARY(flag)) return false;
+
+	flags[FLAG_OFFSET(flag)] |= FLAG_BINARY(flag);
+
+	return true;
+}
 #endif
 
 #endif
@@ -0,0 +1,233 @@
+/**
+ * \file z-index.c
+ * \brief Tables for finding records by name or by a pair of small numbers
+ *
+ * The game data is looked up by name (or by tval and sval) all through
+ * parsing and play, and most of those lookups used to be a walk along the
+ * whole table.  These are the indexes the lookup functions build once the
+ * data is there:  a hash of names, which can ignore case, and a direct
+ * table for pairs of small non-negative numbers.  Both map to a non-negative
+ * integer, usually an index into the data table, and both keep the first
+ * value given for a key, so they find what a walk from the start of the
+ * table would have found.
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "z-index.h"
+#include "z-util.h"
+#include "z-virt.h"
+
+/**
+ * ------------------------------------------------------------------------
+ * Names
+ * ------------------------------------------------------------------------ */
+struct name_entry {
+	char *name;			/* Owned copy of the name, or NULL if unused */
+	uint32_t hash;
+	int group;
+	int value;
+};
+
+struct name_index {
+	bool fold;			/* Whether case is ignored */
+	size_t num, max;	/* Entries used, and the size of the table */
+	struct name_entry *entries;
+};
+
+static uint32_t name_hash(const struct name_index *ix, int group,
+		const char *name)
+{
+	uint32_t hash = 5381;
+
+	for (; *name; name++) {
+		unsigned char c = (unsigned char) *name;
+
+		if (ix->fold) c = (unsigned char) toupper(c);
+		hash = ((hash << 5) + hash) + c;
+	}
+	return hash ^ ((uint32_t) group * 0x9E3779B1u);
+}
+
+static bool name_matches(const struct name_index *ix,
+		const struct name_entry *entry, uint32_t hash, int group,
+		const char *name)
+{
+	if (entry->hash != hash || entry->group != group) return false;
+	return ix->fold ? !my_stricmp(entry->name, name)
+		: streq(entry->name, name);
+}
+
+/**
+ * Find the entry for a name, or the empty slot where it would go
+ */
+static struct name_entry *name_slot(const struct name_index *ix,
+		uint32_t hash, int group, const char *name)
+{
+	size_t i = hash & (ix->max - 1);
+
+	while (ix->entries[i].name
+			&& !name_matches(ix, &ix->entries[i], hash, group, name)) {
+		i = (i + 1) & (ix->max - 1);
+	}
+	return &ix->entries[i];
+}
+
+static void name_index_grow(struct name_index *ix)
+{
+	struct name_entry *old = ix->entries;
+	size_t old_max = ix->max, i;
+
+	ix->max = old_max ? old_max * 2 : 64;
+	ix->entries = mem_zalloc(ix->max * sizeof(*ix->entries));
+	for (i = 0; i < old_max; i++) {
+		struct name_entry *slot;
+
+		if (!old[i].name) continue;
+		slot = name_slot(ix, old[i].hash, old[i].group, old[i].name);
+		*slot = old[i];
+	}
+	mem_free(old);
+}
+
+/**
+ * Make an empty name index.
+ *
+ * \param fold is whether names which differ only in case are the same name
+ */
+struct name_index *name_index_new(bool fold)
+{
+	struct name_index *ix = mem_zalloc(sizeof(*ix));
+
+	ix->fold = fold;
+	name_index_grow(ix);
+	return ix;
+}
+
+/**
+ * Add a name to an index, unless the same name is already there.
+ *
+ * \param group keeps names apart which are only looked up together with
+ * something else, such as the tval of an object kind; use 0 if there is
+ * nothing else
+ */
+void name_index_add(struct name_index *ix, int group, const char *name,
+		int value)
+{
+	uint32_t hash = name_hash(ix, group, name);
+	struct name_entry *slot;
+
+	/* Keep the table no more than half full */
+	if (2 * (ix->num + 1) > ix->max) name_index_grow(ix);
+	slot = name_slot(ix, hash, group, name);
+	if (slot->name) return;
+	slot->name = string_make(name);
+	slot->hash = hash;
+	slot->group = group;
+	slot->value = value;
+	ix->num++;
+}
+
+/**
+ * Get the value given for a name in a group, or -1 if there is none
+ */
+int name_index_find(const struct name_index *ix, int group, const char *name)
+{
+	const struct name_entry *slot;
+
+	if (!ix || !name) return -1;
+	slot = name_slot(ix, name_hash(ix, group, name), group, name);
+	return slot->name ? slot->value : -1;
+}
+
+void name_index_free(struct name_index *ix)
+{
+	size_t i;
+
+	if (!ix) return;
+	for (i = 0; i < ix->max; i++) {
+		string_free(ix->entries[i].name);
+	}
+	mem_free(ix->entries);
+	mem_free(ix);
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * Pairs
+ * ------------------------------------------------------------------------ */
+struct pair_row {
+	int num;			/* Size of the row */
+	int *values;		/* The value for each second number, or -1 */
+};
+
+struct pair_index {
+	int num;			/* Number of rows */
+	struct pair_row *rows;
+};
+
+struct pair_index *pair_index_new(void)
+{
+	return mem_zalloc(sizeof(struct pair_index));
+}
+
+/**
+ * Add a pair to an index, unless it is already there; the pair must not be
+ * negative, and the table grows to the largest numbers given
+ */
+void pair_index_add(struct pair_index *ix, int a, int b, int value)
+{
+	struct pair_row *row;
+
+	assert(a >= 0 && b >= 0);
+	if (a >= ix->num) {
+		ix->rows = mem_realloc(ix->rows, (a + 1) * sizeof(*ix->rows));
+		memset(ix->rows + ix->num, 0, (a + 1 - ix->num) * sizeof(*ix->rows));
+		ix->num = a + 1;
+	}
+	row = &ix->rows[a];
+	if (b >= row->num) {
+		int i, num = MAX(b + 1, 2 * row->num);
+
+		row->values = mem_realloc(row->values, num * sizeof(int));
+		for (i = row->num; i < num; i++) {
+			row->values[i] = -1;
+		}
+		row->num = num;
+	}
+	if (row->values[b] < 0) row->values[b] = value;
+}
+
+/**
+ * Get the value given for a pair, or -1 if there is none
+ */
+int pair_index_find(const struct pair_index *ix, int a, int b)
+{
+	if (!ix || a < 0 || b < 0 || a >= ix->num || b >= ix->rows[a].num) {
+		return -1;
+	}
+	return ix->rows[a].values[b];
+}
+
+void pair_index_free(struct pair_index *ix)
+{
+	int a;
+
+	if (!ix) return;
+	for (a = 0; a < ix->num; a++) {
+		mem_free(ix->rows[a].values);
+	}
+	mem_free(ix->rows);
+	mem_free(ix);
+}
@@ -0,0 +1,38 @@
+/**
+ * \file z-index.h
+ * \brief Tables for finding records by name or by a pair of small numbers
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_Z_INDEX_H
+#define INCLUDED_Z_INDEX_H
+
+#include "h-basic.h"
+
+struct name_index;
+struct pair_index;
+
+struct name_index *name_index_new(bool fold);
+void name_index_add(struct name_index *ix, int group, const char *name,
+	int value);
+int name_index_find(const struct name_index *ix, int group, const char *name);
+void name_index_free(struct name_index *ix);
+
+struct pair_index *pair_index_new(void);
+void pair_index_add(struct pair_index *ix, int a, int b, int value);
+int pair_index_find(const struct pair_index *ix, int a, int b);
+void pair_index_free(struct pair_index *ix);
+
+#endif /* INCLUDED_Z_INDEX_H */
@@ -0,0 +1,163 @@
+/**
+ * \file z-profile.c
+ * \brief Counting and timing calls to the busiest functions
+ *
+ * Each counter notes how often its function is called, how long the calls
+ * take in all and at most, and how much work (grids, monsters, rows of the
+ * screen) they get through.  Apart from the running totals, the counters
+ * keep the game turn in progress, the one before it, and the turn with the
+ * most time counted, so a slow turn can be picked apart afterwards.
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "z-profile.h"
+#include <time.h>
+
+/**
+ * The counters used so far, in the order they were first used
+ */
+static struct profile_counter *counters;
+static struct profile_counter **counters_end = &counters;
+
+/**
+ * The time counted in the worst turn so far
+ */
+static uint64_t worst_ns;
+
+/**
+ * Get a time in nanoseconds, from an arbitrary start
+ */
+uint64_t profile_now(void)
+{
+#ifdef CLOCK_MONOTONIC
+	struct timespec now;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &now) == 0) {
+		return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+	}
+#endif
+	return (uint64_t) clock() * (1000000000 / CLOCKS_PER_SEC);
+}
+
+static void stats_add(struct profile_stats *s, uint64_t ns, uint64_t work)
+{
+	s->calls++;
+	s->ns += ns;
+	s->max_ns = MAX(s->max_ns, ns);
+	s->work += work;
+}
+
+/**
+ * Count a call
+ *
+ * \param pc is the counter for the function called
+ * \param start is when the call began, from profile_now()
+ * \param work is the number of grids, monsters or rows looked at
+ */
+void profile_count(struct profile_counter *pc, uint64_t start, uint64_t work)
+{
+	uint64_t ns = profile_now() - start;
+
+	if (!pc->listed) {
+		pc->listed = true;
+		*counters_end = pc;
+		counters_end = &pc->next;
+	}
+	stats_add(&pc->total, ns, work);
+	stats_add(&pc->turn, ns, work);
+}
+
+/**
+ * Finish counting for a game turn, keeping it if it is the worst so far
+ */
+void profile_new_turn(void)
+{
+	struct profile_counter *pc;
+	uint64_t ns = 0;
+
+	for (pc = counters; pc; pc = pc->next) {
+		ns += pc->turn.ns;
+	}
+	for (pc = counters; pc; pc = pc->next) {
+		if (ns > worst_ns) pc->worst = pc->turn;
+		pc->last = pc->turn;
+		memset(&pc->turn, 0, sizeof(pc->turn));
+	}
+	worst_ns = MAX(worst_ns, ns);
+}
+
+/**
+ * Get the first counter used; the rest follow on through next
+ */
+struct profile_counter *profile_counters(void)
+{
+	return counters;
+}
+
+/**
+ * Start all the counters again from nothing
+ */
+void profile_reset(void)
+{
+	struct profile_counter *pc;
+
+	for (pc = counters; pc; pc = pc->next) {
+		memset(&pc->total, 0, sizeof(pc->total));
+		memset(&pc->turn, 0, sizeof(pc->turn));
+		memset(&pc->last, 0, sizeof(pc->last));
+		memset(&pc->worst, 0, sizeof(pc->worst));
+	}
+	worst_ns = 0;
+}
+
+static void describe_turn(textblock *tb, const char *title, bool worst)
+{
+	struct profile_counter *pc;
+
+	textblock_append(tb, "\n%s\n%-16s %10s %10s %10s %12s\n", title,
+		"function", "calls", "ms", "max us", "work");
+	for (pc = counters; pc; pc = pc->next) {
+		const struct profile_stats *s = worst ? &pc->worst : &pc->last;
+
+		textblock_append(tb, "%-16s %10lu %10.3f %10.1f %12lu %s\n",
+			pc->name, (unsigned long) s->calls, s->ns / 1000000.0,
+			s->max_ns / 1000.0, (unsigned long) s->work, pc->unit);
+	}
+}
+
+/**
+ * Describe what has been counted
+ */
+void profile_describe(textblock *tb)
+{
+	struct profile_counter *pc;
+
+	if (!counters) {
+		textblock_append(tb, "Nothing has been counted.\n");
+		return;
+	}
+	textblock_append(tb, "%-16s %10s %10s %10s %12s\n", "function",
+		"calls", "ms", "max us", "work per call");
+	for (pc = counters; pc; pc = pc->next) {
+		const struct profile_stats *s = &pc->total;
+
+		textblock_append(tb, "%-16s %10lu %10.1f %10.1f %12.1f %s\n",
+			pc->name, (unsigned long) s->calls, s->ns / 1000000.0,
+			s->max_ns / 1000.0,
+			s->calls ? (double) s->work / s->calls : 0.0, pc->unit);
+	}
+	describe_turn(tb, "Last game turn:", false);
+	describe_turn(tb, "Game turn with the most time counted:", true);
+}
@@ -0,0 +1,75 @@
+/**
+ * \file z-profile.h
+ * \brief Counting and timing calls to the busiest functions
+ *
+ * Copyright (c) 2026 Nick McConnell
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_Z_PROFILE_H
+#define INCLUDED_Z_PROFILE_H
+
+#include "h-basic.h"
+#include "z-textblock.h"
+
+/**
+ * What was counted for some calls of a function
+ */
+struct profile_stats {
+	uint32_t calls;		/* Number of calls */
+	uint64_t ns;		/* Nanoseconds taken by all of them */
+	uint64_t max_ns;	/* Nanoseconds taken by the slowest */
+	uint64_t work;		/* Grids, monsters or rows they looked at */
+};
+
+/**
+ * A counter for one function; counters join the list when first used
+ */
+struct profile_counter {
+	const char *name;
+	const char *unit;	/* What the work is counted in */
+	struct profile_stats total;	/* Since the counters were last reset */
+	struct profile_stats turn;	/* This game turn */
+	struct profile_stats last;	/* The last game turn */
+	struct profile_stats worst;	/* The turn with the most time counted */
+	bool listed;
+	struct profile_counter *next;
+};
+
+/**
+ * PROFILE_COUNTER(name, unit) defines a counter at file scope;
+ * PROFILE_START(name) starts timing a call and PROFILE_STOP(name, work)
+ * counts it, with the work done.  Building with NO_PROFILING defined takes
+ * them all out.
+ */
+#ifdef NO_PROFILING
+#define PROFILE_COUNTER(name, unit) struct profile_counter
+#define PROFILE_START(name)
+#define PROFILE_STOP(name, work) ((void) (work))
+#else
+#define PROFILE_COUNTER(fn, what) \
+	static struct profile_counter profile_##fn = \
+		{ .name = #fn, .unit = what }
+#define PROFILE_START(name) uint64_t profile_start_##name = profile_now()
+#define PROFILE_STOP(name, work) \
+	profile_count(&profile_##name, profile_start_##name, (work))
+#endif
+
+uint64_t profile_now(void);
+void profile_count(struct profile_counter *pc, uint64_t start, uint64_t work);
+void profile_new_turn(void);
+struct profile_counter *profile_counters(void);
+void profile_reset(void);
+void profile_describe(textblock *tb);
+
+#endif /* INCLUDED_Z_PROFILE_H */
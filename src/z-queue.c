@@ -43,39 +43,36 @@ struct queue *q_new(size_t size) {
 	return q;
 }
 
+/**
+ * Resize a queue to hold up to size elements.  The elements are kept in
+ * order, though if there are more than size of them the ones at the back
+ * are discarded.  Returns false if the operation was successful; otherwise
+ * returns true and leaves the queue unchanged.
+ */
 bool q_resize(struct queue *q, size_t size) {
+	uintptr_t *new_data;
+	size_t len, i;
+
 	if (size > SIZE_MAX / sizeof(uintptr_t) - 1) {
 		return true;
 	}
 	assert(q->size > 0);
-	if (size < q->size - 1 && q->head != q->tail
-			&& (q->head > size || q->tail > size)) {
-		uintptr_t *new_data = mem_alloc(sizeof(uintptr_t) * (size + 1));
-
-		if (q->tail > q->head) {
-			memcpy(new_data, q->data + q->head,
-				MIN(q->tail - q->head, size + 1)
-				* sizeof(uintptr_t));
-			q->tail -= q->head;
-		} else {
-			size_t head_sz = MIN(q->size - q->head, size + 1);
-
-			memcpy(new_data, q->data + q->head, head_sz
-				* sizeof(uintptr_t));
-			if (head_sz < size + 1) {
-				memcpy(new_data + head_sz, q->data,
-					(size + 1 - head_sz)
-					* sizeof(uintptr_t));
-			}
-			q->tail = size;
-		}
-		q->head = 0;
-		mem_free(q->data);
-		q->data = new_data;
-	} else {
-		q->data = mem_realloc(q->data, sizeof(uintptr_t) * (size + 1));
+
+	/*
+	 * Copy the elements to the start of the new storage, so that ones
+	 * which had wrapped around the end of the old storage are not left
+	 * out of order or past the end of the new storage.
+	 */
+	len = MIN(q_len(q), size);
+	new_data = mem_alloc(sizeof(uintptr_t) * (size + 1));
+	for (i = 0; i < len; ++i) {
+		new_data[i] = q->data[(q->head + i) % q->size];
 	}
+	mem_free(q->data);
+	q->data = new_data;
 	q->size = size + 1;
+	q->head = 0;
+	q->tail = len;
 	return false;
 }
 
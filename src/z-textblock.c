@@ -39,7 +39,17 @@
 #include "z-file.h"
 
 #define TEXTBLOCK_LEN_INITIAL		128
-#define TEXTBLOCK_LEN_INCR(x)		((x) + 128)
+#define TEXTBLOCK_LEN_INCR(x)		((x) * 2)
+
+/**
+ * Textblocks are made and thrown away in bursts (a monster recall or an
+ * object description may take dozens of appends, the knowledge menus make
+ * one per entry), so freed ones are kept, with their buffers, for the next
+ * to be made.  Only this many are kept, and none that grew larger than
+ * TEXTBLOCK_KEEP_LEN characters.
+ */
+#define TEXTBLOCK_KEEP			8
+#define TEXTBLOCK_KEEP_LEN		16384
 
 struct textblock {
 	wchar_t *text;
@@ -47,8 +57,19 @@ struct textblock {
 
 	size_t strlen;
 	size_t size;
+
+	struct textblock *next;
 };
 
+static struct textblock *spare_blocks;
+static int spare_num;
+
+/**
+ * Space to format appended text in before it is converted, kept between
+ * appends
+ */
+static char *format_space;
+static size_t format_len;
 
 
 /**
@@ -56,8 +77,18 @@ struct textblock {
  */
 textblock *textblock_new(void)
 {
-	textblock *tb = mem_zalloc(sizeof *tb);
+	textblock *tb = spare_blocks;
+
+	if (tb) {
+		spare_blocks = tb->next;
+		spare_num--;
+		tb->next = NULL;
+		tb->strlen = 0;
+		tb->text[0] = 0;
+		return tb;
+	}
 
+	tb = mem_zalloc(sizeof *tb);
 	tb->size = TEXTBLOCK_LEN_INITIAL;
 	tb->text = mem_zalloc(tb->size * sizeof *tb->text);
 	tb->attrs = mem_zalloc(tb->size);
@@ -70,11 +101,37 @@ textblock *textblock_new(void)
  */
 void textblock_free(textblock *tb)
 {
+	if (spare_num < TEXTBLOCK_KEEP && tb->size <= TEXTBLOCK_KEEP_LEN) {
+		tb->next = spare_blocks;
+		spare_blocks = tb;
+		spare_num++;
+		return;
+	}
+
 	mem_free(tb->text);
 	mem_free(tb->attrs);
 	mem_free(tb);
 }
 
+/**
+ * Free the kept textblocks and formatting space.
+ */
+void textblock_cleanup(void)
+{
+	while (spare_blocks) {
+		textblock *tb = spare_blocks;
+
+		spare_blocks = tb->next;
+		mem_free(tb->text);
+		mem_free(tb->attrs);
+		mem_free(tb);
+	}
+	spare_num = 0;
+	mem_free(format_space);
+	format_space = NULL;
+	format_len = 0;
+}
+
 /**
  * Resize the internal textblock storage (if needed) to hold additional
  * characters.
@@ -97,9 +154,12 @@ static void textblock_resize_if_needed(textblock *tb, size_t additional_size)
 static void textblock_vappend_c(textblock *tb, uint8_t attr, const char *fmt,
 		va_list vp)
 {
-	size_t temp_len = TEXTBLOCK_LEN_INITIAL;
-	char *temp_space = mem_zalloc(temp_len);
-	int new_length;
+	size_t len, new_length;
+
+	if (!format_space) {
+		format_len = TEXTBLOCK_LEN_INITIAL;
+		format_space = mem_alloc(format_len);
+	}
 
 	/* We have to format the incoming string in native (external) format
 	 * re-allocating the temporary space as necessary. Once it's been
@@ -107,30 +167,27 @@ static void textblock_vappend_c(textblock *tb, uint8_t attr, const char *fmt,
 	 */
 	while (1) {
 		va_list args;
-		size_t len;
 
 		va_copy(args, vp);
-		len = vstrnfmt(temp_space, temp_len, fmt, args);
+		len = vstrnfmt(format_space, format_len, fmt, args);
 		va_end(args);
-		if (len < temp_len - 1) {
+		if (len < format_len - 1) {
 			/* Not using all space, therefore it completed */
 			break;
 		}
 
-		temp_len = TEXTBLOCK_LEN_INCR(temp_len);
-		temp_space = mem_realloc(temp_space, temp_len * sizeof *temp_space);
+		format_len = TEXTBLOCK_LEN_INCR(format_len);
+		format_space = mem_realloc(format_space, format_len);
 	}
 
-	/* Get extent of addition in wide chars */
-	new_length = text_mbstowcs(NULL, temp_space, 0);
-	assert(new_length >= 0); /* If this fails, the string was badly formed */
-	textblock_resize_if_needed(tb, new_length + 1);
-
-	/* Convert to wide chars, into the text block buffer */
-	text_mbstowcs(tb->text + tb->strlen, temp_space, tb->size - tb->strlen);
+	/* There are never more wide chars than bytes, so convert straight
+	 * into the text block buffer */
+	textblock_resize_if_needed(tb, len + 1);
+	new_length = text_mbstowcs(tb->text + tb->strlen, format_space,
+		tb->size - tb->strlen);
+	assert(new_length != (size_t) -1); /* The string was badly formed */
 	memset(tb->attrs + tb->strlen, attr, new_length);
 	tb->strlen += new_length;
-	mem_free(temp_space);
 }
 
 /**
@@ -138,10 +195,11 @@ static void textblock_vappend_c(textblock *tb, uint8_t attr, const char *fmt,
  */
 void textblock_append_pict(textblock *tb, uint8_t attr, int c)
 {
-	textblock_resize_if_needed(tb, 1);
+	textblock_resize_if_needed(tb, 2);
 	tb->text[tb->strlen] = (wchar_t)c;
 	tb->attrs[tb->strlen] = attr;
 	tb->strlen += 1;
+	tb->text[tb->strlen] = 0;
 }
 
 /**
@@ -152,11 +210,12 @@ void textblock_append_pict(textblock *tb, uint8_t attr, int c)
  */
 void textblock_append_textblock(textblock *tb, const textblock *tba)
 {
-	textblock_resize_if_needed(tb, tba->strlen);
+	textblock_resize_if_needed(tb, tba->strlen + 1);
 	(void) memcpy(tb->text + tb->strlen, tba->text,
 		tba->strlen * sizeof(*tb->text));
 	(void) memcpy(tb->attrs + tb->strlen, tba->attrs, tba->strlen);
 	tb->strlen += tba->strlen;
+	tb->text[tb->strlen] = 0;
 }
 
 
@@ -209,7 +268,7 @@ static void new_line(size_t **line_starts, size_t **line_lengths,
 {
 	if (*cur_line == *n_lines) {
 		/* this number is not arbitrary: it's the height of a "standard" term */
-		(*n_lines) += 24;
+		(*n_lines) = (*n_lines) ? (*n_lines) * 2 : 24;
 
 		*line_starts = mem_realloc(*line_starts,
 				*n_lines * sizeof **line_starts);
@@ -37,6 +37,7 @@ typedef struct textblock textblock;
 
 textblock *textblock_new(void);
 void textblock_free(textblock *tb);
+void textblock_cleanup(void);
 
 
 void textblock_append(textblock *tb, const char *fmt, ...)